@@ -1,45 +1,55 @@
 #version 450
 
+// engine::SkinnedVertex, static meshes use model_static.vert
 layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 normal;
+layout(location = 1) in vec2 normal; // Octahedral encoded
 layout(location = 2) in vec2 texCoord0;
 layout(location = 3) in vec2 texCoord1;
-layout(location = 4) in vec4 jointIndices;
+layout(location = 4) in uvec4 jointIndices;
 layout(location = 5) in vec4 jointWeights;
 
 layout(location = 0) out vec2 fragTexCoord0;
 layout(location = 1) out vec2 fragTexCoord1;
+layout(location = 2) flat out uint fragTextureIndex;
 
 layout(push_constant) uniform MVP {
     mat4 proj;
     mat4 view;
-    mat4 model;
+    uint paletteOffset;
+    uint jointCount;
+    uint textureIndex;
 } mvp;
 
-#define MAX_NUM_JOINTS 128
+// Set by GraphicsPipeline::VARIANT_SKINNED, meshes with the skinned layout but no skin only read their node matrix
+layout(constant_id = 0) const bool SKINNED = false;
 
-layout (set = 2, binding = 0) uniform UBONode {
-    mat4 matrix;
-    mat4 jointMatrix[MAX_NUM_JOINTS];
-    float jointCount;
-} node;
+// Model, node and joint matrices of every instance drawn this frame. The blocks of the instances of a draw follow each
+// other from paletteOffset
+layout (std430, set = 2, binding = 0) readonly buffer Palettes {
+    mat4 matrices[];
+} palettes;
 
 void main() {
     vec4 locPos;
-
-    if (node.jointCount > 0.0) {
-        // Mesh is skinned
-        mat4 skinMat =  jointWeights.x * node.jointMatrix[int(jointIndices.x)] +
-                        jointWeights.y * node.jointMatrix[int(jointIndices.y)] +
-                        jointWeights.z * node.jointMatrix[int(jointIndices.z)] +
-                        jointWeights.w * node.jointMatrix[int(jointIndices.w)];
-
-        locPos = mvp.model * node.matrix * skinMat * vec4(position, 1.0);
+    uint block = mvp.paletteOffset + uint(gl_InstanceIndex) * (2u + mvp.jointCount);
+    mat4 model = palettes.matrices[block];
+    mat4 nodeMatrix = palettes.matrices[block + 1u];
+
+    if (SKINNED) {
+        // Mesh is skinned, joints follow the node matrix
+        uint joints = block + 2u;
+        mat4 skinMat =  jointWeights.x * palettes.matrices[joints + jointIndices.x] +
+                        jointWeights.y * palettes.matrices[joints + jointIndices.y] +
+                        jointWeights.z * palettes.matrices[joints + jointIndices.z] +
+                        jointWeights.w * palettes.matrices[joints + jointIndices.w];
+
+        locPos = model * nodeMatrix * skinMat * vec4(position, 1.0);
     } else {
-        locPos = mvp.model * node.matrix * vec4(position, 1.0);
+        locPos = model * nodeMatrix * vec4(position, 1.0);
     }
 
     gl_Position = mvp.proj * mvp.view * locPos;
     fragTexCoord0 = texCoord0;
     fragTexCoord1 = texCoord1;
+    fragTextureIndex = mvp.textureIndex;
 }
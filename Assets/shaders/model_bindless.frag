@@ -0,0 +1,17 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : require
+
+// model.frag with the textures of every draw in one array, used when the device supports descriptor indexing
+layout(location = 0) in vec2 inTexCoord0;
+layout(location = 1) in vec2 inTexCoord1;
+layout(location = 2) flat in uint inTextureIndex;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+void main() {
+    // The index comes from a push constant, it is the same for the whole draw
+    outColor = texture(textures[inTextureIndex], inTexCoord0);
+}
@@ -0,0 +1,34 @@
+#version 450
+
+// engine::StaticVertex
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 normal; // Octahedral encoded
+layout(location = 2) in vec2 texCoord0;
+layout(location = 3) in vec2 texCoord1;
+
+layout(location = 0) out vec2 fragTexCoord0;
+layout(location = 1) out vec2 fragTexCoord1;
+layout(location = 2) flat out uint fragTextureIndex;
+
+layout(push_constant) uniform MVP {
+    mat4 proj;
+    mat4 view;
+    uint paletteOffset;
+    uint jointCount;
+    uint textureIndex;
+} mvp;
+
+// Same palette layout than model.vert, static meshes only read their model and node matrices
+layout (std430, set = 2, binding = 0) readonly buffer Palettes {
+    mat4 matrices[];
+} palettes;
+
+void main() {
+    uint block = mvp.paletteOffset + uint(gl_InstanceIndex) * (2u + mvp.jointCount);
+    vec4 locPos = palettes.matrices[block] * palettes.matrices[block + 1u] * vec4(position, 1.0);
+
+    gl_Position = mvp.proj * mvp.view * locPos;
+    fragTexCoord0 = texCoord0;
+    fragTexCoord1 = texCoord1;
+    fragTextureIndex = mvp.textureIndex;
+}
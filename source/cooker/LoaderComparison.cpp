@@ -0,0 +1,119 @@
+#include "tiny_gltf.h"
+
+#include "LoaderComparison.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "spdlog/spdlog.h"
+
+#include "resources/GltfFile.hpp"
+
+
+inline bool skipImage(tinygltf::Image*, const int, std::string*, std::string*, int, int, const unsigned char*, int, void*) {
+    return true;
+}
+
+// Reads one byte per page so every page of the view is resident, the sum keeps the reads from being optimized out
+inline uint64_t touch(const uint8_t* data, size_t size) {
+    uint64_t sum = 0;
+
+    for (size_t i = 0; i < size; i += 4096) sum += data[i];
+
+    return sum;
+}
+
+namespace cooker {
+
+    LoaderComparison::LoaderComparison() = default;
+
+    bool LoaderComparison::compare(const std::string& path) {
+        m_report = {};
+        m_report.fileBytes = std::filesystem::file_size(path);
+
+        // Both loaders find the file in the page cache, only the first read of a run would go to the disk
+        {
+            std::ifstream file(path, std::ios::binary);
+            std::vector<char> bytes(m_report.fileBytes);
+            file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+
+        uint64_t checksum = 0;
+
+        {
+            size_t resident = getResidentMemory();
+            auto start = std::chrono::high_resolution_clock::now();
+
+            tinygltf::TinyGLTF loader;
+            tinygltf::Model model;
+            std::string error, warning;
+            loader.SetImageLoader(skipImage, nullptr);
+
+            if (!loader.LoadBinaryFromFile(&model, &error, &warning, path)) {
+                spdlog::error("[Cooker] {} could not be loaded by tinygltf: {}", path, error);
+
+                return false;
+            }
+
+            for (auto& view : model.bufferViews) checksum += touch(model.buffers[view.buffer].data.data() + view.byteOffset, view.byteLength);
+
+            std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+            m_report.copied = {time.count(), static_cast<int64_t>(getResidentMemory()) - static_cast<int64_t>(resident)};
+        }
+
+        {
+            size_t resident = getResidentMemory();
+            auto start = std::chrono::high_resolution_clock::now();
+
+            engine::GltfFile file;
+            std::string error;
+
+            if (!file.load(path, &error)) {
+                spdlog::error("[Cooker] {} could not be loaded by GltfFile: {}", path, error);
+
+                return false;
+            }
+
+            const tinygltf::Model& model = file.getModel();
+            for (size_t i = 0; i < model.bufferViews.size(); ++i) checksum += touch(file.getBufferView(static_cast<int>(i)), model.bufferViews[i].byteLength);
+
+            std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+            m_report.mapped = {time.count(), static_cast<int64_t>(getResidentMemory()) - static_cast<int64_t>(resident)};
+        }
+
+        spdlog::debug("[Cooker] {} checksum {}", path, checksum);
+
+        return true;
+    }
+
+    const LoaderComparison::Report& LoaderComparison::getReport() const {
+        return m_report;
+    }
+
+    size_t LoaderComparison::getResidentMemory() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+
+        return counters.WorkingSetSize;
+#else
+        // Second field of statm, in pages. Missing outside Linux
+        std::ifstream statm("/proc/self/statm");
+        size_t size = 0, resident = 0;
+        statm >> size >> resident;
+
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+} // namespace cooker
@@ -0,0 +1,44 @@
+#ifndef PROTOTYPE_ACTION_RPG_LOADERCOMPARISON_HPP
+#define PROTOTYPE_ACTION_RPG_LOADERCOMPARISON_HPP
+
+
+#include <string>
+#include <cstdint>
+
+
+namespace cooker {
+
+    // Loads a binary glTF file with tinygltf, which copies every buffer, then with the mapped engine::GltfFile, and
+    // measures the time and the resident memory each one adds. Both touch every buffer view once, as building a model does
+    class LoaderComparison {
+    public:
+        struct Measure {
+            float milliseconds{};
+            // Resident memory added while the file is loaded, mapped pages only count once they are read
+            int64_t residentBytes{};
+        };
+
+        struct Report {
+            size_t fileBytes{};
+            Measure copied;
+            Measure mapped;
+        };
+
+    public:
+        LoaderComparison();
+
+        bool compare(const std::string& path);
+
+        [[nodiscard]] const Report& getReport() const;
+
+        // Resident set size of the process now, 0 where it is not available
+        static size_t getResidentMemory();
+
+    private:
+        Report m_report{};
+    };
+
+} // namespace cooker
+
+
+#endif //PROTOTYPE_ACTION_RPG_LOADERCOMPARISON_HPP
@@ -0,0 +1,329 @@
+#define TINYGLTF_IMPLEMENTATION
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#include "tiny_gltf.h"
+
+#include "ModelCooker.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+
+#include "spdlog/spdlog.h"
+#include "glm/gtc/type_ptr.hpp"
+
+#include "resources/GltfFile.hpp"
+#include "resources/GltfReader.hpp"
+#include "mesh/MeshOptimizer.hpp"
+
+
+// Images in a buffer view of the model are copied in the cooked file, images in a data uri are not supported
+inline bool isCookable(const tinygltf::Image& image) {
+    return image.bufferView > -1 || (!image.uri.empty() && image.uri.rfind("data:", 0) != 0);
+}
+
+inline uint64_t alignOffset(uint64_t offset) {
+    return (offset + engine::CookedModel::SECTION_ALIGNMENT - 1) & ~(engine::CookedModel::SECTION_ALIGNMENT - 1);
+}
+
+namespace cooker {
+
+    ModelCooker::ModelCooker() = default;
+
+    bool ModelCooker::cook(const std::string& input, const std::string& output) {
+        auto start = std::chrono::high_resolution_clock::now();
+        clear();
+
+        // Textures are never decoded here, external ones are referenced by their uri and embedded ones copied as they are
+        engine::GltfFile file;
+        std::string error;
+
+        if (!file.load(input, &error) || file.getModel().scenes.empty()) {
+            spdlog::error("[Cooker] {} could not be loaded: {}", input, error);
+
+            return false;
+        }
+
+        const tinygltf::Model& model = file.getModel();
+
+        // Images are added with the first mesh sampling them, the others would never be loaded
+        m_imageTextures.assign(model.images.size(), engine::CookedModel::NO_TEXTURE);
+
+        addNodes(file);
+        addSkins(file);
+
+        if (!write(output)) {
+            spdlog::error("[Cooker] {} could not be written", output);
+
+            return false;
+        }
+
+        // Read the result back with the same checks than the runtime loader
+        engine::CookedModel cooked;
+        if (!cooked.open(output, sizeof(engine::StaticVertex), sizeof(engine::SkinnedVertex))) {
+            spdlog::error("[Cooker] {} failed validation", output);
+
+            return false;
+        }
+
+        m_report.sourceBytes = std::filesystem::file_size(input);
+        for (auto& buffer : model.buffers) {
+            std::filesystem::path bufferPath = std::filesystem::path(input).parent_path() / buffer.uri;
+
+            if (!buffer.uri.empty() && std::filesystem::exists(bufferPath)) m_report.sourceBytes += std::filesystem::file_size(bufferPath);
+        }
+
+        m_report.cookedBytes = cooked.getFileSize();
+        m_report.meshes = static_cast<uint32_t>(m_meshes.size());
+        m_report.vertexBytes = m_vertices.size();
+        m_report.fullVertexBytes = m_report.vertices * sizeof(engine::Vertex);
+
+        std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+        m_report.milliseconds = time.count();
+
+        return true;
+    }
+
+    const ModelCooker::Report& ModelCooker::getReport() const {
+        return m_report;
+    }
+
+    void ModelCooker::clear() {
+        m_nodes.clear();
+        m_children.clear();
+        m_meshes.clear();
+        m_skins.clear();
+        m_joints.clear();
+        m_inverseBindMatrices.clear();
+        m_textures.clear();
+        m_imageTextures.clear();
+        m_strings.clear();
+        m_vertices.clear();
+        m_indices.clear();
+        m_images.clear();
+        m_rootNode = 0;
+        m_report = {};
+    }
+
+    engine::CookedModel::String ModelCooker::addString(const std::string& string) {
+        engine::CookedModel::String record{static_cast<uint32_t>(m_strings.size()), static_cast<uint32_t>(string.size())};
+        m_strings += string;
+
+        return record;
+    }
+
+    void ModelCooker::addNodes(const engine::GltfFile& file) {
+        const tinygltf::Model& model = file.getModel();
+        engine::CookedModel::NodeRecord empty{
+            .name = {},
+            .parent = -1,
+            .skin = -1,
+            .mesh = -1,
+            .depth = 0,
+            .firstChild = 0,
+            .childCount = 0,
+            .translation = {0.0f, 0.0f, 0.0f},
+            .rotation = {0.0f, 0.0f, 0.0f, 1.0f},
+            .scale = {1.0f, 1.0f, 1.0f},
+            .matrix = {}
+        };
+        std::copy_n(glm::value_ptr(glm::mat4(1.0f)), 16, empty.matrix);
+
+        m_nodes.assign(model.nodes.size(), empty);
+
+        // Same traversal than Model::loadNode: only the nodes of the first scene are loaded, a mesh used by several nodes is cooked once
+        std::vector<int32_t> cookedMeshes(model.meshes.size(), -1);
+        std::vector<std::pair<uint32_t, int32_t>> pending;
+
+        for (auto it = model.scenes[0].nodes.rbegin(); it != model.scenes[0].nodes.rend(); ++it) pending.emplace_back(*it, -1);
+
+        if (!model.scenes[0].nodes.empty()) m_rootNode = static_cast<uint32_t>(model.scenes[0].nodes.back());
+
+        while (!pending.empty()) {
+            auto [nodeID, parentID] = pending.back();
+            pending.pop_back();
+
+            const tinygltf::Node& inputNode = model.nodes[nodeID];
+            engine::CookedModel::NodeRecord& node = m_nodes[nodeID];
+
+            node.name = addString(inputNode.name);
+            node.parent = parentID;
+            node.depth = parentID > -1 ? m_nodes[parentID].depth + 1 : 0;
+            node.skin = inputNode.skin;
+
+            for (size_t i = 0; i < inputNode.translation.size() && i < 3; ++i) node.translation[i] = static_cast<float>(inputNode.translation[i]);
+            for (size_t i = 0; i < inputNode.rotation.size() && i < 4; ++i) node.rotation[i] = static_cast<float>(inputNode.rotation[i]);
+            for (size_t i = 0; i < inputNode.scale.size() && i < 3; ++i) node.scale[i] = static_cast<float>(inputNode.scale[i]);
+            if (inputNode.matrix.size() == 16) {
+                for (size_t i = 0; i < 16; ++i) node.matrix[i] = static_cast<float>(inputNode.matrix[i]);
+            }
+
+            if (inputNode.mesh > -1) {
+                if (cookedMeshes[inputNode.mesh] < 0) {
+                    std::vector<engine::Vertex> vertices;
+                    std::vector<uint32_t> indices;
+
+                    bool skinned = engine::gltf::readMesh(file, model.meshes[inputNode.mesh], vertices, indices);
+                    engine::VertexLayout layout = skinned ? engine::VertexLayout::SKINNED : engine::VertexLayout::STATIC;
+
+                    engine::MeshOptimizer::Stats stats = engine::MeshOptimizer::optimize(vertices, indices);
+                    uint32_t indexSize = engine::MeshOptimizer::getIndexSize(stats.verticesAfter);
+                    spdlog::info("[Cooker] {}: {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {} bits indices",
+                                 inputNode.name, stats.verticesBefore, stats.verticesAfter, stats.acmrBefore, stats.acmrAfter,
+                                 stats.atvrBefore, stats.atvrAfter, 8 * indexSize);
+
+                    std::vector<uint8_t> packed;
+                    if (!engine::packVertices(vertices.data(), vertices.size(), layout, packed)) {
+                        spdlog::error("[Cooker] {}: joint indices above 255 do not fit in the skinned vertex layout", inputNode.name);
+                    }
+
+                    int image = engine::gltf::getBaseColorImage(model, model.meshes[inputNode.mesh]);
+
+                    m_indices.resize((m_indices.size() + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1), 0);
+
+                    m_meshes.push_back({
+                        .name = addString(inputNode.name),
+                        .texture = image > -1 ? addTexture(file, image) : engine::CookedModel::NO_TEXTURE,
+                        .vertexCount = static_cast<uint32_t>(vertices.size()),
+                        .indexCount = static_cast<uint32_t>(indices.size()),
+                        .layout = static_cast<uint32_t>(layout),
+                        .indexSize = indexSize,
+                        .padding = 0,
+                        .vertexOffset = m_vertices.size(),
+                        .indexOffset = m_indices.size()
+                    });
+
+                    m_report.vertices += static_cast<uint32_t>(vertices.size());
+                    m_report.indices += static_cast<uint32_t>(indices.size());
+                    m_vertices.insert(m_vertices.end(), packed.begin(), packed.end());
+
+                    engine::MeshOptimizer::packIndices(indices, indexSize, packed);
+                    m_indices.insert(m_indices.end(), packed.begin(), packed.end());
+
+                    cookedMeshes[inputNode.mesh] = static_cast<int32_t>(m_meshes.size() - 1);
+                }
+
+                node.mesh = cookedMeshes[inputNode.mesh];
+            }
+
+            node.firstChild = static_cast<uint32_t>(m_children.size());
+            node.childCount = static_cast<uint32_t>(inputNode.children.size());
+            m_children.insert(m_children.end(), inputNode.children.begin(), inputNode.children.end());
+
+            for (auto it = inputNode.children.rbegin(); it != inputNode.children.rend(); ++it) pending.emplace_back(*it, nodeID);
+        }
+    }
+
+    uint32_t ModelCooker::addTexture(const engine::GltfFile& file, int imageID) {
+        const tinygltf::Model& model = file.getModel();
+        const tinygltf::Image& image = model.images[imageID];
+
+        if (m_imageTextures[imageID] != engine::CookedModel::NO_TEXTURE) return m_imageTextures[imageID];
+
+        if (!isCookable(image)) {
+            spdlog::warn("[Cooker] Image {} in a data uri is not supported, its meshes are cooked untextured", image.name);
+
+            return engine::CookedModel::NO_TEXTURE;
+        }
+
+        engine::CookedModel::TextureRecord texture{addString(image.name), addString(image.bufferView > -1 ? "" : image.uri), 0, 0};
+
+        if (image.bufferView > -1) {
+            const uint8_t* data = file.getBufferView(image.bufferView);
+            size_t size = model.bufferViews[image.bufferView].byteLength;
+
+            texture.imageOffset = m_images.size();
+            texture.imageSize = size;
+            m_images.insert(m_images.end(), data, data + size);
+        }
+
+        m_textures.push_back(texture);
+        m_imageTextures[imageID] = static_cast<uint32_t>(m_textures.size() - 1);
+
+        return m_imageTextures[imageID];
+    }
+
+    void ModelCooker::addSkins(const engine::GltfFile& file) {
+        for (auto& inputSkin : file.getModel().skins) {
+            std::vector<uint32_t> joints;
+            std::vector<glm::mat4> inverseBindMatrices;
+
+            engine::gltf::readSkin(file, inputSkin, joints, inverseBindMatrices);
+
+            m_skins.push_back({
+                .name = addString(inputSkin.name),
+                .rootNode = inputSkin.skeleton,
+                .firstJoint = static_cast<uint32_t>(m_joints.size()),
+                .jointCount = static_cast<uint32_t>(joints.size())
+            });
+
+            m_joints.insert(m_joints.end(), joints.begin(), joints.end());
+            m_inverseBindMatrices.insert(m_inverseBindMatrices.end(), inverseBindMatrices.begin(), inverseBindMatrices.end());
+        }
+    }
+
+    bool ModelCooker::write(const std::string& output) const {
+        engine::CookedModel::Header header{
+            .magic = engine::CookedModel::MAGIC,
+            .version = engine::CookedModel::VERSION,
+            .staticVertexSize = sizeof(engine::StaticVertex),
+            .skinnedVertexSize = sizeof(engine::SkinnedVertex),
+            .rootNode = m_rootNode,
+            .nodeCount = static_cast<uint32_t>(m_nodes.size()),
+            .childCount = static_cast<uint32_t>(m_children.size()),
+            .meshCount = static_cast<uint32_t>(m_meshes.size()),
+            .skinCount = static_cast<uint32_t>(m_skins.size()),
+            .jointCount = static_cast<uint32_t>(m_joints.size()),
+            .textureCount = static_cast<uint32_t>(m_textures.size()),
+            .padding = 0,
+            .vertexBytes = m_vertices.size(),
+            .indexBytes = m_indices.size(),
+            .stringsSize = m_strings.size(),
+            .imageBytes = m_images.size()
+        };
+
+        struct Section {
+            uint64_t* offset;
+            const void* data;
+            uint64_t size;
+        };
+
+        std::vector<Section> sections{
+            {&header.nodesOffset, m_nodes.data(), m_nodes.size() * sizeof(engine::CookedModel::NodeRecord)},
+            {&header.childrenOffset, m_children.data(), m_children.size() * sizeof(uint32_t)},
+            {&header.meshesOffset, m_meshes.data(), m_meshes.size() * sizeof(engine::CookedModel::MeshRecord)},
+            {&header.skinsOffset, m_skins.data(), m_skins.size() * sizeof(engine::CookedModel::SkinRecord)},
+            {&header.jointsOffset, m_joints.data(), m_joints.size() * sizeof(uint32_t)},
+            {&header.inverseBindOffset, m_inverseBindMatrices.data(), m_inverseBindMatrices.size() * sizeof(glm::mat4)},
+            {&header.texturesOffset, m_textures.data(), m_textures.size() * sizeof(engine::CookedModel::TextureRecord)},
+            {&header.stringsOffset, m_strings.data(), m_strings.size()},
+            {&header.verticesOffset, m_vertices.data(), m_vertices.size()},
+            {&header.indicesOffset, m_indices.data(), m_indices.size()},
+            {&header.imagesOffset, m_images.data(), m_images.size()}
+        };
+
+        uint64_t offset = sizeof(header);
+        for (auto& section : sections) {
+            *section.offset = alignOffset(offset);
+            offset = *section.offset + section.size;
+        }
+
+        std::ofstream file(output, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open()) return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        const char padding[engine::CookedModel::SECTION_ALIGNMENT]{};
+        offset = sizeof(header);
+
+        for (auto& section : sections) {
+            file.write(padding, static_cast<std::streamsize>(*section.offset - offset));
+            file.write(static_cast<const char*>(section.data), static_cast<std::streamsize>(section.size));
+            offset = *section.offset + section.size;
+        }
+
+        return file.good();
+    }
+
+} // namespace cooker
@@ -0,0 +1,80 @@
+#ifndef PROTOTYPE_ACTION_RPG_MODELCOOKER_HPP
+#define PROTOTYPE_ACTION_RPG_MODELCOOKER_HPP
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+#include "resources/CookedModel.hpp"
+#include "mesh/Vertex.hpp"
+
+
+namespace engine {
+    class GltfFile;
+}
+
+namespace cooker {
+
+    // Converts a glTF model in the engine cooked format, see engine::CookedModel
+    class ModelCooker {
+    public:
+        struct Report {
+            size_t sourceBytes{};
+            size_t cookedBytes{};
+            uint32_t meshes{};
+            uint32_t vertices{};
+            uint32_t indices{};
+            size_t vertexBytes{};
+            size_t fullVertexBytes{};
+            float milliseconds{};
+        };
+
+    public:
+        ModelCooker();
+
+        bool cook(const std::string& input, const std::string& output);
+
+        [[nodiscard]] const Report& getReport() const;
+
+    private:
+        void clear();
+
+        engine::CookedModel::String addString(const std::string& string);
+
+        void addNodes(const engine::GltfFile& file);
+
+        // Index of the texture record of the image, NO_TEXTURE when it cannot be cooked
+        uint32_t addTexture(const engine::GltfFile& file, int imageID);
+
+        void addSkins(const engine::GltfFile& file);
+
+        bool write(const std::string& output) const;
+
+    private:
+        std::vector<engine::CookedModel::NodeRecord> m_nodes;
+        std::vector<uint32_t> m_children;
+        std::vector<engine::CookedModel::MeshRecord> m_meshes;
+        std::vector<engine::CookedModel::SkinRecord> m_skins;
+        std::vector<uint32_t> m_joints;
+        std::vector<glm::mat4> m_inverseBindMatrices;
+        std::vector<engine::CookedModel::TextureRecord> m_textures;
+        // Texture record of each image of the source, NO_TEXTURE while no mesh samples it
+        std::vector<uint32_t> m_imageTextures;
+        std::string m_strings;
+        // Packed vertices of every mesh, each in the layout of its mesh
+        std::vector<uint8_t> m_vertices;
+        // Indices of every mesh in 16 or 32 bits, each range starts 4 bytes aligned
+        std::vector<uint8_t> m_indices;
+        // Encoded images embedded in the source model
+        std::vector<uint8_t> m_images;
+        uint32_t m_rootNode{};
+        Report m_report{};
+    };
+
+} // namespace cooker
+
+
+#endif //PROTOTYPE_ACTION_RPG_MODELCOOKER_HPP
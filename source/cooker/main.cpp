@@ -0,0 +1,91 @@
+#include <string>
+#include <filesystem>
+
+#include "spdlog/spdlog.h"
+
+#include "Constants.hpp"
+#include "ModelCooker.hpp"
+#include "LoaderComparison.hpp"
+#include "resources/CookedModel.hpp"
+
+
+// Copied and mapped loads of every binary model of the directory, nothing is cooked
+int compareLoaders(const std::filesystem::path& directory) {
+    cooker::LoaderComparison comparison;
+    int failed = 0;
+
+    for (auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() != ".glb") continue;
+
+        if (!comparison.compare(entry.path().string())) {
+            ++failed;
+            continue;
+        }
+
+        const cooker::LoaderComparison::Report& report = comparison.getReport();
+        spdlog::info("[Cooker] {} ({} KB): tinygltf {:.2f} ms, {:+} KB resident, mapped {:.2f} ms, {:+} KB resident",
+                     entry.path().filename().string(), report.fileBytes / 1024, report.copied.milliseconds, report.copied.residentBytes / 1024,
+                     report.mapped.milliseconds, report.mapped.residentBytes / 1024);
+    }
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Usage: AssetCooker [models directory] [--force] [--compare-loaders]
+// Every glTF model of the directory is cooked next to its source, up to date models are skipped unless --force is given.
+// --compare-loaders only measures the load of the binary models with tinygltf and with the mapped loader
+int main(int argc, char** argv) {
+    std::filesystem::path directory = MODELS_DIR;
+    bool force = false;
+    bool compare = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (argument == "--force") {
+            force = true;
+        } else if (argument == "--compare-loaders") {
+            compare = true;
+        } else {
+            directory = argument;
+        }
+    }
+
+    if (!std::filesystem::is_directory(directory)) {
+        spdlog::error("[Cooker] {} is not a directory", directory.string());
+
+        return EXIT_FAILURE;
+    }
+
+    if (compare) return compareLoaders(directory);
+
+    cooker::ModelCooker cooker;
+    int failed = 0;
+
+    for (auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::filesystem::path input = entry.path();
+
+        if (input.extension() != ".gltf" && input.extension() != ".glb") continue;
+
+        std::filesystem::path output = input;
+        output.replace_extension(COOKED_MODEL_EXTENSION);
+
+        if (!force && engine::CookedModel::isUpToDate(output.string(), input.string())) {
+            spdlog::info("[Cooker] {} is up to date", output.filename().string());
+            continue;
+        }
+
+        if (!cooker.cook(input.string(), output.string())) {
+            ++failed;
+            continue;
+        }
+
+        const cooker::ModelCooker::Report& report = cooker.getReport();
+        spdlog::info("[Cooker] {}: {} meshes, {} vertices ({} KB packed, {} KB full), {} indices, {} KB -> {} KB in {:.2f} ms",
+                     input.filename().string(), report.meshes, report.vertices, report.vertexBytes / 1024,
+                     report.fullVertexBytes / 1024, report.indices, report.sourceBytes / 1024, report.cookedBytes / 1024,
+                     report.milliseconds);
+    }
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -21,13 +21,7 @@ namespace editor {
     Editor::~Editor() = default;
 
     void Editor::init() {
-        vk::PushConstantRange constantRange{
-                .stageFlags = vk::ShaderStageFlagBits::eVertex,
-                .offset = 0,
-                .size = sizeof(engine::MVP)
-        };
-
-        m_gridPipeline = m_renderer->addPipeline(engine::Application::m_resourceManager->createShader("grid.vert.spv", "grid.frag.spv", {constantRange}, false),
+        m_gridPipeline = m_renderer->addPipeline(engine::Application::m_resourceManager->createShader("grid.vert.spv", "grid.frag.spv", {}, false),
                                                  m_device->m_logicalDevice, nullptr, true);
 
         m_resourceManager->createModel("cube", "cube");
@@ -61,7 +55,7 @@ namespace editor {
         setLuaBindings(editor);
 
         std::string none = "none";
-        noneAnimation = std::hash<std::string>{}(none);
+        noneAnimation = engine::tools::hashString(none);
         animationsName[noneAnimation] = none;
 
         m_luaManager.scriptFile("main.lua");
@@ -360,7 +354,7 @@ namespace editor {
                 std::string animationDir = "animations/";
                 idx = (int)filePath.rfind(animationDir);
                 std::string fileName = filePath.substr(idx + animationDir.size(), filePath.size());
-                animationsName[std::hash<std::string>{}(fileName)] = fileName;
+                animationsName[engine::tools::hashString(fileName)] = fileName;
             }
 
             ImGuiFileDialog::Instance()->Close();
@@ -373,7 +367,7 @@ namespace editor {
         if (type & engine::ComponentFlags::ANIMATION) {
             auto& entity = m_scene->getEntity(id);
             auto& registry = m_scene->registry();
-            std::vector<uint32_t> animationList{noneAnimation, noneAnimation, noneAnimation, noneAnimation};
+            std::vector<uint64_t> animationList{noneAnimation, noneAnimation, noneAnimation, noneAnimation};
             auto& model = registry.get<engine::ModelInterface>(entity.enttID);
             registry.emplace<engine::AnimationInterface>(entity.enttID,
                                                          model.getHandle(),
@@ -86,8 +86,8 @@ namespace editor {
         bool m_sceneLoaded =  false;
         std::shared_ptr<engine::GraphicsPipeline> m_gridPipeline;
         std::vector<MenuBar> m_menuBar;
-        std::unordered_map<uint32_t , std::string> animationsName;
-        uint32_t noneAnimation{};
+        std::unordered_map<uint64_t, std::string> animationsName;
+        uint64_t noneAnimation{};
     };
 
 } // namespace editor
@@ -4,6 +4,7 @@
 
 #include "renderer/CommandList.hpp"
 #include "renderer/GraphicsPipeline.hpp"
+#include "resources/Shader.hpp"
 #include "lua/MathBindings.hpp"
 #include "physcis/PhysicsEngine.hpp"
 
@@ -31,23 +32,24 @@ namespace engine {
             .pApplicationName = appName.c_str(),
             .applicationVersion = VK_MAKE_VERSION(0, 1, 0),
             .pEngineName = "Custom Engine",
-            .engineVersion = VK_MAKE_VERSION(0, 1, 0)
+            .engineVersion = VK_MAKE_VERSION(0, 1, 0),
+            .apiVersion = VK_API_VERSION_1_1
         });
 
         m_device = std::make_shared<engine::Device>(m_instance);
         m_renderer = std::make_unique<engine::RenderEngine>(m_window, m_instance->getInstance(), appName, m_device, m_instance->createSurface(m_window->getWindow()));
         m_resourceManager = std::make_unique<engine::ResourceManager>(m_device, m_renderer->getGraphicsQueue());
 
-        vk::PushConstantRange constantRange{
-                .stageFlags = vk::ShaderStageFlagBits::eVertex,
-                .offset = 0,
-                .size = sizeof(MVP)
-        };
+        // One pipeline per vertex layout, meshes pick theirs when they are drawn. Push constants are read from the shaders
+        std::string fragShader = m_device->m_bindless ? "model_bindless.frag.spv" : "model.frag.spv";
+        auto staticShader = Application::m_resourceManager->createShader("model_static.vert.spv", fragShader);
+        staticShader->setAtrributes(StaticVertex::getBindingDescription(), StaticVertex::getAttributeDescriptions());
+        m_pipelineStatic = m_renderer->addPipeline(staticShader, m_device->m_logicalDevice);
 
-        std::string vertShader = "model.vert.spv";
-        std::string fragShader = "model.frag.spv";
-        m_pipelineAnimation = m_renderer->addPipeline(Application::m_resourceManager->createShader(vertShader, fragShader, {constantRange}),
-                                                      m_device->m_logicalDevice);
+        auto skinnedShader = Application::m_resourceManager->createShader("model.vert.spv", fragShader);
+        skinnedShader->setAtrributes(SkinnedVertex::getBindingDescription(), SkinnedVertex::getAttributeDescriptions());
+        m_pipelineAnimation = m_renderer->addPipeline(skinnedShader, m_device->m_logicalDevice);
+        m_pipelineAnimation->addVariant(GraphicsPipeline::VARIANT_SKINNED);
         m_renderer->init();
 
         m_scene = std::make_unique<engine::Scene>();
@@ -63,6 +65,7 @@ namespace engine {
 
         sol::table tools = m_luaManager.getState()["tools"].get_or_create<sol::table>();
         tools.set_function("hashString", &tools::hashString);
+        tools.set_function("lookupString", &tools::lookupString);
         tools.set_function("getDeltaTime", &Application::getDeltaTime, this);
 
         physicsEngine = std::make_unique<PhysicsEngine>();
@@ -71,6 +74,13 @@ namespace engine {
         mousePicking->setLuaBindings(m_luaManager.getState());
 
         m_threadPool = std::make_unique<ThreadPool>();
+        // One buffer per worker and the main thread for the scene, one for the commands of the application
+        m_secondaryCommands.create(m_device, static_cast<uint32_t>(m_threadPool->getThreads().size()) + 2);
+
+        if (m_editor && HOT_RELOAD) {
+            m_hotReloader = std::make_unique<HotReloader>(m_device);
+            m_hotReloader->start();
+        }
 
         spdlog::info("[App] Start");
     }
@@ -82,7 +92,10 @@ namespace engine {
 
         updatePipeline();
 
-        m_resourceManager->initialPose();
+        m_device->m_allocator->logStats();
+        m_resourceManager->logResidency();
+        m_resourceManager->getGeometry().logStats();
+
         loop();
         shutdown();
     }
@@ -91,11 +104,13 @@ namespace engine {
         m_device->m_logicalDevice.waitIdle();
 
         cleanup();
+        if (m_hotReloader) m_hotReloader->stop();
         m_threadPool->stop();
         m_scene->cleanup();
         physicsEngine->cleanup();
         m_ui.cleanupResources();
         m_ui.cleanup();
+        m_secondaryCommands.cleanup();
         m_renderer->cleanup(m_instance);
         m_resourceManager->cleanup();
         m_device->destroy();
@@ -109,6 +124,9 @@ namespace engine {
         while (m_window->isOpen()) {
             glfwPollEvents();
 
+            if (m_hotReloader) m_hotReloader->update();
+            m_resourceManager->updateResidency();
+
             auto now = static_cast<float>(glfwGetTime());
             m_deltaTime = now - m_lastTime;
             m_lastTime = now;
@@ -124,16 +142,26 @@ namespace engine {
             m_luaManager.executeFunction("drawUI");
             engine::UIRender::render();
 
+            m_scene->collectDraws(m_pipelineStatic, m_pipelineAnimation);
+            m_resourceManager->reservePalettes(m_scene->getDrawList().getPaletteSize());
+
             m_renderer->acquireNextImage();
+            m_resourceManager->getPaletteRing().beginFrame(m_renderer->getCurrentFrame());
+            m_secondaryCommands.beginFrame(m_renderer->getCurrentFrame(), m_renderer->getRenderPass(), m_renderer->getFrameBuffer(),
+                                           m_renderer->getSwapChainExtent());
+            m_secondaryCommands.bindDescriptorSet(m_pipelineAnimation->getLayout(), 0, m_renderer->getDescriptorSet());
+            m_secondaryCommands.bindDescriptorSet(m_pipelineAnimation->getLayout(), 2, m_resourceManager->getPaletteDescriptorSet());
             m_commands->begin();
             {
-                m_commands->beginRenderPass(m_renderer->getRenderPass(), m_clearColor, m_renderer->getFrameBuffer(), m_renderer->getSwapChainExtent());
+                m_commands->beginRenderPass(m_renderer->getRenderPass(), m_clearColor, m_renderer->getFrameBuffer(), m_renderer->getSwapChainExtent(),
+                                            vk::SubpassContents::eSecondaryCommandBuffers);
                 {
-                    m_pipelineAnimation->bind(m_commands->getBuffer());
-                    m_commands->getBuffer().bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipelineAnimation->getLayout(), 0, 1,
-                                                               &m_renderer->getDescriptorSet(), 0, nullptr);
-                    m_scene->render(m_commands->getBuffer(), m_pipelineAnimation);
-                    renderCommands(m_commands->getBuffer());
+                    m_scene->render(m_secondaryCommands);
+
+                    vk::CommandBuffer cmdBuffer = m_secondaryCommands.acquire();
+                    renderCommands(cmdBuffer);
+
+                    m_secondaryCommands.execute(m_commands->getBuffer());
                 }
                 m_commands->endRenderPass();
             }
@@ -148,21 +176,16 @@ namespace engine {
     }
 
     void Application::updatePipeline() {
-        uint32_t maxPoolSize = m_resourceManager->getMeshesCount();
-        vk::DescriptorPoolSize poolSizes = {
-            .type = vk::DescriptorType::eUniformBuffer,
-            .descriptorCount = maxPoolSize
-        };
-
-        m_resourceManager->createMeshDescriptors({poolSizes}, maxPoolSize + 1);
-        m_resourceManager->createMeshDescriptorSets();
+        m_resourceManager->createPaletteDescriptors();
 
         std::vector<vk::DescriptorSetLayout> layouts = {
                 m_renderer->getDescriptorSetLayout(),
                 m_resourceManager->getTextureDescriptorSetLayout(),
-                m_resourceManager->getMeshDescriptorSetLayout()
+                m_resourceManager->getPaletteDescriptorSetLayout()
         };
 
+        m_pipelineStatic->cleanup();
+        m_pipelineStatic->create(layouts, m_renderer->getSwapChain(), m_renderer->getRenderPass(), m_device->getMaxUsableSampleCount());
         m_pipelineAnimation->cleanup();
         m_pipelineAnimation->create(layouts, m_renderer->getSwapChain(), m_renderer->getRenderPass(), m_device->getMaxUsableSampleCount());
     }
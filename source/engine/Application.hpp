@@ -11,12 +11,14 @@
 #include "renderer/RenderEngine.hpp"
 #include "renderer/Device.hpp"
 #include "renderer/Instance.hpp"
+#include "renderer/SecondaryCommands.hpp"
 #include "scene/Scene.hpp"
 #include "components/Transform.hpp"
 #include "resources/ResourceManager.hpp"
 #include "lua/LuaManager.hpp"
 #include "ui/UIRender.hpp"
 #include "threads/ThreadPool.hpp"
+#include "resources/HotReloader.hpp"
 #include "MousePicking/MousePicking.hpp"
 
 
@@ -70,8 +72,11 @@ namespace engine {
         std::shared_ptr<engine::Instance> m_instance;
         float m_lastTime{}, m_deltaTime{};
         glm::vec4 m_clearColor;
+        std::shared_ptr<GraphicsPipeline> m_pipelineStatic;
         std::shared_ptr<GraphicsPipeline> m_pipelineAnimation;
         std::shared_ptr<CommandList> m_commands;
+        SecondaryCommands m_secondaryCommands;
+        std::unique_ptr<HotReloader> m_hotReloader;
         UIRender m_ui;
         LuaManager m_luaManager;
     };
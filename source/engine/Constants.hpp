@@ -13,8 +13,42 @@
 #define CORE_DEBUG
 #endif
 
-const int MAX_FRAMES_IN_FLIGHT = 1;
+// Frames recorded by the CPU while the GPU still renders the previous ones, 1 to 3, 1 makes the CPU wait for every frame.
+// Each one has its own command buffers, descriptor sets and palette ring segment
+const uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+// Fewest draws recorded by a thread into its own secondary command buffer, smaller draw lists use fewer threads
+const uint32_t RECORD_BATCH_DRAWS = 512;
+// Fewest bounding spheres tested against the frustum by a thread
+const uint32_t CULL_BATCH_SPHERES = 4096;
+// Frames averaged by the frame time, CPU time and fence wait statistics of the renderer
+const uint32_t FRAME_STATS_INTERVAL = 600;
 const int MAX_OBJECTS = 100;
+// Size of the texture array shared by every draw when descriptor indexing is supported, MAX_OBJECTS sets are used otherwise
+const uint32_t BINDLESS_TEXTURES = 4096;
+
+const bool COMPRESS_ANIMATIONS = true;
+// Editor only: textures, models, animations and shaders changed on disk are reloaded between two frames
+const bool HOT_RELOAD = true;
+// Device memory is reserved in blocks of this size and sub-allocated, larger resources get a dedicated allocation
+const uint64_t MEMORY_BLOCK_SIZE = 64 * 1024 * 1024;
+// Resources without references are evicted, least recently used first, while one of the budgets is exceeded
+const uint64_t CPU_MEMORY_BUDGET = 512ull * 1024 * 1024;
+const uint64_t GPU_MEMORY_BUDGET = 1536ull * 1024 * 1024;
+// Elements per page of the vertex and index buffers shared by all meshes
+const uint32_t GEOMETRY_PAGE_VERTICES = 1024 * 1024;
+const uint32_t GEOMETRY_PAGE_INDICES = 4 * 1024 * 1024;
+const uint64_t UPLOAD_STAGING_SIZE = 32 * 1024 * 1024;
+// Bytes of model, node and joint matrices of the instances that can be written per frame in flight
+const uint64_t PALETTE_RING_SEGMENT_SIZE = 4 * 1024 * 1024;
+
+// Written by the AssetCooker next to the glTF file, it is loaded instead of the glTF when it exists
+const std::string COOKED_MODEL_EXTENSION = ".model";
+// Raw keys of a clip, written next to its glTF file on the first load and read instead of it while the file is unchanged
+const std::string CLIP_CACHE_EXTENSION = ".clip";
+// Bound by the meshes without a texture of their own, a white image leaves the shading unchanged
+const std::string DEFAULT_TEXTURE = "default_white";
+// Pipeline cache data of the driver, written on exit and only loaded back by the same driver and device
+const std::string PIPELINE_CACHE_FILE = "pipeline.cache";
 
 #ifdef _WIN32
 const std::string TEXTURES_DIR = "..\\..\\Assets\\textures\\";
@@ -41,4 +75,13 @@ const float Z_NEAR_PLANE = 0.01f;
 const float Z_FAR_PLANE = 100.00f;
 const float FOV = 45.0f;
 
+// Animation LOD: full rate up to this distance from the camera, reduced rate further out and paused out of the view
+const float ANIMATION_LOD_FULL_DISTANCE = 20.0f;
+const float ANIMATION_LOD_REDUCED_HZ = 10.0f;
+const uint32_t ANIMATION_LOD_BONE_DEPTH = 6;
+
+// A clip that failed to be read is requested again after this many frames, doubled on each failure, up to the attempts
+const uint64_t ANIMATION_RETRY_FRAMES = 60;
+const uint32_t ANIMATION_READ_ATTEMPTS = 5;
+
 #endif //PROTOTYPE_ACTION_RPG_CONSTANTS_HPP
@@ -0,0 +1,103 @@
+#ifndef PROTOTYPE_ACTION_RPG_HASH_HPP
+#define PROTOTYPE_ACTION_RPG_HASH_HPP
+
+
+#include <cstdint>
+#include <string_view>
+
+
+namespace engine {
+
+    namespace tools {
+
+        namespace xxh64 {
+
+            constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+            constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+            constexpr uint64_t PRIME3 = 0x165667B19E3779F9ull;
+            constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ull;
+            constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ull;
+
+            constexpr uint64_t rotl(uint64_t value, int bits) {
+                return (value << bits) | (value >> (64 - bits));
+            }
+
+            // Byte by byte so the same code runs in constant expressions, compilers merge it into a single load
+            constexpr uint64_t read(std::string_view s, size_t offset, size_t bytes) {
+                uint64_t value = 0;
+
+                for (size_t i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(static_cast<uint8_t>(s[offset + i])) << (8 * i);
+
+                return value;
+            }
+
+            constexpr uint64_t round(uint64_t accumulator, uint64_t input) {
+                return rotl(accumulator + input * PRIME2, 31) * PRIME1;
+            }
+
+            constexpr uint64_t merge(uint64_t hash, uint64_t accumulator) {
+                return (hash ^ round(0, accumulator)) * PRIME1 + PRIME4;
+            }
+
+        } // namespace xxh64
+
+        // XXH64, the ids of every asset. Usable in constant expressions: constexpr uint64_t CUBE = tools::hash("cube");
+        constexpr uint64_t hash(std::string_view s, uint64_t seed = 0) {
+            size_t offset = 0;
+            uint64_t hash;
+
+            if (s.size() >= 32) {
+                uint64_t v1 = seed + xxh64::PRIME1 + xxh64::PRIME2;
+                uint64_t v2 = seed + xxh64::PRIME2;
+                uint64_t v3 = seed;
+                uint64_t v4 = seed - xxh64::PRIME1;
+
+                for (; offset + 32 <= s.size(); offset += 32) {
+                    v1 = xxh64::round(v1, xxh64::read(s, offset, 8));
+                    v2 = xxh64::round(v2, xxh64::read(s, offset + 8, 8));
+                    v3 = xxh64::round(v3, xxh64::read(s, offset + 16, 8));
+                    v4 = xxh64::round(v4, xxh64::read(s, offset + 24, 8));
+                }
+
+                hash = xxh64::rotl(v1, 1) + xxh64::rotl(v2, 7) + xxh64::rotl(v3, 12) + xxh64::rotl(v4, 18);
+                hash = xxh64::merge(hash, v1);
+                hash = xxh64::merge(hash, v2);
+                hash = xxh64::merge(hash, v3);
+                hash = xxh64::merge(hash, v4);
+            } else {
+                hash = seed + xxh64::PRIME5;
+            }
+
+            hash += s.size();
+
+            for (; offset + 8 <= s.size(); offset += 8) {
+                hash ^= xxh64::round(0, xxh64::read(s, offset, 8));
+                hash = xxh64::rotl(hash, 27) * xxh64::PRIME1 + xxh64::PRIME4;
+            }
+
+            if (offset + 4 <= s.size()) {
+                hash ^= xxh64::read(s, offset, 4) * xxh64::PRIME1;
+                hash = xxh64::rotl(hash, 23) * xxh64::PRIME2 + xxh64::PRIME3;
+                offset += 4;
+            }
+
+            for (; offset < s.size(); ++offset) {
+                hash ^= static_cast<uint8_t>(s[offset]) * xxh64::PRIME5;
+                hash = xxh64::rotl(hash, 11) * xxh64::PRIME1;
+            }
+
+            hash ^= hash >> 33;
+            hash *= xxh64::PRIME2;
+            hash ^= hash >> 29;
+            hash *= xxh64::PRIME3;
+            hash ^= hash >> 32;
+
+            return hash;
+        }
+
+    } // namespace tools
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_HASH_HPP
@@ -1,7 +1,20 @@
 #include "Utilities.hpp"
 
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include "spdlog/spdlog.h"
 
 
 namespace engine {
@@ -14,10 +27,11 @@ namespace engine {
            if (!file.is_open()) throw std::runtime_error("Failed to open file: " + fileName);
 
            size_t fileSize = static_cast<size_t>(file.tellg());
-           std::vector<uint32_t> buffer(fileSize);
+           // SPIR-V is made of 32 bit words
+           std::vector<uint32_t> buffer(fileSize / sizeof(uint32_t));
 
            file.seekg(0);
-           file.read(reinterpret_cast<char *>(buffer.data()), fileSize);
+           file.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(uint32_t)));
 
            file.close();
 
@@ -39,18 +53,70 @@ namespace engine {
            return image;
        }
 
+       stbi_uc* loadTextureMemory(const uint8_t* data, size_t length, int* width, int* height, VkDeviceSize* size) {
+           int channels;
+
+           stbi_uc* image = stbi_load_from_memory(data, static_cast<int>(length), width, height, &channels, STBI_rgb_alpha);
+
+           if (!image) throw std::runtime_error("Failed to decode an embedded Texture");
+
+           *size = *width * *height * static_cast<int>(STBI_rgb_alpha);
+
+           return image;
+       }
+
+       size_t getPeakMemory() {
+#ifdef _WIN32
+           PROCESS_MEMORY_COUNTERS counters{};
+           GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+
+           return counters.PeakWorkingSetSize;
+#else
+           rusage usage{};
+           getrusage(RUSAGE_SELF, &usage);
+
+           // Kilobytes on Linux
+           return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+       }
+
        uint64_t hashString(const std::string& s) {
-           const unsigned int p = 31;
-           const unsigned int m = 1e9 + 9;
-           uint32_t hashValue = 0;
-           uint32_t pPow = 1;
-
-           for (char c : s) {
-               hashValue = (hashValue + (c - 'a' + 1) * pPow) % m;
-               pPow = (pPow + p) % m;
+           return hash(s);
+       }
+
+       struct StringTable {
+           std::mutex mutex;
+           std::unordered_map<uint64_t, std::string> names;
+       };
+
+       static StringTable& getStringTable() {
+           static StringTable table;
+
+           return table;
+       }
+
+       uint64_t internString(std::string_view s) {
+           uint64_t id = hash(s);
+           StringTable& table = getStringTable();
+           std::lock_guard<std::mutex> lock(table.mutex);
+
+           auto [it, inserted] = table.names.try_emplace(id, s);
+
+           if (!inserted && it->second != s) {
+               spdlog::error("[Hash] \"{}\" and \"{}\" have the same id {:#018x}, the second one aliases the first", it->second, s, id);
            }
 
-           return hashValue;
+           return id;
+       }
+
+       std::string_view lookupString(uint64_t id) {
+           StringTable& table = getStringTable();
+           std::lock_guard<std::mutex> lock(table.mutex);
+
+           auto it = table.names.find(id);
+
+           // Names are never removed, the view stays valid
+           return it != table.names.end() ? std::string_view(it->second) : std::string_view();
        }
 
    } // namespace tools
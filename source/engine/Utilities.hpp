@@ -3,6 +3,7 @@
 
 
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <vector>
 #include <fstream>
@@ -12,6 +13,7 @@
 #include "stb_image.h"
 #include "fmt/format.h"
 
+#include "Hash.hpp"
 #include "Constants.hpp"
 
 
@@ -30,6 +32,15 @@ namespace engine {
         glm::mat4 getMatrix() const;
     };
 
+    // Pushed by the model shaders right after the projection and view of the MVP, the model matrix of each instance is read
+    // from its palette block. The offset is in matrices into the palette ring buffer. The texture index is the element of
+    // the bindless texture array, unused without descriptor indexing
+    struct DrawConstants {
+        uint32_t paletteOffset;
+        uint32_t jointCount;
+        uint32_t textureIndex;
+    };
+
     inline void throw_ex(const std::string& message) {
         throw std::runtime_error(message);
     };
@@ -40,8 +51,20 @@ namespace engine {
 
         stbi_uc* loadTextureFile(const std::string& fileName, int* width, int* height, VkDeviceSize* size);
 
+        // Encoded image held in memory, the images embedded in binary glTF files
+        stbi_uc* loadTextureMemory(const uint8_t* data, size_t length, int* width, int* height, VkDeviceSize* size);
+
+        // Highest resident set size of the process so far, in bytes
+        size_t getPeakMemory();
+
         uint64_t hashString(const std::string& s);
 
+        // Hashes a name and remembers it, two names with the same id are reported. Every asset id is registered here
+        uint64_t internString(std::string_view s);
+
+        // Name registered for an id, for logs and debugging. Empty when the id was never interned
+        std::string_view lookupString(uint64_t id);
+
     } // namespace tools
 
 } // namespace core
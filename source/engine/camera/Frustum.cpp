@@ -0,0 +1,73 @@
+#include "Frustum.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+
+namespace engine {
+
+    Frustum::Frustum() = default;
+
+    Frustum::Frustum(const glm::mat4& viewProj) {
+        auto row = [&viewProj](int i) {
+            return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+        };
+
+        m_planes[LEFT] = row(3) + row(0);
+        m_planes[RIGHT] = row(3) - row(0);
+        m_planes[BOTTOM] = row(3) + row(1);
+        m_planes[TOP] = row(3) - row(1);
+        m_planes[NEAR_CLIP] = row(3) + row(2);
+        m_planes[FAR_CLIP] = row(3) - row(2);
+
+        for (auto& plane : m_planes) plane /= glm::length(glm::vec3(plane));
+    }
+
+    bool Frustum::intersects(const glm::vec3& center, float radius) const {
+        for (auto& plane : m_planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+
+        return true;
+    }
+
+    void Frustum::intersects(const float* x, const float* y, const float* z, const float* radius, size_t count, uint8_t* visible) const {
+        size_t i = 0;
+
+#ifdef FRUSTUM_SSE
+        __m128 planes[6][4];
+
+        for (int p = 0; p < 6; ++p) {
+            for (int c = 0; c < 4; ++c) planes[p][c] = _mm_set1_ps(m_planes[p][c]);
+        }
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 cx = _mm_loadu_ps(x + i);
+            __m128 cy = _mm_loadu_ps(y + i);
+            __m128 cz = _mm_loadu_ps(z + i);
+            __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+            __m128 inside{};
+
+            for (int p = 0; p < 6; ++p) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes[p][0], cx), _mm_mul_ps(planes[p][1], cy)),
+                                             _mm_add_ps(_mm_mul_ps(planes[p][2], cz), planes[p][3]));
+                __m128 plane = _mm_cmpge_ps(distance, negRadius);
+                inside = p == 0 ? plane : _mm_and_ps(inside, plane);
+            }
+
+            int mask = _mm_movemask_ps(inside);
+
+            for (int k = 0; k < 4; ++k) visible[i + k] = static_cast<uint8_t>((mask >> k) & 1);
+        }
+#endif
+
+        for (; i < count; ++i) visible[i] = intersects(glm::vec3(x[i], y[i], z[i]), radius[i]) ? 1 : 0;
+    }
+
+    const std::array<glm::vec4, 6>& Frustum::getPlanes() const {
+        return m_planes;
+    }
+
+} // namespace engine
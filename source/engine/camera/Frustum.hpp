@@ -0,0 +1,44 @@
+#ifndef PROTOTYPE_ACTION_RPG_FRUSTUM_HPP
+#define PROTOTYPE_ACTION_RPG_FRUSTUM_HPP
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+
+namespace engine {
+
+    class Frustum {
+    public:
+        enum Plane {
+            LEFT = 0,
+            RIGHT = 1,
+            BOTTOM = 2,
+            TOP = 3,
+            NEAR_CLIP = 4,
+            FAR_CLIP = 5
+        };
+
+    public:
+        Frustum();
+
+        explicit Frustum(const glm::mat4& viewProj);
+
+        [[nodiscard]] bool intersects(const glm::vec3& center, float radius) const;
+
+        // Spheres given as one array per component, four are tested at once with SSE. visible[i] is set to 0 or 1
+        void intersects(const float* x, const float* y, const float* z, const float* radius, size_t count, uint8_t* visible) const;
+
+        [[nodiscard]] const std::array<glm::vec4, 6>& getPlanes() const;
+
+    private:
+        std::array<glm::vec4, 6> m_planes{};
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_FRUSTUM_HPP
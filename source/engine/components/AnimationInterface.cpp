@@ -1,8 +1,8 @@
 #include "AnimationInterface.hpp"
 
 #include <utility>
+#include <algorithm>
 
-#include "spdlog/spdlog.h"
 #include "glm/glm.hpp"
 #include "glm/gtc/quaternion.hpp"
 
@@ -10,89 +10,171 @@
 #include "../resources/Model.hpp"
 
 
+inline void applyChannel(engine::Model::Node& node, engine::Animation::Channel::PathType path, const glm::vec4& value) {
+    switch (path) {
+        case engine::Animation::Channel::PathType::TRANSLATION:
+            node.position = glm::vec3(value);
+            break;
+        case engine::Animation::Channel::PathType::ROTATION:
+            node.rotation = glm::normalize(glm::quat(value.w, value.x, value.y, value.z));
+            break;
+        case engine::Animation::Channel::PathType::SCALE:
+            node.scale = glm::vec3(value);
+            break;
+    }
+}
+
+inline glm::vec4 blendChannel(engine::Animation::Channel::PathType path, const glm::vec4& from, const glm::vec4& to, float t) {
+    if (path != engine::Animation::Channel::PathType::ROTATION) return glm::mix(from, to, t);
+
+    glm::quat rotation = glm::slerp(glm::quat(from.w, from.x, from.y, from.z), glm::quat(to.w, to.x, to.y, to.z), t);
+
+    return {rotation.x, rotation.y, rotation.z, rotation.w};
+}
+
+// Clips usually played after each one, they are read ahead so a switch rarely waits for its clip
+inline std::vector<engine::Animation::Type> getLikelyNext(engine::Animation::Type type) {
+    switch (type) {
+        case engine::Animation::Type::idle:
+            return {engine::Animation::Type::walk, engine::Animation::Type::attack};
+        case engine::Animation::Type::walk:
+            return {engine::Animation::Type::idle, engine::Animation::Type::attack};
+        case engine::Animation::Type::attack:
+            return {engine::Animation::Type::idle, engine::Animation::Type::death};
+        default:
+            return {};
+    }
+}
+
 namespace engine {
 
     AnimationInterface::AnimationInterface() = default;
 
-    AnimationInterface::AnimationInterface(std::shared_ptr<Model> model, std::vector<uint32_t> animationList)
+    AnimationInterface::AnimationInterface(std::shared_ptr<Model> model, std::vector<uint64_t> animationList)
             : model(std::move(model)), animationsList(std::move(animationList)) {
+        nodes = this->model->getNodes();
+        this->model->buildPalette(nodes, palette);
 
+        for (uint64_t animationID : animationsList) m_clips.emplace_back(ResourceType::ANIMATION, animationID);
+    }
+
+    void AnimationInterface::refresh() {
+        nodes = model->getNodes();
+        model->buildPalette(nodes, palette);
+        m_reducedClip = nullptr;
     }
 
     void AnimationInterface::update(float delaTime) {
-        animation = Application::m_resourceManager->getAnimation(animationsList[currentAnimation - 1]);
-        animation->m_currentTime += delaTime;
+        uint64_t clip = animationsList[currentAnimation - 1];
+        animation = Application::m_resourceManager->getAnimation(clip);
+
+        // Clips are read on their first use and again after an eviction, getAnimation requests them and the pose is held
+        // until they are there
+        if (!animation) {
+            reset = false;
+            return;
+        }
+
+        // Requests of resident clips are dropped between two frames
+        if (currentAnimation != m_prefetched) {
+            m_prefetched = currentAnimation;
+
+            for (Animation::Type next : getLikelyNext(currentAnimation)) Application::m_resourceManager->requestAnimation(animationsList[next - 1]);
+        }
 
-        if (animation->m_currentTime > animation->m_end && loop) {
-            animation->m_currentTime -= animation->m_end;
+        currentTime += delaTime;
+
+        if (currentTime > animation->m_end && loop) {
+            currentTime -= animation->m_end;
             reset = true;
         } else {
             reset = false;
         }
 
-        for (auto& channel : animation->m_channels) {
-            Animation::Sampler& sampler = animation->m_samplers[channel.samplerIndex];
+        // The clock always runs, only the pose evaluation follows the LOD tier
+        if (lodTier == LodTier::PAUSED) {
+            m_reducedClip = nullptr;
+            return;
+        }
 
-            if (sampler.interpolation != Animation::Sampler::InterpolationType::LINEAR) {
-                spdlog::error( "This sample only supports linear interpolations\n");
-                continue;
-            }
+        if (lodTier == LodTier::REDUCED) {
+            updateReduced(delaTime);
+            return;
+        }
+
+        m_reducedClip = nullptr;
+        m_channels.clear();
+
+        for (uint32_t i = 0; i < animation->m_channels.size(); ++i) {
+            if (animation->m_channels[i].nodeID >= 0) m_channels.push_back(i);
+        }
+
+        sample(currentTime, m_values);
+
+        for (uint32_t i = 0; i < m_channels.size(); ++i) {
+            const Animation::Channel& channel = animation->m_channels[m_channels[i]];
+            applyChannel(nodes[channel.nodeID], channel.path, m_values[i]);
+        }
 
-            for (size_t i = 0; i < sampler.inputs.size() - 1; ++i) {
-                if ((animation->m_currentTime >= sampler.inputs[i]) && (animation->m_currentTime <= sampler.inputs[i + 1])) {
-                    float a = (animation->m_currentTime - sampler.inputs[i]) / (sampler.inputs[i + 1] - sampler.inputs[i]);
-                    Model::Node& node = model->getNode(channel.nodeID);
-
-                    switch (channel.path) {
-                        case Animation::Channel::PathType::TRANSLATION: {
-                            node.position = glm::mix(sampler.outputs[i], sampler.outputs[i + 1], a);
-                        }
-                        case Animation::Channel::PathType::ROTATION: {
-                            glm::quat q1;
-                            q1.x = sampler.outputs[i].x;
-                            q1.y = sampler.outputs[i].y;
-                            q1.z = sampler.outputs[i].z;
-                            q1.w = sampler.outputs[i].w;
-
-                            glm::quat q2;
-                            q2.x = sampler.outputs[i + 1].x;
-                            q2.y = sampler.outputs[i + 1].y;
-                            q2.z = sampler.outputs[i + 1].z;
-                            q2.w = sampler.outputs[i + 1].w;
-
-                            node.rotation = glm::normalize(glm::slerp(q1, q2, a));
-                        }
-                        case Animation::Channel::PathType::SCALE: {
-                            node.scale = glm::mix(sampler.outputs[i], sampler.outputs[i + 1], a);
-                        }
-                    }
-                }
+        model->buildPalette(nodes, palette);
+    }
+
+    void AnimationInterface::sample(float time, std::vector<glm::vec4>& values) {
+        if (animation->m_poseCache.isBaked()) {
+            animation->m_poseCache.sample(*animation, time, m_channels, values);
+        } else {
+            m_sampler.sample(*animation, time, m_channels, values);
+        }
+    }
+
+    void AnimationInterface::updateReduced(float deltaTime) {
+        const float step = 1.0f / ANIMATION_LOD_REDUCED_HZ;
+        lodAccumulator += deltaTime;
+        bool sampled = false;
+
+        if (m_reducedClip != animation.get()) {
+            m_reducedClip = animation.get();
+            m_channels.clear();
+
+            for (uint32_t i = 0; i < animation->m_channels.size(); ++i) {
+                if (animation->m_channels[i].nodeID >= 0) m_channels.push_back(i);
             }
+
+            sample(currentTime, m_reducedFrom);
+            sampled = true;
+            lodAccumulator = step;
         }
 
-        for (auto& node : model->getNodes()) {
-            if (node.mesh > 0) {
-                glm::mat4 matrix = node.getMatrix(model);
-                Mesh& mesh = Application::m_resourceManager->getMesh(node.mesh);
-
-                if (node.skin > -1) {
-                    mesh.m_uniformBlock.matrix = matrix;
-                    glm::mat4 inverseTransform = glm::inverse(matrix);
-                    Model::Skin &skin = model->getSkin(node.skin);
-                    size_t numJoints = static_cast<uint32_t>(skin.joints.size());
-
-                    for (size_t i = 0; i < numJoints; ++i) {
-                        glm::mat4 jointMatrix = model->getNode(skin.joints[i]).getMatrix(model) * skin.inverseBindMatrices[i];
-                        mesh.m_uniformBlock.jointMatrix[i] = inverseTransform * jointMatrix;
-                    }
-
-                    mesh.m_uniformBlock.jointCount = (float)numJoints;
-                    mesh.m_uniformBuffer.copyTo(&mesh.m_uniformBlock, sizeof(mesh.m_uniformBlock));
-                } else {
-                    mesh.m_uniformBuffer.copyTo(&matrix, sizeof(glm::mat4));
-                }
+        if (lodAccumulator >= step) {
+            // The previous target is the pose at the current time, unless the clip was just started
+            if (!sampled) std::swap(m_reducedFrom, m_values);
+
+            float time = currentTime + step;
+
+            if (time > animation->m_end && loop) time -= animation->m_end;
+
+            sample(time, m_values);
+            lodAccumulator = 0.0f;
+
+            // Deep bones move little on screen, they take the sampled pose at the reduced rate and skip the blending
+            for (uint32_t i = 0; i < m_channels.size(); ++i) {
+                const Animation::Channel& channel = animation->m_channels[m_channels[i]];
+
+                if (nodes[channel.nodeID].depth > ANIMATION_LOD_BONE_DEPTH) applyChannel(nodes[channel.nodeID], channel.path, m_reducedFrom[i]);
             }
         }
+
+        float t = std::min(lodAccumulator / step, 1.0f);
+
+        for (uint32_t i = 0; i < m_channels.size(); ++i) {
+            const Animation::Channel& channel = animation->m_channels[m_channels[i]];
+
+            if (nodes[channel.nodeID].depth > ANIMATION_LOD_BONE_DEPTH) continue;
+
+            applyChannel(nodes[channel.nodeID], channel.path, blendChannel(channel.path, m_reducedFrom[i], m_values[i], t));
+        }
+
+        model->buildPalette(nodes, palette);
     }
 
     void AnimationInterface::setLuaBindings(sol::table &table) {
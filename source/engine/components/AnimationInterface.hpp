@@ -9,6 +9,9 @@
 #include "sol/sol.hpp"
 
 #include "../resources/Animation.hpp"
+#include "../resources/Model.hpp"
+#include "../resources/AnimationSampler.hpp"
+#include "../resources/ResourceHandle.hpp"
 
 
 namespace engine {
@@ -17,22 +20,57 @@ namespace engine {
     class Model;
 
     class AnimationInterface {
+    public:
+        enum LodTier {
+            FULL = 0,
+            REDUCED = 1,
+            PAUSED = 2
+        };
+
     public:
         AnimationInterface();
 
-        explicit AnimationInterface(std::shared_ptr<Model> model, std::vector<uint32_t> animationList);
+        explicit AnimationInterface(std::shared_ptr<Model> model, std::vector<uint64_t> animationList);
 
         void update(float deltaTime);
 
+        // Restarts from the bind pose of the model, after the model was reloaded
+        void refresh();
+
         static void setLuaBindings(sol::table& table);
 
     public:
-        std::vector<uint32_t> animationsList;
+        std::vector<uint64_t> animationsList;
         Animation::Type currentAnimation{Animation::Type::idle};
         std::shared_ptr<Animation> animation;
         std::shared_ptr<Model> model;
         bool reset{};
         bool loop{true};
+        float currentTime{1.0f};
+        LodTier lodTier{LodTier::FULL};
+        float lodAccumulator{};
+        // Pose of this instance, the model nodes keep the bind pose shared by every entity using it
+        std::vector<Model::Node> nodes;
+        std::vector<glm::mat4> palette;
+
+    private:
+        // Samples the channels listed in m_channels, from the baked poses when the clip has them
+        void sample(float time, std::vector<glm::vec4>& values);
+
+        // Samples a pose every reduced step, one step ahead of the clock, and blends to it from the previous one in between
+        void updateReduced(float deltaTime);
+
+    private:
+        AnimationSampler m_sampler;
+        std::vector<uint32_t> m_channels;
+        std::vector<glm::vec4> m_values;
+        // Reduced tier poses, the clip they were sampled from is reset when the tier or the clip changes
+        const Animation* m_reducedClip{};
+        std::vector<glm::vec4> m_reducedFrom;
+        // Keeps the clips resident while the component exists
+        std::vector<ResourceHandle> m_clips;
+        // Clip whose likely successors were requested last
+        Animation::Type m_prefetched{};
     };
 
 } // namespace engine
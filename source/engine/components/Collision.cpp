@@ -4,8 +4,8 @@
 #include "fmt/format.h"
 
 
-engine::Collision::Collision(uint32_t owner, float mass, const glm::vec3& halfSize)
-        : owner(owner), mass(mass), halfSize({halfSize.x, halfSize.y, halfSize.z}) {
+engine::Collision::Collision(uint32_t owner, float mass, const glm::vec3& halfSize, Shape shape)
+        : owner(owner), mass(mass), halfSize({halfSize.x, halfSize.y, halfSize.z}), shape(shape) {
 
 }
 
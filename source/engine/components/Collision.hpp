@@ -13,7 +13,14 @@ namespace engine {
 
     class Collision {
     public:
-        Collision(uint32_t owner, float mass, const glm::vec3& halfSize);
+        // MESH collides with the triangles of the model, static bodies only, moving ones fall back to the box
+        enum class Shape {
+            BOX,
+            MESH
+        };
+
+    public:
+        Collision(uint32_t owner, float mass, const glm::vec3& halfSize, Shape shape = Shape::BOX);
 
         ~Collision();
 
@@ -24,6 +31,7 @@ namespace engine {
         uint32_t owner{};
         btScalar mass{};
         btVector3 halfSize{};
+        Shape shape{Shape::BOX};
         btTransform transform;
     };
 
@@ -1,14 +1,55 @@
 #include "ModelInterface.hpp"
 
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
 #include "../Utilities.hpp"
 #include "../Application.hpp"
 
 
+inline float maxScale(const glm::mat4& matrix) {
+    return std::sqrt(std::max({glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0])), glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1])),
+                               glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]))}));
+}
+
+// Sphere around the box transformed by matrix, the radius follows the largest scale of the matrix
+inline glm::vec4 boundingSphere(const glm::mat4& matrix, const glm::vec3& min, const glm::vec3& max) {
+    glm::vec3 center = glm::vec3(matrix * glm::vec4((min + max) * 0.5f, 1.0f));
+
+    return {center, glm::length(max - min) * 0.5f * maxScale(matrix)};
+}
+
+// Skinned positions are weighted sums of the positions moved by their joints, so they stay inside the box holding the
+// sphere of every joint once moved. Falls back to the bind pose box without joint bounds
+inline void skinnedBox(const engine::Mesh& mesh, const glm::mat4* joints, uint32_t jointCount, glm::vec3& min, glm::vec3& max) {
+    const std::vector<glm::vec4>& bounds = mesh.getJointBounds();
+    min = glm::vec3(std::numeric_limits<float>::max());
+    max = glm::vec3(-std::numeric_limits<float>::max());
+
+    for (uint32_t j = 0; j < std::min(jointCount, static_cast<uint32_t>(bounds.size())); ++j) {
+        if (bounds[j].w < 0.0f) continue;
+
+        glm::vec3 center = glm::vec3(joints[j] * glm::vec4(glm::vec3(bounds[j]), 1.0f));
+        float radius = bounds[j].w * maxScale(joints[j]);
+
+        min = glm::min(min, center - radius);
+        max = glm::max(max, center + radius);
+    }
+
+    if (min.x > max.x) {
+        min = mesh.getBoundsMin();
+        max = mesh.getBoundsMax();
+    }
+}
+
+
 namespace engine {
 
     ModelInterface::ModelInterface(uint64_t modelID, uint32_t entityID)
-            : m_model(engine::Application::m_resourceManager->getModel(modelID)), m_entityID(entityID) {
-
+            : m_model(engine::Application::m_resourceManager->getModel(modelID)), m_handle(ResourceType::MODEL, modelID),
+              m_entityID(entityID) {
+        m_model->buildPalette(m_model->getNodes(), m_bindPalette);
     }
 
     engine::Model::Node &ModelInterface::getNode(uint32_t id) {
@@ -23,35 +64,81 @@ namespace engine {
         return m_model->getName();
     }
 
-    void ModelInterface::render(vk::CommandBuffer& cmdBuffer, const std::shared_ptr<GraphicsPipeline>& pipeAnimation) {
-        auto& transform = Application::m_scene->getComponent<Transform>(m_entityID);
-        Application::m_renderer->m_mvp.model = transform.worldTransformMatrix();
-        cmdBuffer.pushConstants(pipeAnimation->getLayout(), vk::ShaderStageFlagBits::eVertex, 0, sizeof(MVP), &Application::m_renderer->m_mvp);
+    void ModelInterface::render(DrawList& drawList, const std::shared_ptr<GraphicsPipeline>& pipeStatic,
+                                const std::shared_ptr<GraphicsPipeline>& pipeAnimation, const std::vector<glm::mat4>* palette) {
+        // An animation without a pose yet, or posed before the model was reloaded, is drawn in the bind pose
+        const std::vector<glm::mat4>& matrices = palette && palette->size() == m_bindPalette.size() ? *palette : m_bindPalette;
+
+        if (matrices.empty()) return;
+
+        DrawList::Draw draw{
+            .model = Application::m_scene->getComponent<Transform>(m_entityID).worldTransformMatrix()
+        };
+        // Node matrix of the mesh in the palette, its joints follow it
+        uint32_t block = 0;
+
+        for (auto& node : m_model->getNodes()) {
+            if (node.mesh > 0) {
+                auto& mesh = Application::m_resourceManager->getMesh(node.mesh);
+                draw.constants.jointCount = node.skin > -1 ? static_cast<uint32_t>(m_model->getSkin(node.skin).joints.size()) : 0;
+
+                draw.pipeline = mesh.getLayout() == VertexLayout::SKINNED ? pipeAnimation.get() : pipeStatic.get();
+                draw.variant = mesh.getLayout() == VertexLayout::SKINNED && draw.constants.jointCount > 0 ? GraphicsPipeline::VARIANT_SKINNED : 0;
+                draw.mesh = &mesh;
+                auto& texture = Application::m_resourceManager->getTexture(mesh.getTextureId());
+                draw.textureSet = texture.getDescriptorSet();
+                draw.constants.textureIndex = texture.getIndex();
+
+                glm::vec3 min = mesh.getBoundsMin();
+                glm::vec3 max = mesh.getBoundsMax();
+
+                if (draw.variant == GraphicsPipeline::VARIANT_SKINNED) skinnedBox(mesh, &matrices[block + 1], draw.constants.jointCount, min, max);
+
+                draw.bounds = boundingSphere(draw.model * matrices[block], min, max);
+                drawList.add(draw, &matrices[block]);
+
+                block += 1 + draw.constants.jointCount;
+            }
+        }
+    }
+
+    glm::vec4 ModelInterface::getBoundingSphere(const std::vector<glm::mat4>* palette) {
+        const std::vector<glm::mat4>& matrices = palette && palette->size() == m_bindPalette.size() ? *palette : m_bindPalette;
+        glm::mat4 model = Application::m_scene->getComponent<Transform>(m_entityID).worldTransformMatrix();
+        glm::vec3 min(std::numeric_limits<float>::max());
+        glm::vec3 max(-std::numeric_limits<float>::max());
+        uint32_t block = 0;
 
         for (auto& node : m_model->getNodes()) {
             if (node.mesh > 0) {
                 auto& mesh = Application::m_resourceManager->getMesh(node.mesh);
+                uint32_t jointCount = node.skin > -1 ? static_cast<uint32_t>(m_model->getSkin(node.skin).joints.size()) : 0;
+                glm::vec3 meshMin = mesh.getBoundsMin();
+                glm::vec3 meshMax = mesh.getBoundsMax();
 
-                vk::Buffer vertexBuffer[] = {mesh.getVertexBuffer()};
-                vk::DeviceSize offsets[] = {0};
-                cmdBuffer.bindVertexBuffers(0, 1, vertexBuffer, offsets);
-                cmdBuffer.bindIndexBuffer(mesh.getIndexBuffer(), 0, vk::IndexType::eUint32);
+                if (mesh.getLayout() == VertexLayout::SKINNED && jointCount > 0) skinnedBox(mesh, &matrices[block + 1], jointCount, meshMin, meshMax);
 
-                std::vector<vk::DescriptorSet> descriptorGroup =  {
-                    Application::m_resourceManager->getTexture(mesh.getTextureId()).getDescriptorSet(),
-                    mesh.m_uniformBuffer.m_descriptorSet
-                };
+                glm::vec4 sphere = boundingSphere(model * matrices[block], meshMin, meshMax);
+                min = glm::min(min, glm::vec3(sphere) - sphere.w);
+                max = glm::max(max, glm::vec3(sphere) + sphere.w);
 
-                cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeAnimation->getLayout(), 1,
-                                             static_cast<uint32_t>(descriptorGroup.size()), descriptorGroup.data(),
-                                             0, nullptr);
-                cmdBuffer.drawIndexed(mesh.getIndexCount(), 1, 0, 0, 0);
+                block += 1 + jointCount;
             }
         }
+
+        if (min.x > max.x) return {glm::vec3(model[3]), 0.0f};
+
+        return {(min + max) * 0.5f, glm::length(max - min) * 0.5f};
     }
 
     void ModelInterface::setModel(uint64_t modelID) {
         m_model = engine::Application::m_resourceManager->getModel(modelID);
+        m_handle = ResourceHandle(ResourceType::MODEL, modelID);
+        m_model->buildPalette(m_model->getNodes(), m_bindPalette);
+    }
+
+    void ModelInterface::refresh() {
+        m_model->buildPalette(m_model->getNodes(), m_bindPalette);
     }
 
     void ModelInterface::setLuaBindings(sol::table &table) {
@@ -10,6 +10,8 @@
 
 #include "Transform.hpp"
 #include "../resources/Model.hpp"
+#include "../resources/ResourceHandle.hpp"
+#include "../renderer/DrawList.hpp"
 #include "../renderer/GraphicsPipeline.hpp"
 
 
@@ -27,10 +29,19 @@ namespace engine {
 
         std::string& getName();
 
-        void render(vk::CommandBuffer& cmdBuffer, const std::shared_ptr<GraphicsPipeline>& pipeAnimation);
+        // Without a palette the model is drawn in its bind pose. Each mesh is drawn with the pipeline of its vertex layout,
+        // both pipelines share the same pipeline layout. The matrices of the palette are copied into the draw list.
+        void render(DrawList& drawList, const std::shared_ptr<GraphicsPipeline>& pipeStatic,
+                    const std::shared_ptr<GraphicsPipeline>& pipeAnimation, const std::vector<glm::mat4>* palette = nullptr);
+
+        // World space sphere around every mesh of the model, posed by the palette or in the bind pose without one
+        [[nodiscard]] glm::vec4 getBoundingSphere(const std::vector<glm::mat4>* palette = nullptr);
 
         void setModel(uint64_t modelID);
 
+        // Rebuilds the bind pose palette, after the model was reloaded
+        void refresh();
+
         uint32_t getRootNode();
 
         std::shared_ptr<Model> getHandle();
@@ -39,7 +50,9 @@ namespace engine {
 
     private:
         std::shared_ptr<engine::Model> m_model;
+        ResourceHandle m_handle;
         uint32_t m_entityID;
+        std::vector<glm::mat4> m_bindPalette;
     };
 
 } // namespace core
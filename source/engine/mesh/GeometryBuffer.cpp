@@ -0,0 +1,146 @@
+#include "GeometryBuffer.hpp"
+
+#include <bit>
+#include <algorithm>
+
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+#include "../Constants.hpp"
+
+
+// Smallest range handed out, small meshes waste at most this many elements
+const uint32_t GEOMETRY_MIN_BLOCK_ELEMENTS = 64;
+
+namespace engine {
+
+    GeometryBuffer::GeometryBuffer() = default;
+
+    GeometryBuffer::~GeometryBuffer() = default;
+
+    void GeometryBuffer::create(const std::shared_ptr<Device>& device, vk::BufferUsageFlags usage, uint32_t elementSize,
+                                uint32_t pageElements) {
+        m_device = device;
+        m_usage = usage | vk::BufferUsageFlagBits::eTransferDst;
+        m_elementSize = elementSize;
+        m_pageElements = std::bit_ceil(pageElements);
+    }
+
+    void GeometryBuffer::cleanup() {
+        for (auto& page : m_pages) page.buffer.destroy();
+
+        m_pages.clear();
+    }
+
+    GeometryBuffer::Range GeometryBuffer::allocate(uint32_t count) {
+        Range range{.count = count};
+        uint64_t offset;
+
+        for (uint32_t page = 0; page < m_pages.size(); ++page) {
+            if (m_pages[page].allocator->allocate(count, 1, offset)) {
+                range.page = page;
+                range.first = static_cast<uint32_t>(offset);
+
+                return range;
+            }
+        }
+
+        // Meshes larger than a page get a page of their own
+        addPage(std::max(m_pageElements, std::bit_ceil(std::max(count, GEOMETRY_MIN_BLOCK_ELEMENTS))));
+
+        if (!m_pages.back().allocator->allocate(count, 1, offset)) {
+            throw std::runtime_error(fmt::format("Failed to allocate {} elements in a new geometry page", count));
+        }
+
+        range.page = static_cast<uint32_t>(m_pages.size() - 1);
+        range.first = static_cast<uint32_t>(offset);
+
+        return range;
+    }
+
+    void GeometryBuffer::free(const Range& range) {
+        if (range.count == 0 || range.page >= m_pages.size()) return;
+
+        m_pages[range.page].allocator->free(range.first);
+    }
+
+    void GeometryBuffer::upload(const Range& range, const void* data, UploadBatch& uploads) const {
+        if (range.count == 0) return;
+
+        uploads.uploadBuffer(data, static_cast<vk::DeviceSize>(range.count) * m_elementSize, m_pages[range.page].buffer,
+                             static_cast<vk::DeviceSize>(range.first) * m_elementSize);
+    }
+
+    vk::Buffer GeometryBuffer::getBuffer(uint32_t page) const {
+        return m_pages[page].buffer.m_buffer;
+    }
+
+    uint32_t GeometryBuffer::getPageCount() const {
+        return static_cast<uint32_t>(m_pages.size());
+    }
+
+    vk::DeviceSize GeometryBuffer::getReservedSize() const {
+        vk::DeviceSize size = 0;
+
+        for (auto& page : m_pages) size += page.allocator->getSize() * m_elementSize;
+
+        return size;
+    }
+
+    vk::DeviceSize GeometryBuffer::getUsedSize() const {
+        vk::DeviceSize size = 0;
+
+        for (auto& page : m_pages) size += page.allocator->getUsed() * m_elementSize;
+
+        return size;
+    }
+
+    void GeometryBuffer::addPage(uint32_t elements) {
+        Page page;
+        page.buffer = m_device->createBuffer(m_usage, vk::MemoryPropertyFlagBits::eDeviceLocal,
+                                             static_cast<vk::DeviceSize>(elements) * m_elementSize);
+        page.allocator = std::make_unique<BuddyAllocator>(elements, GEOMETRY_MIN_BLOCK_ELEMENTS);
+
+        m_pages.push_back(std::move(page));
+    }
+
+    GeometryPool::GeometryPool() = default;
+
+    GeometryPool::~GeometryPool() = default;
+
+    void GeometryPool::create(const std::shared_ptr<Device>& device) {
+        m_staticVertices.create(device, vk::BufferUsageFlagBits::eVertexBuffer, getVertexSize(VertexLayout::STATIC), GEOMETRY_PAGE_VERTICES);
+        m_skinnedVertices.create(device, vk::BufferUsageFlagBits::eVertexBuffer, getVertexSize(VertexLayout::SKINNED), GEOMETRY_PAGE_VERTICES);
+        m_indices16.create(device, vk::BufferUsageFlagBits::eIndexBuffer, sizeof(uint16_t), GEOMETRY_PAGE_INDICES);
+        m_indices32.create(device, vk::BufferUsageFlagBits::eIndexBuffer, sizeof(uint32_t), GEOMETRY_PAGE_INDICES);
+    }
+
+    void GeometryPool::cleanup() {
+        m_staticVertices.cleanup();
+        m_skinnedVertices.cleanup();
+        m_indices16.cleanup();
+        m_indices32.cleanup();
+    }
+
+    GeometryBuffer& GeometryPool::getVertices(VertexLayout layout) {
+        return layout == VertexLayout::SKINNED ? m_skinnedVertices : m_staticVertices;
+    }
+
+    GeometryBuffer& GeometryPool::getIndices(vk::IndexType type) {
+        return type == vk::IndexType::eUint16 ? m_indices16 : m_indices32;
+    }
+
+    void GeometryPool::logStats() const {
+        auto log = [](const char* name, const GeometryBuffer& buffer) {
+            spdlog::info("[Geometry] {}: {} pages, {:.2f} / {:.2f} MB", name, buffer.getPageCount(),
+                         static_cast<float>(buffer.getUsedSize()) / (1024.0f * 1024.0f),
+                         static_cast<float>(buffer.getReservedSize()) / (1024.0f * 1024.0f));
+        };
+
+        log("Static vertices", m_staticVertices);
+        log("Skinned vertices", m_skinnedVertices);
+        log("16 bit indices", m_indices16);
+        log("32 bit indices", m_indices32);
+    }
+
+} // namespace engine
@@ -0,0 +1,99 @@
+#ifndef PROTOTYPE_ACTION_RPG_GEOMETRYBUFFER_HPP
+#define PROTOTYPE_ACTION_RPG_GEOMETRYBUFFER_HPP
+
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include "vulkan/vulkan.hpp"
+
+#include "Vertex.hpp"
+#include "../renderer/Buffer.hpp"
+#include "../renderer/Device.hpp"
+#include "../renderer/UploadBatch.hpp"
+#include "../renderer/MemoryAllocator.hpp"
+
+
+namespace engine {
+
+    // Device local buffers of fixed size elements shared by every mesh. Ranges are buddy allocated in elements rather
+    // than bytes, so their first element is directly the vertexOffset or firstIndex of a draw. A page is added when the
+    // existing ones are full
+    class GeometryBuffer {
+    public:
+        struct Range {
+            uint32_t page{};
+            uint32_t first{};
+            uint32_t count{};
+        };
+
+    public:
+        GeometryBuffer();
+
+        ~GeometryBuffer();
+
+        void create(const std::shared_ptr<Device>& device, vk::BufferUsageFlags usage, uint32_t elementSize, uint32_t pageElements);
+
+        void cleanup();
+
+        Range allocate(uint32_t count);
+
+        void free(const Range& range);
+
+        void upload(const Range& range, const void* data, UploadBatch& uploads) const;
+
+        [[nodiscard]] vk::Buffer getBuffer(uint32_t page) const;
+
+        [[nodiscard]] uint32_t getPageCount() const;
+
+        [[nodiscard]] vk::DeviceSize getReservedSize() const;
+
+        [[nodiscard]] vk::DeviceSize getUsedSize() const;
+
+    private:
+        struct Page {
+            Buffer buffer;
+            std::unique_ptr<BuddyAllocator> allocator;
+        };
+
+    private:
+        void addPage(uint32_t elements);
+
+    private:
+        std::shared_ptr<Device> m_device;
+        vk::BufferUsageFlags m_usage{};
+        uint32_t m_elementSize{};
+        uint32_t m_pageElements{};
+        std::vector<Page> m_pages;
+    };
+
+    // One vertex buffer per layout and one index buffer per index type, the strides and index sizes never mix in a page
+    class GeometryPool {
+    public:
+        GeometryPool();
+
+        ~GeometryPool();
+
+        void create(const std::shared_ptr<Device>& device);
+
+        void cleanup();
+
+        GeometryBuffer& getVertices(VertexLayout layout);
+
+        GeometryBuffer& getIndices(vk::IndexType type);
+
+        void logStats() const;
+
+    private:
+        GeometryBuffer m_staticVertices;
+        GeometryBuffer m_skinnedVertices;
+        GeometryBuffer m_indices16;
+        GeometryBuffer m_indices32;
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_GEOMETRYBUFFER_HPP
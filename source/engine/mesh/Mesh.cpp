@@ -1,92 +1,234 @@
 #include "Mesh.hpp"
 
+#include <limits>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+
 #include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+#include "MeshOptimizer.hpp"
 
 
 namespace engine {
 
+    std::shared_ptr<const MeshData> MeshData::create(const void* vertices, VertexLayout layout, uint32_t vertexCount,
+                                                     const void* indices, uint32_t indexSize, uint32_t indexCount,
+                                                     MeshResidency residency) {
+        if (residency == MeshResidency::GPU_ONLY) return nullptr;
+
+        auto data = std::make_shared<MeshData>();
+        auto* bytes = static_cast<const uint8_t*>(vertices);
+        uint32_t stride = getVertexSize(layout);
+
+        data->residency = residency;
+        data->positions.resize(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v) std::memcpy(&data->positions[v], bytes + v * stride, sizeof(glm::vec3));
+
+        data->indices.resize(indexCount);
+        if (indexSize == sizeof(uint16_t)) {
+            auto* indices16 = static_cast<const uint16_t*>(indices);
+            for (uint32_t i = 0; i < indexCount; ++i) data->indices[i] = indices16[i];
+        } else {
+            std::memcpy(data->indices.data(), indices, indexCount * sizeof(uint32_t));
+        }
+
+        if (residency == MeshResidency::FULL) data->vertices.assign(bytes, bytes + static_cast<size_t>(vertexCount) * stride);
+
+        return data;
+    }
+
+    uint64_t MeshData::getMemorySize() const {
+        return positions.size() * sizeof(glm::vec3) + indices.size() * sizeof(uint32_t) + vertices.size();
+    }
+
     Mesh::Mesh() = default;
 
-    Mesh::Mesh(const std::vector<engine::Vertex>& vertices, const std::vector<uint32_t>& indices,
-               vk::Queue transferQueue, uint64_t textureID, const std::shared_ptr<engine::Device>& device)
-            : vertices(vertices), indices(indices), m_textureID(textureID) {
-        createVertexBuffer(vertices, transferQueue, device);
-        createIndexBuffer(indices, transferQueue, device);
+    Mesh::Mesh(const std::vector<engine::Vertex>& vertices, const std::vector<uint32_t>& indices, VertexLayout layout,
+               UploadBatch& uploads, uint64_t textureID, GeometryPool& geometry, MeshResidency residency)
+            : m_geometry(&geometry), m_textureID(textureID), m_layout(layout), m_vertexCount(static_cast<uint32_t>(vertices.size())),
+              m_indexCount(static_cast<uint32_t>(indices.size())) {
+        std::vector<uint8_t> packedVertices;
+        std::vector<uint8_t> packedIndices;
+
+        if (!packVertices(vertices.data(), vertices.size(), layout, packedVertices)) {
+            spdlog::error("[Mesh] Joint indices above 255 do not fit in the skinned vertex layout");
+        }
+
+        createVertexBuffer(packedVertices.data(), uploads);
+        computeBounds(packedVertices.data());
 
-        vk::DeviceSize size = sizeof(m_uniformBlock);
-        m_uniformBuffer = device->createBuffer(vk::BufferUsageFlagBits::eUniformBuffer,
-                                               vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                                               size);
-        m_uniformBuffer.map(size);
-        m_uniformBuffer.setupDescriptor(size);
+        uint32_t indexSize = MeshOptimizer::getIndexSize(m_vertexCount);
+        m_indexType = indexSize == sizeof(uint16_t) ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+
+        MeshOptimizer::packIndices(indices, indexSize, packedIndices);
+        createIndexBuffer(packedIndices.data(), uploads);
+
+        m_data = MeshData::create(packedVertices.data(), layout, m_vertexCount, packedIndices.data(), indexSize, m_indexCount, residency);
+    }
+
+    Mesh::Mesh(const void* vertices, VertexLayout layout, uint32_t vertexCount, const void* indices, uint32_t indexSize,
+               uint32_t indexCount, UploadBatch& uploads, uint64_t textureID, GeometryPool& geometry, MeshResidency residency)
+            : m_geometry(&geometry), m_textureID(textureID), m_layout(layout), m_vertexCount(vertexCount), m_indexCount(indexCount),
+              m_indexType(indexSize == sizeof(uint16_t) ? vk::IndexType::eUint16 : vk::IndexType::eUint32),
+              m_data(MeshData::create(vertices, layout, vertexCount, indices, indexSize, indexCount, residency)) {
+        createVertexBuffer(vertices, uploads);
+        createIndexBuffer(indices, uploads);
+        computeBounds(vertices);
     }
 
     Mesh::~Mesh() = default;
 
     int Mesh::getVertexCount() const {
-        return static_cast<int>(vertices.size());
+        return static_cast<int>(m_vertexCount);
     }
 
     vk::Buffer Mesh::getVertexBuffer() const {
-        return m_vertexBuffer.m_buffer;
+        return m_geometry->getVertices(m_layout).getBuffer(m_vertices.page);
+    }
+
+    uint32_t Mesh::getVertexPage() const {
+        return m_vertices.page;
+    }
+
+    int32_t Mesh::getVertexOffset() const {
+        return static_cast<int32_t>(m_vertices.first);
     }
 
     int Mesh::getIndexCount() const {
-        return static_cast<int>(indices.size());
+        return static_cast<int>(m_indexCount);
     }
 
     vk::Buffer Mesh::getIndexBuffer() const {
-        return m_indexBuffer.m_buffer;
+        return m_geometry->getIndices(m_indexType).getBuffer(m_indices.page);
+    }
+
+    uint32_t Mesh::getIndexPage() const {
+        return m_indices.page;
+    }
+
+    uint32_t Mesh::getFirstIndex() const {
+        return m_indices.first;
+    }
+
+    vk::IndexType Mesh::getIndexType() const {
+        return m_indexType;
     }
 
     void Mesh::cleanup() {
-        m_uniformBuffer.destroy();
-        m_indexBuffer.destroy();
-        m_vertexBuffer.destroy();
+        m_data.reset();
+
+        if (!m_geometry) return;
+
+        m_geometry->getIndices(m_indexType).free(m_indices);
+        m_geometry->getVertices(m_layout).free(m_vertices);
+        m_geometry = nullptr;
     }
 
     uint64_t Mesh::getTextureId() const {
         return m_textureID;
     }
 
-    void Mesh::createVertexBuffer(const std::vector<engine::Vertex> &vertices, vk::Queue transferQueue, const std::shared_ptr<engine::Device>& device) {
-        vk::DeviceSize size = sizeof(engine::Vertex) * vertices.size();
-        engine::Buffer stagingBuffer;
+    VertexLayout Mesh::getLayout() const {
+        return m_layout;
+    }
 
-        stagingBuffer = device->createBuffer(vk::BufferUsageFlagBits::eTransferSrc,
-                             vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                             size, (void*)vertices.data());
+    vk::DeviceSize Mesh::getVertexBufferSize() const {
+        return static_cast<vk::DeviceSize>(getVertexSize(m_layout)) * m_vertexCount;
+    }
 
-        m_vertexBuffer = device->createBuffer(vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst,
-                             vk::MemoryPropertyFlagBits::eDeviceLocal, size);
+    vk::DeviceSize Mesh::getIndexBufferSize() const {
+        return static_cast<vk::DeviceSize>(m_indexType == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t)) * m_indexCount;
+    }
 
-        device->copyBuffer(&stagingBuffer, &m_vertexBuffer, transferQueue);
+    MeshResidency Mesh::getResidency() const {
+        return m_data ? m_data->residency : MeshResidency::GPU_ONLY;
+    }
 
-        stagingBuffer.destroy();
+    std::shared_ptr<const MeshData> Mesh::getData() const {
+        return m_data;
     }
 
-    void Mesh::createIndexBuffer(const std::vector<uint32_t> &indices, vk::Queue transferQueue, const std::shared_ptr<engine::Device>& device) {
-        vk::DeviceSize size = sizeof(uint32_t) * indices.size();
-        engine::Buffer stagingBuffer;
+    void Mesh::setData(std::shared_ptr<const MeshData> data) {
+        m_data = std::move(data);
+    }
+
+    const glm::vec3& Mesh::getBoundsMin() const {
+        return m_boundsMin;
+    }
 
-        stagingBuffer = device->createBuffer(vk::BufferUsageFlagBits::eTransferSrc,
-                             vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                             size, (void*)indices.data());
+    const glm::vec3& Mesh::getBoundsMax() const {
+        return m_boundsMax;
+    }
+
+    const std::vector<glm::vec4>& Mesh::getJointBounds() const {
+        return m_jointBounds;
+    }
 
-        m_indexBuffer = device->createBuffer(vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst,
-                             vk::MemoryPropertyFlagBits::eDeviceLocal, size);
+    void Mesh::computeBounds(const void* vertices) {
+        auto* bytes = static_cast<const uint8_t*>(vertices);
+        uint32_t stride = getVertexSize(m_layout);
+        bool skinned = m_layout == VertexLayout::SKINNED;
 
-        device->copyBuffer(&stagingBuffer, &m_indexBuffer, transferQueue);
+        constexpr float maxFloat = std::numeric_limits<float>::max();
+        m_boundsMin = glm::vec3(maxFloat);
+        m_boundsMax = glm::vec3(-maxFloat);
 
-        stagingBuffer.destroy();
+        // Boxes per joint index, turned into spheres once every vertex is read
+        std::vector<std::pair<glm::vec3, glm::vec3>> jointBoxes;
+
+        for (uint32_t v = 0; v < m_vertexCount; ++v) {
+            const uint8_t* vertex = bytes + static_cast<size_t>(v) * stride;
+            glm::vec3 position;
+            std::memcpy(&position, vertex, sizeof(glm::vec3));
+
+            m_boundsMin = glm::min(m_boundsMin, position);
+            m_boundsMax = glm::max(m_boundsMax, position);
+
+            if (!skinned) continue;
+
+            uint8_t joints[4];
+            uint16_t weights[4];
+            std::memcpy(joints, vertex + offsetof(SkinnedVertex, joints), sizeof(joints));
+            std::memcpy(weights, vertex + offsetof(SkinnedVertex, weights), sizeof(weights));
+
+            for (int i = 0; i < 4; ++i) {
+                if (weights[i] == 0) continue;
+
+                if (joints[i] >= jointBoxes.size()) jointBoxes.resize(joints[i] + 1, {glm::vec3(maxFloat), glm::vec3(-maxFloat)});
+
+                jointBoxes[joints[i]].first = glm::min(jointBoxes[joints[i]].first, position);
+                jointBoxes[joints[i]].second = glm::max(jointBoxes[joints[i]].second, position);
+            }
+        }
+
+        if (m_vertexCount == 0) m_boundsMin = m_boundsMax = glm::vec3(0.0f);
+
+        m_jointBounds.clear();
+        m_jointBounds.reserve(jointBoxes.size());
+
+        for (auto& box : jointBoxes) {
+            if (box.first.x > box.second.x) {
+                m_jointBounds.emplace_back(0.0f, 0.0f, 0.0f, -1.0f);
+            } else {
+                m_jointBounds.emplace_back((box.first + box.second) * 0.5f, glm::length(box.second - box.first) * 0.5f);
+            }
+        }
     }
 
-    const std::vector<Vertex> &Mesh::getVertices() const {
-        return vertices;
+    void Mesh::createVertexBuffer(const void* vertices, UploadBatch& uploads) {
+        GeometryBuffer& buffer = m_geometry->getVertices(m_layout);
+
+        m_vertices = buffer.allocate(m_vertexCount);
+        buffer.upload(m_vertices, vertices, uploads);
     }
 
-    const std::vector<uint32_t> &Mesh::getIndices() const {
-        return indices;
+    void Mesh::createIndexBuffer(const void* indices, UploadBatch& uploads) {
+        GeometryBuffer& buffer = m_geometry->getIndices(m_indexType);
+
+        m_indices = buffer.allocate(m_indexCount);
+        buffer.upload(m_indices, indices, uploads);
     }
 
 } // namespace core
@@ -8,27 +8,47 @@
 #include "glm/glm.hpp"
 
 #include "Vertex.hpp"
-#include "../renderer/Buffer.hpp"
-#include "../renderer/Device.hpp"
-
-#define MAX_NUM_JOINTS 128u
+#include "GeometryBuffer.hpp"
+#include "../renderer/UploadBatch.hpp"
 
 
 namespace engine {
 
-    class Mesh {
-    public:
-        struct UniformBlock {
-            glm::mat4 matrix{1.0f};
-            glm::mat4 jointMatrix[MAX_NUM_JOINTS]{};
-            float jointCount{0};
-        };
+    // What a mesh keeps in system memory once its upload is recorded, ordered from the least to the most
+    enum class MeshResidency : uint32_t {
+        GPU_ONLY,
+        // Positions and 32 bit indices, enough for collision shapes and ray casts
+        POSITIONS,
+        // Positions, indices and the vertices packed as they were uploaded
+        FULL
+    };
+
+    struct MeshData {
+        MeshResidency residency{MeshResidency::GPU_ONLY};
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        std::vector<uint8_t> vertices;
+
+        // Positions are read from the start of each packed vertex, every layout begins with them
+        static std::shared_ptr<const MeshData> create(const void* vertices, VertexLayout layout, uint32_t vertexCount,
+                                                      const void* indices, uint32_t indexSize, uint32_t indexCount,
+                                                      MeshResidency residency);
 
+        [[nodiscard]] uint64_t getMemorySize() const;
+    };
+
+    class Mesh {
     public:
         Mesh();
 
-        Mesh(const std::vector<engine::Vertex>& vertices, const std::vector<uint32_t>& indices,
-             vk::Queue transferQueue, uint64_t textureID, const std::shared_ptr<engine::Device>& device);
+        // Vertices are packed in the given layout and indices in 16 bits when they fit before the upload
+        Mesh(const std::vector<engine::Vertex>& vertices, const std::vector<uint32_t>& indices, VertexLayout layout,
+             UploadBatch& uploads, uint64_t textureID, GeometryPool& geometry, MeshResidency residency = MeshResidency::GPU_ONLY);
+
+        // Vertices already packed in the layout and indices of indexSize bytes, the data is only read while the upload is recorded
+        Mesh(const void* vertices, VertexLayout layout, uint32_t vertexCount, const void* indices, uint32_t indexSize,
+             uint32_t indexCount, UploadBatch& uploads, uint64_t textureID, GeometryPool& geometry,
+             MeshResidency residency = MeshResidency::GPU_ONLY);
 
         ~Mesh();
 
@@ -36,33 +56,69 @@ namespace engine {
 
         [[nodiscard]] vk::Buffer getVertexBuffer() const;
 
+        [[nodiscard]] uint32_t getVertexPage() const;
+
+        // vertexOffset of the draw, in vertices from the start of the page
+        [[nodiscard]] int32_t getVertexOffset() const;
+
         void cleanup();
 
         [[nodiscard]] int getIndexCount() const;
 
         [[nodiscard]] vk::Buffer getIndexBuffer() const;
 
+        [[nodiscard]] uint32_t getIndexPage() const;
+
+        // firstIndex of the draw, in indices from the start of the page
+        [[nodiscard]] uint32_t getFirstIndex() const;
+
+        [[nodiscard]] vk::IndexType getIndexType() const;
+
         [[nodiscard]] uint64_t getTextureId() const;
 
-        const std::vector<Vertex> &getVertices() const;
+        [[nodiscard]] VertexLayout getLayout() const;
+
+        [[nodiscard]] vk::DeviceSize getVertexBufferSize() const;
+
+        [[nodiscard]] vk::DeviceSize getIndexBufferSize() const;
+
+        [[nodiscard]] MeshResidency getResidency() const;
 
-        const std::vector<uint32_t> &getIndices() const;
+        // nullptr for GPU only meshes, copies of the mesh share the same data
+        [[nodiscard]] std::shared_ptr<const MeshData> getData() const;
+
+        void setData(std::shared_ptr<const MeshData> data);
+
+        // Box of the bind pose positions in mesh space
+        [[nodiscard]] const glm::vec3& getBoundsMin() const;
+
+        [[nodiscard]] const glm::vec3& getBoundsMax() const;
+
+        // Skinned layout only: sphere around the positions weighted by each joint of the skin, before skinning. The radius
+        // is negative for the joints weighting no vertex
+        [[nodiscard]] const std::vector<glm::vec4>& getJointBounds() const;
 
     private:
-        void createVertexBuffer(const std::vector<engine::Vertex>& vertices, vk::Queue transferQueue, const std::shared_ptr<engine::Device>& device);
+        void computeBounds(const void* vertices);
 
-        void createIndexBuffer(const std::vector<uint32_t>& indices, vk::Queue transferQueue, const std::shared_ptr<engine::Device>& device);
+        void createVertexBuffer(const void* vertices, UploadBatch& uploads);
 
-    public:
-        Buffer m_uniformBuffer;
-        UniformBlock m_uniformBlock;
+        void createIndexBuffer(const void* indices, UploadBatch& uploads);
 
     private:
-        engine::Buffer m_vertexBuffer;
-        engine::Buffer m_indexBuffer;
+        // Ranges of the shared buffers, the pool outlives every mesh
+        GeometryPool* m_geometry{};
+        GeometryBuffer::Range m_vertices{};
+        GeometryBuffer::Range m_indices{};
         uint64_t m_textureID{};
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
+        VertexLayout m_layout{VertexLayout::STATIC};
+        uint32_t m_vertexCount{};
+        uint32_t m_indexCount{};
+        vk::IndexType m_indexType{vk::IndexType::eUint32};
+        std::shared_ptr<const MeshData> m_data;
+        glm::vec3 m_boundsMin{0.0f};
+        glm::vec3 m_boundsMax{0.0f};
+        std::vector<glm::vec4> m_jointBounds;
     };
 
 } // namespace core
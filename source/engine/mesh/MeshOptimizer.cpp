@@ -0,0 +1,257 @@
+#include "MeshOptimizer.hpp"
+
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+
+const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+inline float vertexScore(int32_t cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+
+    if (cachePosition >= 0) {
+        // The three vertices of the last triangle get a fixed score so the next triangle does not favour one of its edges
+        if (cachePosition < 3) {
+            score = FORSYTH_LAST_TRIANGLE_SCORE;
+        } else {
+            float scaler = 1.0f / (engine::MeshOptimizer::FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+        }
+    }
+
+    // Vertices with few triangles left are finished first so they leave the cache for good
+    return score + FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -FORSYTH_VALENCE_BOOST_POWER);
+}
+
+struct VertexHash {
+    size_t operator()(const engine::Vertex& vertex) const {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&vertex);
+        uint64_t hash = 14695981039346656037ull;
+
+        for (size_t i = 0; i < sizeof(engine::Vertex); ++i) hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+        return static_cast<size_t>(hash);
+    }
+};
+
+struct VertexEqual {
+    bool operator()(const engine::Vertex& a, const engine::Vertex& b) const {
+        return std::memcmp(&a, &b, sizeof(engine::Vertex)) == 0;
+    }
+};
+
+namespace engine {
+
+    MeshOptimizer::Stats MeshOptimizer::optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        Stats stats{};
+        stats.verticesBefore = static_cast<uint32_t>(vertices.size());
+        stats.triangles = static_cast<uint32_t>(indices.size() / 3);
+
+        if (stats.triangles == 0 || indices.size() % 3 != 0) {
+            stats.verticesAfter = stats.verticesBefore;
+
+            return stats;
+        }
+
+        uint32_t transformed = simulateCache(indices, stats.verticesBefore, STATS_CACHE_SIZE);
+        stats.acmrBefore = static_cast<float>(transformed) / stats.triangles;
+        stats.atvrBefore = static_cast<float>(transformed) / std::max(stats.verticesBefore, 1u);
+
+        weld(vertices, indices);
+        optimizeVertexCache(indices, static_cast<uint32_t>(vertices.size()));
+        optimizeVertexFetch(vertices, indices);
+
+        stats.verticesAfter = static_cast<uint32_t>(vertices.size());
+        transformed = simulateCache(indices, stats.verticesAfter, STATS_CACHE_SIZE);
+        stats.acmrAfter = static_cast<float>(transformed) / stats.triangles;
+        stats.atvrAfter = static_cast<float>(transformed) / std::max(stats.verticesAfter, 1u);
+
+        return stats;
+    }
+
+    void MeshOptimizer::weld(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> unique;
+        std::vector<uint32_t> remap(vertices.size());
+        std::vector<Vertex> welded;
+
+        unique.reserve(vertices.size());
+        welded.reserve(vertices.size());
+
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            auto [it, inserted] = unique.try_emplace(vertices[i], static_cast<uint32_t>(welded.size()));
+
+            if (inserted) welded.push_back(vertices[i]);
+
+            remap[i] = it->second;
+        }
+
+        for (auto& index : indices) index = remap[index];
+
+        vertices = std::move(welded);
+    }
+
+    void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount) {
+        auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+        if (triangleCount == 0) return;
+
+        // Triangles of every vertex, the live ones are kept at the front of each range
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (uint32_t index : indices) ++remaining[index];
+
+        std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+        for (uint32_t v = 0; v < vertexCount; ++v) firstTriangle[v + 1] = firstTriangle[v] + remaining[v];
+
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<uint32_t> filled(vertexCount, 0);
+        for (uint32_t t = 0; t < triangleCount; ++t) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                uint32_t v = indices[t * 3 + c];
+                adjacency[firstTriangle[v] + filled[v]++] = t;
+            }
+        }
+
+        std::vector<int32_t> cachePosition(vertexCount, -1);
+        std::vector<float> scores(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v) scores[v] = vertexScore(-1, remaining[v]);
+
+        std::vector<float> triangleScores(triangleCount);
+        for (uint32_t t = 0; t < triangleCount; ++t) {
+            triangleScores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+        }
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> nextCache;
+        cache.reserve(FORSYTH_CACHE_SIZE + 3);
+        nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+        uint32_t cursor = 0;
+        auto best = static_cast<uint32_t>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+
+        while (best != UINT32_MAX) {
+            emitted[best] = true;
+            const uint32_t* triangle = &indices[best * 3];
+
+            nextCache.assign(triangle, triangle + 3);
+
+            for (uint32_t c = 0; c < 3; ++c) {
+                uint32_t v = triangle[c];
+                output.push_back(v);
+
+                // Drop the triangle from the live triangles of its vertices
+                uint32_t* begin = &adjacency[firstTriangle[v]];
+                uint32_t* last = begin + remaining[v] - 1;
+                std::iter_swap(std::find(begin, last + 1, best), last);
+                --remaining[v];
+            }
+
+            for (uint32_t v : cache) {
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2]) nextCache.push_back(v);
+            }
+
+            // Vertices pushed out of the cache lose their position score
+            for (size_t i = FORSYTH_CACHE_SIZE; i < nextCache.size(); ++i) {
+                cachePosition[nextCache[i]] = -1;
+                scores[nextCache[i]] = vertexScore(-1, remaining[nextCache[i]]);
+            }
+
+            if (nextCache.size() > FORSYTH_CACHE_SIZE) nextCache.resize(FORSYTH_CACHE_SIZE);
+
+            std::swap(cache, nextCache);
+
+            for (size_t i = 0; i < cache.size(); ++i) {
+                cachePosition[cache[i]] = static_cast<int32_t>(i);
+                scores[cache[i]] = vertexScore(static_cast<int32_t>(i), remaining[cache[i]]);
+            }
+
+            // Only the triangles touching the cache changed, the best one of them is emitted next
+            best = UINT32_MAX;
+            float bestScore = 0.0f;
+
+            for (uint32_t v : cache) {
+                for (uint32_t i = 0; i < remaining[v]; ++i) {
+                    uint32_t t = adjacency[firstTriangle[v] + i];
+                    triangleScores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+
+                    if (triangleScores[t] > bestScore) {
+                        bestScore = triangleScores[t];
+                        best = t;
+                    }
+                }
+            }
+
+            // Nothing left around the cache, continue with the next triangle in input order
+            if (best == UINT32_MAX) {
+                while (cursor < triangleCount && emitted[cursor]) ++cursor;
+
+                if (cursor < triangleCount) best = cursor;
+            }
+        }
+
+        indices = std::move(output);
+    }
+
+    void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+        std::vector<Vertex> ordered;
+        ordered.reserve(vertices.size());
+
+        for (auto& index : indices) {
+            if (remap[index] == UINT32_MAX) {
+                remap[index] = static_cast<uint32_t>(ordered.size());
+                ordered.push_back(vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        vertices = std::move(ordered);
+    }
+
+    uint32_t MeshOptimizer::simulateCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize) {
+        // Timestamp of the moment each vertex entered the FIFO
+        std::vector<uint32_t> entered(vertexCount, 0);
+        uint32_t transformed = 0;
+
+        for (uint32_t index : indices) {
+            if (entered[index] == 0 || transformed - entered[index] + 1 > cacheSize) {
+                ++transformed;
+                entered[index] = transformed;
+            }
+        }
+
+        return transformed;
+    }
+
+    uint32_t MeshOptimizer::getIndexSize(uint32_t vertexCount) {
+        return vertexCount <= std::numeric_limits<uint16_t>::max() + 1u ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
+    void MeshOptimizer::packIndices(const std::vector<uint32_t>& indices, uint32_t indexSize, std::vector<uint8_t>& packed) {
+        packed.resize(indices.size() * indexSize);
+
+        if (indexSize == sizeof(uint32_t)) {
+            std::memcpy(packed.data(), indices.data(), packed.size());
+
+            return;
+        }
+
+        for (size_t i = 0; i < indices.size(); ++i) {
+            auto index = static_cast<uint16_t>(indices[i]);
+            std::memcpy(&packed[i * sizeof(uint16_t)], &index, sizeof(uint16_t));
+        }
+    }
+
+} // namespace engine
@@ -0,0 +1,55 @@
+#ifndef PROTOTYPE_ACTION_RPG_MESHOPTIMIZER_HPP
+#define PROTOTYPE_ACTION_RPG_MESHOPTIMIZER_HPP
+
+
+#include <vector>
+#include <cstdint>
+
+#include "Vertex.hpp"
+
+
+namespace engine {
+
+    // Welds duplicated vertices, orders triangles for the post-transform cache (Forsyth) and vertices for fetch locality
+    class MeshOptimizer {
+    public:
+        static constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+        // Cache simulated for the statistics, close to the FIFO of current hardware
+        static constexpr uint32_t STATS_CACHE_SIZE = 16;
+
+        struct Stats {
+            uint32_t verticesBefore{};
+            uint32_t verticesAfter{};
+            uint32_t triangles{};
+            // Transformed vertices per triangle
+            float acmrBefore{};
+            float acmrAfter{};
+            // Transformed vertices per vertex of the mesh, 1.0 is the best possible
+            float atvrBefore{};
+            float atvrAfter{};
+        };
+
+    public:
+        static Stats optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+        // Bitwise identical vertices are merged
+        static void weld(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+        static void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+        // Vertices are sorted by first use in the index buffer, unused ones are dropped
+        static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+        // Returns the number of vertices transformed by a FIFO cache of the given size
+        static uint32_t simulateCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize);
+
+        // 2 when every index fits in 16 bits, 4 otherwise
+        static uint32_t getIndexSize(uint32_t vertexCount);
+
+        static void packIndices(const std::vector<uint32_t>& indices, uint32_t indexSize, std::vector<uint8_t>& packed);
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_MESHOPTIMIZER_HPP
@@ -1,5 +1,46 @@
 #include "Vertex.hpp"
 
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include "glm/gtc/packing.hpp"
+
+
+inline uint32_t encodeNormal(const glm::vec3& normal) {
+    float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+
+    if (sum == 0.0f) return glm::packSnorm2x16(glm::vec2(0.0f));
+
+    glm::vec3 n = normal / sum;
+    glm::vec2 encoded(n.x, n.y);
+
+    // Lower hemisphere is folded over the diagonals
+    if (n.z < 0.0f) {
+        encoded = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    return glm::packSnorm2x16(encoded);
+}
+
+inline void encodeWeights(glm::vec4 weights, uint16_t* encoded) {
+    weights = glm::max(weights, glm::vec4(0.0f));
+    float sum = weights.x + weights.y + weights.z + weights.w;
+    weights = sum > 0.0f ? weights / sum : glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+
+    uint32_t total = 0;
+    int largest = 0;
+
+    for (int i = 0; i < 4; ++i) {
+        encoded[i] = static_cast<uint16_t>(std::lround(weights[i] * 65535.0f));
+        total += encoded[i];
+
+        if (weights[i] > weights[largest]) largest = i;
+    }
+
+    // Rounding error goes to the largest weight so the skin matrix keeps a scale of one
+    encoded[largest] = static_cast<uint16_t>(static_cast<int32_t>(encoded[largest]) + 65535 - static_cast<int32_t>(total));
+}
 
 namespace engine {
 
@@ -52,4 +93,128 @@ namespace engine {
         };
     }
 
+    vk::VertexInputBindingDescription StaticVertex::getBindingDescription() {
+        return {
+                .binding = 0,
+                .stride = sizeof(StaticVertex),
+                .inputRate = vk::VertexInputRate::eVertex
+        };
+    }
+
+    std::vector<vk::VertexInputAttributeDescription> StaticVertex::getAttributeDescriptions() {
+        return {
+            {
+                .location = 0,
+                .binding = 0,
+                .format = vk::Format::eR32G32B32Sfloat,
+                .offset = offsetof(StaticVertex, position)
+            },
+            {
+                .location = 1,
+                .binding = 0,
+                .format = vk::Format::eR16G16Snorm,
+                .offset = offsetof(StaticVertex, normal)
+            },
+            {
+                .location = 2,
+                .binding = 0,
+                .format = vk::Format::eR16G16Sfloat,
+                .offset = offsetof(StaticVertex, uv0)
+            },
+            {
+                .location = 3,
+                .binding = 0,
+                .format = vk::Format::eR16G16Sfloat,
+                .offset = offsetof(StaticVertex, uv1)
+            }
+        };
+    }
+
+    vk::VertexInputBindingDescription SkinnedVertex::getBindingDescription() {
+        return {
+                .binding = 0,
+                .stride = sizeof(SkinnedVertex),
+                .inputRate = vk::VertexInputRate::eVertex
+        };
+    }
+
+    std::vector<vk::VertexInputAttributeDescription> SkinnedVertex::getAttributeDescriptions() {
+        return {
+            {
+                .location = 0,
+                .binding = 0,
+                .format = vk::Format::eR32G32B32Sfloat,
+                .offset = offsetof(SkinnedVertex, position)
+            },
+            {
+                .location = 1,
+                .binding = 0,
+                .format = vk::Format::eR16G16Snorm,
+                .offset = offsetof(SkinnedVertex, normal)
+            },
+            {
+                .location = 2,
+                .binding = 0,
+                .format = vk::Format::eR16G16Sfloat,
+                .offset = offsetof(SkinnedVertex, uv0)
+            },
+            {
+                .location = 3,
+                .binding = 0,
+                .format = vk::Format::eR16G16Sfloat,
+                .offset = offsetof(SkinnedVertex, uv1)
+            },
+            {
+                .location = 4,
+                .binding = 0,
+                .format = vk::Format::eR8G8B8A8Uint,
+                .offset = offsetof(SkinnedVertex, joints)
+            },
+            {
+                .location = 5,
+                .binding = 0,
+                .format = vk::Format::eR16G16B16A16Unorm,
+                .offset = offsetof(SkinnedVertex, weights)
+            }
+        };
+    }
+
+    static_assert(sizeof(StaticVertex) == 24 && sizeof(SkinnedVertex) == 36);
+    static_assert(offsetof(SkinnedVertex, uv1) == offsetof(StaticVertex, uv1));
+
+    uint32_t getVertexSize(VertexLayout layout) {
+        return layout == VertexLayout::SKINNED ? sizeof(SkinnedVertex) : sizeof(StaticVertex);
+    }
+
+    bool packVertices(const Vertex* vertices, size_t count, VertexLayout layout, std::vector<uint8_t>& packed) {
+        uint32_t stride = getVertexSize(layout);
+        bool jointsFit = true;
+
+        packed.resize(count * stride);
+
+        for (size_t v = 0; v < count; ++v) {
+            const Vertex& vertex = vertices[v];
+            SkinnedVertex out{
+                .position = vertex.position,
+                .normal = encodeNormal(vertex.normal),
+                .uv0 = glm::packHalf2x16(vertex.uv0),
+                .uv1 = glm::packHalf2x16(vertex.uv1)
+            };
+
+            if (layout == VertexLayout::SKINNED) {
+                for (int i = 0; i < 4; ++i) {
+                    jointsFit &= vertex.joint0[i] <= 255.0f;
+                    out.joints[i] = static_cast<uint8_t>(std::clamp(vertex.joint0[i], 0.0f, 255.0f));
+                }
+
+                encodeWeights(vertex.weight0, out.weights);
+            }
+
+            // The static layout is the first part of the skinned one
+            std::memcpy(&packed[v * stride], &out, stride);
+        }
+
+        return jointsFit;
+    }
+
 } // namespace core
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 
 #include <vector>
+#include <cstdint>
 
 #include "glm/glm.hpp"
 #define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
@@ -11,6 +12,7 @@
 
 namespace engine {
 
+    // Full precision vertex written by the loaders, meshes are packed in one of the layouts below before the upload
     struct Vertex {
         glm::vec3 position{};
         glm::vec3 normal{};
@@ -24,6 +26,42 @@ namespace engine {
         static std::vector<vk::VertexInputAttributeDescription> getAttributeDescriptions();
     };
 
+    enum class VertexLayout : uint32_t {
+        STATIC,
+        SKINNED
+    };
+
+    // 24 bytes: octahedral snorm16 normal and half float uvs
+    struct StaticVertex {
+        glm::vec3 position{};
+        uint32_t normal{};
+        uint32_t uv0{};
+        uint32_t uv1{};
+
+        static vk::VertexInputBindingDescription getBindingDescription();
+
+        static std::vector<vk::VertexInputAttributeDescription> getAttributeDescriptions();
+    };
+
+    // 36 bytes: the static layout followed by u8x4 joint indices and unorm16x4 weights
+    struct SkinnedVertex {
+        glm::vec3 position{};
+        uint32_t normal{};
+        uint32_t uv0{};
+        uint32_t uv1{};
+        uint8_t joints[4]{};
+        uint16_t weights[4]{};
+
+        static vk::VertexInputBindingDescription getBindingDescription();
+
+        static std::vector<vk::VertexInputAttributeDescription> getAttributeDescriptions();
+    };
+
+    uint32_t getVertexSize(VertexLayout layout);
+
+    // Returns false when a joint index does not fit in 8 bits, it is clamped
+    bool packVertices(const Vertex* vertices, size_t count, VertexLayout layout, std::vector<uint8_t>& packed);
+
 } // namesapce core
 
 
@@ -1,6 +1,8 @@
 #include "PhysicsEngine.hpp"
 
 #include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
 
 #include "../Utilities.hpp"
 #include "../mesh/Mesh.hpp"
@@ -37,6 +39,8 @@ namespace engine {
             delete obj;
         }
 
+        triangleMeshes.clear();
+
         delete dynamicsWorld;
         delete solver;
         delete dispatcher;
@@ -50,10 +54,20 @@ namespace engine {
         auto& modelInterface = Application::m_scene->getComponent<ModelInterface>(entity.id);
         auto& collision = Application::m_scene->getComponent<Collision>(entity.id);
 
+        // The entity is drawn with its scale applied before its rotation, the rotation of the body is undone around it
+        glm::mat4 rotation = glm::mat4(glm::quat(transform.getRotation()));
+        glm::mat4 scale = glm::transpose(rotation) * glm::scale(glm::mat4(1.0f), transform.getSize()) * rotation;
+
         for (auto& node : modelInterface.getNodes()) {
            if (node.mesh > 0) {
-               btCollisionShape* shape;
-               shape = new btBoxShape(collision.halfSize);
+               btCollisionShape* shape = nullptr;
+
+               if (collision.shape == Collision::Shape::MESH && collision.mass == 0.0f) {
+                   shape = createMeshShape(node.mesh, scale * node.getMatrix(modelInterface.getNodes()));
+               }
+
+               if (!shape) shape = new btBoxShape(collision.halfSize);
+
                btVector3 localInertia(0, 0, 0);
 
                if (collision.mass != 0.0f)
@@ -80,6 +94,28 @@ namespace engine {
         }
     }
 
+    btCollisionShape* PhysicsEngine::createMeshShape(uint64_t meshID, const glm::mat4& matrix) {
+        std::shared_ptr<const MeshData> data = Application::m_resourceManager->requestMeshData(meshID, MeshResidency::POSITIONS);
+
+        if (!data || data->indices.size() < 3) return nullptr;
+
+        auto triangles = std::make_unique<btTriangleMesh>();
+        for (size_t i = 0; i + 2 < data->indices.size(); i += 3) {
+            glm::vec3 a = glm::vec3(matrix * glm::vec4(data->positions[data->indices[i]], 1.0f));
+            glm::vec3 b = glm::vec3(matrix * glm::vec4(data->positions[data->indices[i + 1]], 1.0f));
+            glm::vec3 c = glm::vec3(matrix * glm::vec4(data->positions[data->indices[i + 2]], 1.0f));
+
+            triangles->addTriangle({a.x, a.y, a.z}, {b.x, b.y, b.z}, {c.x, c.y, c.z});
+        }
+
+        Application::m_resourceManager->releaseMeshData(meshID);
+
+        auto* shape = new btBvhTriangleMeshShape(triangles.get(), true);
+        triangleMeshes.push_back(std::move(triangles));
+
+        return shape;
+    }
+
     void PhysicsEngine::stepSimulation(float deltaTime) {
         dynamicsWorld->stepSimulation(deltaTime);
     }
@@ -7,6 +7,7 @@
 #include <unordered_map>
 
 #include "btBulletDynamicsCommon.h"
+#include "glm/glm.hpp"
 
 
 namespace engine {
@@ -29,12 +30,19 @@ namespace engine {
 
         btDynamicsWorld* getDynamicsWorld();
 
+    private:
+        // Triangles of a static mesh, copied from the positions the mesh keeps only while the shape is built. The body only
+        // carries the position and rotation of the entity, matrix moves the vertices into its space
+        btCollisionShape* createMeshShape(uint64_t meshID, const glm::mat4& matrix);
+
     private:
         btDiscreteDynamicsWorld* dynamicsWorld{};
         btBroadphaseInterface* broadPhase{};
         btDefaultCollisionConfiguration* collisionConfig{};
         btCollisionDispatcher* dispatcher{};
         btSequentialImpulseConstraintSolver* solver{};
+        // Not owned by their btBvhTriangleMeshShape
+        std::vector<std::unique_ptr<btTriangleMesh>> triangleMeshes;
     };
 
 } // namespace engine
@@ -0,0 +1,120 @@
+#include "BlockAllocator.hpp"
+
+#include <algorithm>
+
+
+inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+namespace engine {
+
+    BuddyAllocator::BuddyAllocator(uint64_t size, uint64_t minBlockSize) : m_size(minBlockSize), m_minBlockSize(minBlockSize) {
+        while (m_size * 2 <= size) {
+            m_size *= 2;
+            m_maxOrder++;
+        }
+
+        m_freeBlocks.resize(m_maxOrder + 1);
+        m_freeBlocks[m_maxOrder].insert(0);
+    }
+
+    bool BuddyAllocator::allocate(uint64_t size, uint64_t alignment, uint64_t& offset) {
+        // Blocks are aligned to their own size, a block as large as the alignment is always aligned
+        uint64_t needed = std::max({size, alignment, m_minBlockSize});
+        uint32_t order = 0;
+
+        while (blockSize(order) < needed) {
+            if (++order > m_maxOrder) return false;
+        }
+
+        uint32_t current = order;
+        while (current <= m_maxOrder && m_freeBlocks[current].empty()) current++;
+
+        if (current > m_maxOrder) return false;
+
+        offset = *m_freeBlocks[current].begin();
+        m_freeBlocks[current].erase(m_freeBlocks[current].begin());
+
+        while (current > order) {
+            current--;
+            m_freeBlocks[current].insert(offset + blockSize(current));
+        }
+
+        m_allocated[offset] = order;
+        m_used += blockSize(order);
+
+        return true;
+    }
+
+    void BuddyAllocator::free(uint64_t offset) {
+        auto it = m_allocated.find(offset);
+
+        if (it == m_allocated.end()) return;
+
+        uint32_t order = it->second;
+        m_allocated.erase(it);
+        m_used -= blockSize(order);
+
+        while (order < m_maxOrder) {
+            auto buddy = m_freeBlocks[order].find(offset ^ blockSize(order));
+
+            if (buddy == m_freeBlocks[order].end()) break;
+
+            offset = std::min(offset, *buddy);
+            m_freeBlocks[order].erase(buddy);
+            order++;
+        }
+
+        m_freeBlocks[order].insert(offset);
+    }
+
+    uint64_t BuddyAllocator::getSize() const {
+        return m_size;
+    }
+
+    uint64_t BuddyAllocator::getUsed() const {
+        return m_used;
+    }
+
+    bool BuddyAllocator::empty() const {
+        return m_allocated.empty();
+    }
+
+    uint64_t BuddyAllocator::blockSize(uint32_t order) const {
+        return m_minBlockSize << order;
+    }
+
+    LinearAllocator::LinearAllocator(uint64_t size) : m_size(size) {
+
+    }
+
+    bool LinearAllocator::allocate(uint64_t size, uint64_t alignment, uint64_t& offset) {
+        uint64_t start = alignUp(m_head, alignment);
+
+        if (start + size > m_size) return false;
+
+        offset = start;
+        m_head = start + size;
+        m_count++;
+
+        return true;
+    }
+
+    void LinearAllocator::free(uint64_t /*offset*/) {
+        if (m_count > 0 && --m_count == 0) m_head = 0;
+    }
+
+    uint64_t LinearAllocator::getSize() const {
+        return m_size;
+    }
+
+    uint64_t LinearAllocator::getUsed() const {
+        return m_head;
+    }
+
+    bool LinearAllocator::empty() const {
+        return m_count == 0;
+    }
+
+} // namespace engine
@@ -0,0 +1,64 @@
+#ifndef PROTOTYPE_ACTION_RPG_BLOCKALLOCATOR_HPP
+#define PROTOTYPE_ACTION_RPG_BLOCKALLOCATOR_HPP
+
+
+#include <set>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+
+namespace engine {
+
+    // Power of two blocks split in halves on demand and merged back with their buddy when freed
+    class BuddyAllocator {
+    public:
+        BuddyAllocator(uint64_t size, uint64_t minBlockSize);
+
+        bool allocate(uint64_t size, uint64_t alignment, uint64_t& offset);
+
+        void free(uint64_t offset);
+
+        [[nodiscard]] uint64_t getSize() const;
+
+        [[nodiscard]] uint64_t getUsed() const;
+
+        [[nodiscard]] bool empty() const;
+
+    private:
+        [[nodiscard]] uint64_t blockSize(uint32_t order) const;
+
+    private:
+        uint64_t m_size;
+        uint64_t m_minBlockSize;
+        uint64_t m_used{};
+        uint32_t m_maxOrder{};
+        std::vector<std::set<uint64_t>> m_freeBlocks;
+        std::unordered_map<uint64_t, uint32_t> m_allocated;
+    };
+
+    // Bump allocator for resources that live as long as the block, it rewinds once every allocation is freed
+    class LinearAllocator {
+    public:
+        explicit LinearAllocator(uint64_t size);
+
+        bool allocate(uint64_t size, uint64_t alignment, uint64_t& offset);
+
+        void free(uint64_t offset);
+
+        [[nodiscard]] uint64_t getSize() const;
+
+        [[nodiscard]] uint64_t getUsed() const;
+
+        [[nodiscard]] bool empty() const;
+
+    private:
+        uint64_t m_size;
+        uint64_t m_head{};
+        uint32_t m_count{};
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_BLOCKALLOCATOR_HPP
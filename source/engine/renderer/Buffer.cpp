@@ -10,18 +10,23 @@ namespace engine {
     Buffer::~Buffer() = default;
 
     void Buffer::map(vk::DeviceSize size, vk::DeviceSize offset) {
-        m_mapped = m_device.mapMemory(m_memory, offset, size);
+        // Sub-allocated memory is shared with other resources, it is mapped once by the allocator
+        if (m_allocation.mapped) {
+            m_mapped = static_cast<char*>(m_allocation.mapped) + offset;
+        } else {
+            m_mapped = m_device.mapMemory(m_memory, m_allocation.offset + offset, size);
+        }
     }
 
     void Buffer::unmap() {
         if (m_mapped) {
-            m_device.unmapMemory(m_memory);
+            if (!m_allocation.mapped) m_device.unmapMemory(m_memory);
             m_mapped = nullptr;
         }
     }
 
     void Buffer::bind(vk::DeviceSize offset) const {
-        m_device.bindBufferMemory(m_buffer, m_memory, offset);
+        m_device.bindBufferMemory(m_buffer, m_memory, m_allocation.offset + offset);
     }
 
     void Buffer::setupDescriptor(vk::DeviceSize size, vk::DeviceSize offset) {
@@ -33,7 +38,7 @@ namespace engine {
     vk::Result Buffer::flush(vk::DeviceSize size, vk::DeviceSize offset) const {
         vk::MappedMemoryRange mappedRange{
             .memory = m_memory,
-            .offset = offset,
+            .offset = m_allocation.offset + offset,
             .size = size
         };
 
@@ -43,7 +48,11 @@ namespace engine {
     void Buffer::destroy() const {
         if (m_buffer) m_device.destroyBuffer(m_buffer);
 
-        if (m_memory) m_device.freeMemory(m_memory);
+        if (m_allocator) {
+            m_allocator->free(m_allocation);
+        } else if (m_memory) {
+            m_device.freeMemory(m_memory);
+        }
     }
 
     vk::DescriptorBufferInfo &Buffer::getDescriptorBufferInfo() {
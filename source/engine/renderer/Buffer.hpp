@@ -7,6 +7,8 @@
 #define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
 #include "vulkan/vulkan.hpp"
 
+#include "MemoryAllocator.hpp"
+
 
 namespace engine {
 
@@ -43,6 +45,8 @@ namespace engine {
         vk::DescriptorSet m_descriptorSet{};
         vk::DeviceSize m_size = 0;
         void* m_mapped = nullptr;
+        MemoryAllocator* m_allocator = nullptr;
+        MemoryAllocator::Allocation m_allocation{};
     };
 
 } // End namespace vk
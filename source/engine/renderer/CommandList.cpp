@@ -15,19 +15,19 @@ namespace engine {
         if (!m_sharedPool) m_device.destroy(m_pool);
     }
 
-    void CommandList::initBuffers(uint32_t imageCount, uint32_t *imageIndex, uint32_t level) {
-        m_imageIndex = imageIndex;
-        m_buffers.resize(imageCount);
+    void CommandList::initBuffers(uint32_t frameCount, uint32_t *frameIndex, uint32_t level) {
+        m_frameIndex = frameIndex;
+        m_buffers.resize(frameCount);
 
         m_buffers = m_device.allocateCommandBuffers({
             .commandPool = m_pool,
             .level = (level == 0 ? vk::CommandBufferLevel::ePrimary : vk::CommandBufferLevel::eSecondary),
-            .commandBufferCount = imageCount,
+            .commandBufferCount = frameCount,
         });
     }
 
     vk::CommandBuffer &CommandList::getBuffer() {
-        uint32_t index = (m_imageIndex ? *m_imageIndex : 0);
+        uint32_t index = (m_frameIndex ? *m_frameIndex : 0);
 
         return m_buffers[index];
     }
@@ -41,12 +41,12 @@ namespace engine {
     }
 
     void CommandList::beginRenderPass(const vk::RenderPass &renderPass, const glm::vec4& clearColor, vk::Framebuffer& framebuffer,
-                                      vk::Extent2D swapChainExtent) {
+                                      vk::Extent2D swapChainExtent, vk::SubpassContents contents) {
         std::array<vk::ClearValue, 2> clearValues;
         clearValues[0].color = {std::array<float, 4>({{clearColor.x, clearColor.y, clearColor.z, clearColor.w}})};
         clearValues[1].depthStencil = vk::ClearDepthStencilValue{1.0f, 0};
 
-        m_buffers[*m_imageIndex].beginRenderPass({
+        m_buffers[*m_frameIndex].beginRenderPass({
             .renderPass = renderPass,
             .framebuffer = framebuffer,
             .renderArea = {
@@ -55,21 +55,36 @@ namespace engine {
             },
                     .clearValueCount = static_cast<uint32_t>(clearValues.size()),
                     .pClearValues = clearValues.data()
-        }, vk::SubpassContents::eInline);
+        }, contents);
+
+        if (contents == vk::SubpassContents::eSecondaryCommandBuffers) return;
+
+        m_buffers[*m_frameIndex].setViewport(0, vk::Viewport{
+            .x = 0.0f,
+            .y = 0.0f,
+            .width = static_cast<float>(swapChainExtent.width),
+            .height = static_cast<float>(swapChainExtent.height),
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f
+        });
+        m_buffers[*m_frameIndex].setScissor(0, vk::Rect2D{
+            .offset = {0, 0},
+            .extent = swapChainExtent
+        });
     }
 
     void CommandList::endRenderPass() {
-        m_buffers[*m_imageIndex].endRenderPass();
+        m_buffers[*m_frameIndex].endRenderPass();
     }
 
     void CommandList::begin(vk::CommandBufferUsageFlags usage) {
-        m_buffers[*m_imageIndex].begin({
+        m_buffers[*m_frameIndex].begin({
             .flags = usage
         });
     }
 
     void CommandList::end() {
-        m_buffers[*m_imageIndex].end();
+        m_buffers[*m_frameIndex].end();
     }
 
 } // namespace core
\ No newline at end of file
@@ -14,7 +14,8 @@ namespace engine {
 
         void cleanup();
 
-        void initBuffers(uint32_t imageCount = 1, uint32_t* imageIndex = nullptr, uint32_t level = 0);
+        // One buffer per frame in flight, the one recorded is selected by the frame index pointed to
+        void initBuffers(uint32_t frameCount = 1, uint32_t* frameIndex = nullptr, uint32_t level = 0);
 
         void free();
 
@@ -22,8 +23,9 @@ namespace engine {
 
         vk::CommandPool& getPool();
 
+        // The viewport and scissor are only set for inline contents, secondary buffers set their own
         void beginRenderPass(const vk::RenderPass& renderPass, const glm::vec4& clearColor, vk::Framebuffer& framebuffer,
-                             vk::Extent2D swapChainExtent);
+                             vk::Extent2D swapChainExtent, vk::SubpassContents contents = vk::SubpassContents::eInline);
 
         void endRenderPass();
 
@@ -32,7 +34,7 @@ namespace engine {
         void end();
 
     private:
-        uint32_t* m_imageIndex{};
+        uint32_t* m_frameIndex{};
         std::vector<vk::CommandBuffer> m_buffers;
         vk::CommandPool m_pool;
         bool m_sharedPool;
@@ -0,0 +1,110 @@
+#include "DescriptorLayoutCache.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+#include "../Hash.hpp"
+
+
+template<typename T>
+inline uint64_t hashWords(const std::vector<T>& words) {
+    return engine::tools::hash(std::string_view(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(T)));
+}
+
+namespace engine {
+
+    DescriptorLayoutCache::DescriptorLayoutCache() = default;
+
+    DescriptorLayoutCache::~DescriptorLayoutCache() = default;
+
+    void DescriptorLayoutCache::create(vk::Device device) {
+        m_device = device;
+    }
+
+    void DescriptorLayoutCache::cleanup() {
+        for (auto& layout : m_pipelineLayouts) m_device.destroy(layout.second);
+
+        for (auto& layout : m_setLayouts) m_device.destroy(layout.second);
+
+        m_pipelineLayouts.clear();
+        m_setLayouts.clear();
+        m_bindings.clear();
+    }
+
+    vk::DescriptorSetLayout DescriptorLayoutCache::getSetLayout(std::vector<vk::DescriptorSetLayoutBinding> bindings, vk::DescriptorBindingFlags flags) {
+        std::sort(bindings.begin(), bindings.end(), [](const auto& a, const auto& b) { return a.binding < b.binding; });
+
+        std::vector<uint32_t> key;
+        key.reserve(bindings.size() * 4 + 1);
+        key.push_back(static_cast<uint32_t>(flags));
+
+        for (auto& binding : bindings) {
+            key.insert(key.end(), {binding.binding, static_cast<uint32_t>(binding.descriptorType), binding.descriptorCount,
+                                   static_cast<uint32_t>(binding.stageFlags)});
+        }
+
+        uint64_t hash = hashWords(key);
+        auto it = m_setLayouts.find(hash);
+
+        if (it != m_setLayouts.end()) return it->second;
+
+        std::vector<vk::DescriptorBindingFlags> bindingFlags(bindings.size(), flags);
+
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{
+            .bindingCount = static_cast<uint32_t>(bindingFlags.size()),
+            .pBindingFlags = bindingFlags.empty() ? nullptr : bindingFlags.data()
+        };
+
+        vk::DescriptorSetLayout layout = m_device.createDescriptorSetLayout({
+            .pNext = flags ? &flagsInfo : nullptr,
+            .flags = flags & vk::DescriptorBindingFlagBits::eUpdateAfterBind ? vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool
+                                                                               : vk::DescriptorSetLayoutCreateFlags{},
+            .bindingCount = static_cast<uint32_t>(bindings.size()),
+            .pBindings = bindings.empty() ? nullptr : bindings.data()
+        });
+
+        m_setLayouts[hash] = layout;
+        m_bindings[static_cast<VkDescriptorSetLayout>(layout)] = std::move(bindings);
+
+        return layout;
+    }
+
+    vk::PipelineLayout DescriptorLayoutCache::getPipelineLayout(const std::vector<vk::DescriptorSetLayout>& setLayouts,
+                                                                const std::vector<vk::PushConstantRange>& pushConstants) {
+        std::vector<uint64_t> key;
+        key.reserve(setLayouts.size() + pushConstants.size() + 1);
+
+        for (auto& layout : setLayouts) key.push_back(reinterpret_cast<uint64_t>(static_cast<VkDescriptorSetLayout>(layout)));
+
+        // Separates the set layouts from the ranges
+        key.push_back(~0ull);
+
+        for (auto& range : pushConstants) {
+            key.push_back(static_cast<uint64_t>(static_cast<uint32_t>(range.stageFlags)) << 48
+                          | static_cast<uint64_t>(range.offset) << 24 | range.size);
+        }
+
+        uint64_t hash = hashWords(key);
+        auto it = m_pipelineLayouts.find(hash);
+
+        if (it != m_pipelineLayouts.end()) return it->second;
+
+        vk::PipelineLayout layout = m_device.createPipelineLayout({
+            .setLayoutCount = static_cast<uint32_t>(setLayouts.size()),
+            .pSetLayouts = setLayouts.empty() ? nullptr : setLayouts.data(),
+            .pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size()),
+            .pPushConstantRanges = pushConstants.empty() ? nullptr : pushConstants.data()
+        });
+
+        m_pipelineLayouts[hash] = layout;
+
+        return layout;
+    }
+
+    const std::vector<vk::DescriptorSetLayoutBinding>* DescriptorLayoutCache::getBindings(vk::DescriptorSetLayout setLayout) const {
+        auto it = m_bindings.find(static_cast<VkDescriptorSetLayout>(setLayout));
+
+        return it != m_bindings.end() ? &it->second : nullptr;
+    }
+
+} // namespace engine
@@ -0,0 +1,48 @@
+#ifndef PROTOTYPE_ACTION_RPG_DESCRIPTORLAYOUTCACHE_HPP
+#define PROTOTYPE_ACTION_RPG_DESCRIPTORLAYOUTCACHE_HPP
+
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include "vulkan/vulkan.hpp"
+
+
+namespace engine {
+
+    // Descriptor set and pipeline layouts keyed by the XXH64 of their description. Equal layouts are one handle, so sets
+    // allocated with a layout built by hand are compatible with the pipelines built from the reflection of their shaders.
+    // Layouts live until the device is destroyed
+    class DescriptorLayoutCache {
+    public:
+        DescriptorLayoutCache();
+
+        ~DescriptorLayoutCache();
+
+        void create(vk::Device device);
+
+        void cleanup();
+
+        // Bindings are sorted, immutable samplers are not supported. The flags apply to every binding, a layout with update
+        // after bind bindings can only be allocated from a pool created with the same flag
+        vk::DescriptorSetLayout getSetLayout(std::vector<vk::DescriptorSetLayoutBinding> bindings, vk::DescriptorBindingFlags flags = {});
+
+        vk::PipelineLayout getPipelineLayout(const std::vector<vk::DescriptorSetLayout>& setLayouts,
+                                             const std::vector<vk::PushConstantRange>& pushConstants);
+
+        // nullptr for a layout not built by the cache
+        [[nodiscard]] const std::vector<vk::DescriptorSetLayoutBinding>* getBindings(vk::DescriptorSetLayout setLayout) const;
+
+    private:
+        vk::Device m_device;
+        std::unordered_map<uint64_t, vk::DescriptorSetLayout> m_setLayouts;
+        std::unordered_map<VkDescriptorSetLayout, std::vector<vk::DescriptorSetLayoutBinding>> m_bindings;
+        std::unordered_map<uint64_t, vk::PipelineLayout> m_pipelineLayouts;
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_DESCRIPTORLAYOUTCACHE_HPP
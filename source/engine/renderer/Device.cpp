@@ -1,11 +1,32 @@
 #include "Device.hpp"
 
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include "spdlog/spdlog.h"
+
 #include "Instance.hpp"
 #include "CommandList.hpp"
 #include "../Utilities.hpp"
 #include "../Application.hpp"
 
 
+// Drivers reject or even crash on cache data of another driver, the header written in front of it is checked first:
+// header size, header version, vendor ID, device ID and the cache UUID
+inline bool isPipelineCacheCompatible(const std::vector<char>& data, const vk::PhysicalDeviceProperties& properties) {
+    uint32_t header[4];
+
+    if (data.size() < sizeof(header) + VK_UUID_SIZE) return false;
+
+    std::memcpy(header, data.data(), sizeof(header));
+
+    return header[0] >= sizeof(header) + VK_UUID_SIZE && header[0] <= data.size()
+            && header[1] == static_cast<uint32_t>(vk::PipelineCacheHeaderVersion::eOne)
+            && header[2] == properties.vendorID && header[3] == properties.deviceID
+            && std::memcmp(data.data() + sizeof(header), properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+
 namespace engine {
 
     Device::Device(const std::shared_ptr<Instance>& instance, vk::QueueFlags requestedQueueTypes) {
@@ -66,16 +87,42 @@ namespace engine {
             m_queueFamilyIndices.transfer = m_queueFamilyIndices.graphics;
         }
 
+        m_bindless = supportsBindless();
+
+        if (m_bindless) reqExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+
+        vk::PhysicalDeviceDescriptorIndexingFeatures indexingFeatures{
+            .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+            .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+            .descriptorBindingPartiallyBound = VK_TRUE,
+            .runtimeDescriptorArray = VK_TRUE
+        };
+
+        vk::PhysicalDeviceFeatures enabledFeatures{
+            .shaderSampledImageArrayDynamicIndexing = m_bindless
+        };
+
         m_logicalDevice = m_physicalDevice.createDevice({
+            .pNext = m_bindless ? &indexingFeatures : nullptr,
             .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
             .pQueueCreateInfos = queueCreateInfos.data(),
             .enabledExtensionCount = static_cast<uint32_t>(reqExtensions.size()),
             .ppEnabledExtensionNames = reqExtensions.data(),
-            .pEnabledFeatures = {},
+            .pEnabledFeatures = &enabledFeatures,
         });
 
+        spdlog::info("[Device] Textures: {}", m_bindless ? "bindless array" : "one descriptor set each");
+
         // Create a default command pool for graphics command buffers
         m_commandPool = createCommandPool();
+
+        m_pipelineCache = createPipelineCache();
+
+        m_layoutCache = std::make_unique<DescriptorLayoutCache>();
+        m_layoutCache->create(m_logicalDevice);
+
+        m_allocator = std::make_unique<MemoryAllocator>();
+        m_allocator->create(m_physicalDevice, m_logicalDevice, MEMORY_BLOCK_SIZE);
     }
 
     Device::~Device() = default;
@@ -83,6 +130,18 @@ namespace engine {
     void Device::destroy() const {
         if (m_commandPool) m_logicalDevice.destroyCommandPool(m_commandPool);
 
+        if (m_pipelineCache) {
+            savePipelineCache();
+            m_logicalDevice.destroy(m_pipelineCache);
+        }
+
+        if (m_layoutCache) m_layoutCache->cleanup();
+
+        if (m_allocator) {
+            m_allocator->logStats();
+            m_allocator->cleanup();
+        }
+
         if (m_logicalDevice) m_logicalDevice.destroy();
     }
 
@@ -200,7 +259,7 @@ namespace engine {
     }
 
      engine::Buffer Device::createBuffer(vk::BufferUsageFlags usageFlags, vk::MemoryPropertyFlags memoryPropertyFlags,
-                                         vk::DeviceSize size, void *data) const {
+                                        vk::DeviceSize size, void *data, MemoryAllocator::Strategy strategy) const {
         engine::Buffer buffer;
         buffer.m_device = m_logicalDevice;
 
@@ -212,19 +271,24 @@ namespace engine {
 
         // Create the memory backing up the buffer handle
         vk::MemoryRequirements memReqs = m_logicalDevice.getBufferMemoryRequirements(buffer.m_buffer);
-        vk::MemoryAllocateInfo memAlloc{
-            .allocationSize = memReqs.size,
-            .memoryTypeIndex = getMemoryType(memReqs.memoryTypeBits , memoryPropertyFlags)
-        };
 
-        vk::MemoryAllocateFlagsInfoKHR allocFlagsInfo{};
         if (usageFlags & vk::BufferUsageFlagBits::eShaderDeviceAddress) {
-            allocFlagsInfo.flags = vk::MemoryAllocateFlagBits::eDeviceAddress;
-            memAlloc.pNext = &allocFlagsInfo;
+            // Device address memory needs its own allocate flags, it does not go through the shared blocks
+            vk::MemoryAllocateFlagsInfoKHR allocFlagsInfo{
+                .flags = vk::MemoryAllocateFlagBits::eDeviceAddress
+            };
+
+            buffer.m_memory = m_logicalDevice.allocateMemory({
+                .pNext = &allocFlagsInfo,
+                .allocationSize = memReqs.size,
+                .memoryTypeIndex = getMemoryType(memReqs.memoryTypeBits , memoryPropertyFlags)
+            });
+        } else {
+            buffer.m_allocator = m_allocator.get();
+            buffer.m_allocation = m_allocator->allocate(memReqs, memoryPropertyFlags, false, strategy);
+            buffer.m_memory = buffer.m_allocation.memory;
         }
 
-        buffer.m_memory = m_logicalDevice.allocateMemory(memAlloc);
-
         buffer.m_size = size;
 
         // If a pointer to the buffer data has been passed, map the buffer and copy over the data
@@ -366,4 +430,73 @@ namespace engine {
         return vk::SampleCountFlagBits::e1;
     }
 
+    bool Device::supportsBindless() const {
+        vk::PhysicalDeviceProperties properties = m_physicalDevice.getProperties();
+
+        // Features and properties are chained through the 1.1 queries
+        if (VK_VERSION_MAJOR(properties.apiVersion) == 1 && VK_VERSION_MINOR(properties.apiVersion) < 1) return false;
+
+        auto extensions = m_physicalDevice.enumerateDeviceExtensionProperties();
+        bool extension = std::any_of(extensions.begin(), extensions.end(), [](const vk::ExtensionProperties& e) {
+            return std::strcmp(e.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0;
+        });
+
+        if (!extension) return false;
+
+        auto features = m_physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceDescriptorIndexingFeatures>();
+        auto& indexing = features.get<vk::PhysicalDeviceDescriptorIndexingFeatures>();
+
+        auto limits = m_physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDescriptorIndexingProperties>();
+        auto& indexingLimits = limits.get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+
+        return features.get<vk::PhysicalDeviceFeatures2>().features.shaderSampledImageArrayDynamicIndexing
+                && indexing.descriptorBindingSampledImageUpdateAfterBind && indexing.descriptorBindingUpdateUnusedWhilePending
+                && indexing.descriptorBindingPartiallyBound
+                && indexing.runtimeDescriptorArray
+                && indexingLimits.maxPerStageDescriptorUpdateAfterBindSamplers >= BINDLESS_TEXTURES
+                && indexingLimits.maxPerStageDescriptorUpdateAfterBindSampledImages >= BINDLESS_TEXTURES
+                && indexingLimits.maxDescriptorSetUpdateAfterBindSamplers >= BINDLESS_TEXTURES
+                && indexingLimits.maxDescriptorSetUpdateAfterBindSampledImages >= BINDLESS_TEXTURES;
+    }
+
+    vk::PipelineCache Device::createPipelineCache() {
+        std::vector<char> data;
+        std::ifstream file(PIPELINE_CACHE_FILE, std::ios::binary | std::ios::ate);
+
+        if (file.is_open()) {
+            data.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+            if (!file) data.clear();
+        }
+
+        if (!isPipelineCacheCompatible(data, m_physicalDevice.getProperties())) {
+            if (!data.empty()) spdlog::warn("[Device] Pipeline cache written by another driver or device, starting empty");
+
+            data.clear();
+        } else {
+            spdlog::info("[Device] Pipeline cache loaded: {} KB", data.size() / 1024);
+        }
+
+        m_pipelineCacheWarm = !data.empty();
+
+        return m_logicalDevice.createPipelineCache({
+            .initialDataSize = data.size(),
+            .pInitialData = data.empty() ? nullptr : data.data()
+        });
+    }
+
+    void Device::savePipelineCache() const {
+        std::vector<uint8_t> data = m_logicalDevice.getPipelineCacheData(m_pipelineCache);
+        std::ofstream file(PIPELINE_CACHE_FILE, std::ios::binary | std::ios::trunc);
+
+        if (!file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+            spdlog::warn("[Device] Failed to write the pipeline cache to {}", PIPELINE_CACHE_FILE);
+            return;
+        }
+
+        spdlog::info("[Device] Pipeline cache saved: {} KB", data.size() / 1024);
+    }
+
 } // End namespace vk
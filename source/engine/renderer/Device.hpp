@@ -9,6 +9,8 @@
 
 #include "SwapChain.hpp"
 #include "Buffer.hpp"
+#include "MemoryAllocator.hpp"
+#include "DescriptorLayoutCache.hpp"
 #include "../window/Window.hpp"
 
 
@@ -49,7 +51,8 @@ namespace engine {
         void flushCommandBuffer(vk::CommandBuffer commandBuffer, vk::Queue queue, bool free = true) const;
 
         engine::Buffer createBuffer(vk::BufferUsageFlags usageFlags, vk::MemoryPropertyFlags memoryPropertyFlags,
-                                    vk::DeviceSize size, void *data = nullptr) const;
+                                    vk::DeviceSize size, void *data = nullptr,
+                                    MemoryAllocator::Strategy strategy = MemoryAllocator::Strategy::BUDDY) const;
 
         void copyBuffer(engine::Buffer *src, engine::Buffer *dst, vk::Queue queue, vk::BufferCopy *copyRegion = nullptr) const;
 
@@ -60,11 +63,27 @@ namespace engine {
 
         [[nodiscard]] vk::SampleCountFlagBits getMaxUsableSampleCount() const;
 
+    private:
+        // Descriptor indexing with partially bound sampled image arrays written while the frames in flight use them
+        [[nodiscard]] bool supportsBindless() const;
+
+        // Starts from the data saved by the last run when it was written by this driver and device
+        [[nodiscard]] vk::PipelineCache createPipelineCache();
+
+        void savePipelineCache() const;
+
     public:
         vk::PhysicalDevice m_physicalDevice;
         vk::Device m_logicalDevice{};
         vk::CommandPool m_commandPool = nullptr;
+        vk::PipelineCache m_pipelineCache = nullptr;
+        // Started from the data of the last run rather than empty
+        bool m_pipelineCacheWarm = false;
         QueueFamilyIndices m_queueFamilyIndices{};
+        std::unique_ptr<MemoryAllocator> m_allocator;
+        std::unique_ptr<DescriptorLayoutCache> m_layoutCache;
+        // Textures are read from one array indexed by the draws instead of one descriptor set each
+        bool m_bindless{};
     };
 
 } // End namespace vk
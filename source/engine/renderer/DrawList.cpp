@@ -0,0 +1,259 @@
+#include "DrawList.hpp"
+
+#include <tuple>
+#include <chrono>
+#include <future>
+#include <cstddef>
+#include <algorithm>
+
+#include "SecondaryCommands.hpp"
+#include "../Constants.hpp"
+#include "../threads/ThreadPool.hpp"
+
+
+namespace engine {
+
+    DrawList::DrawList() = default;
+
+    DrawList::~DrawList() = default;
+
+    void DrawList::clear() {
+        m_draws.clear();
+        m_palettes.clear();
+        m_boundsX.clear();
+        m_boundsY.clear();
+        m_boundsZ.clear();
+        m_boundsRadius.clear();
+        m_culled = 0;
+        m_cullTime = 0.0f;
+    }
+
+    void DrawList::add(const Draw& draw, const glm::mat4* palette) {
+        m_draws.push_back(draw);
+        m_draws.back().palette = static_cast<uint32_t>(m_palettes.size());
+        m_palettes.insert(m_palettes.end(), palette, palette + 1 + draw.constants.jointCount);
+        m_boundsX.push_back(draw.bounds.x);
+        m_boundsY.push_back(draw.bounds.y);
+        m_boundsZ.push_back(draw.bounds.z);
+        m_boundsRadius.push_back(draw.bounds.w);
+    }
+
+    void DrawList::cull(const Frustum& frustum, ThreadPool& pool) {
+        size_t count = m_draws.size();
+
+        if (count == 0) return;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        m_visible.resize(count);
+
+        size_t batchCount = std::min((count + CULL_BATCH_SPHERES - 1) / CULL_BATCH_SPHERES, pool.getThreads().size() + 1);
+        // Multiple of four so only the last batch has spheres left for the scalar test
+        size_t batchSize = ((count + batchCount - 1) / batchCount + 3) / 4 * 4;
+
+        auto test = [this, &frustum, count, batchSize](size_t batch) {
+            size_t first = std::min(batch * batchSize, count);
+            size_t last = std::min(first + batchSize, count);
+
+            if (first == last) return;
+
+            frustum.intersects(&m_boundsX[first], &m_boundsY[first], &m_boundsZ[first], &m_boundsRadius[first], last - first,
+                               &m_visible[first]);
+        };
+
+        std::vector<std::future<void>> futures;
+
+        for (size_t i = 1; i < batchCount; ++i) futures.push_back(pool.async([&test, i] { test(i); }));
+
+        test(0);
+
+        for (auto& future : futures) future.wait();
+
+        for (auto& future : futures) future.get();
+
+        size_t drawn = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            if (m_visible[i]) m_draws[drawn++] = m_draws[i];
+        }
+
+        m_draws.resize(drawn);
+        m_culled = static_cast<uint32_t>(count - drawn);
+
+        std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+        m_cullTime = time.count();
+    }
+
+    void DrawList::record(SecondaryCommands& commands, ThreadPool& pool, RingBuffer& palettes, const MVP& mvp) {
+        m_stats = {};
+        m_stats.culled = m_culled;
+        m_stats.instances = static_cast<uint32_t>(m_draws.size());
+        m_stats.cullTime = m_cullTime;
+
+        if (m_draws.empty()) return;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        sort();
+        group();
+
+        // Variants are built on their first bind, they must exist before the pipelines are bound from several threads
+        for (auto& group : m_groups) m_draws[group.first].pipeline->getPipeline(m_draws[group.first].variant);
+
+        size_t groupCount = m_groups.size();
+        size_t batchCount = std::min({(groupCount + RECORD_BATCH_DRAWS - 1) / RECORD_BATCH_DRAWS, pool.getThreads().size() + 1,
+                                      static_cast<size_t>(commands.getAvailable())});
+        batchCount = std::max<size_t>(batchCount, 1);
+        size_t batchSize = (groupCount + batchCount - 1) / batchCount;
+
+        // Acquired here so the batches are executed in the sorted order
+        std::vector<vk::CommandBuffer> buffers(batchCount);
+        std::vector<Stats> stats(batchCount);
+        std::vector<std::future<void>> futures;
+
+        for (auto& buffer : buffers) buffer = commands.acquire();
+
+        for (size_t i = 1; i < batchCount; ++i) {
+            futures.push_back(pool.async([this, &palettes, &mvp, &buffers, &stats, i, batchSize, groupCount] {
+                recordRange(buffers[i], palettes, mvp, i * batchSize, std::min((i + 1) * batchSize, groupCount), stats[i]);
+            }));
+        }
+
+        recordRange(buffers[0], palettes, mvp, 0, std::min(batchSize, groupCount), stats[0]);
+
+        // Every batch references the locals, all of them finish before an exception is rethrown
+        for (auto& future : futures) future.wait();
+
+        for (auto& future : futures) future.get();
+
+        for (auto& batch : stats) {
+            m_stats.dropped += batch.dropped;
+            m_stats.draws += batch.draws;
+            m_stats.pipelineBinds += batch.pipelineBinds;
+            m_stats.vertexBufferBinds += batch.vertexBufferBinds;
+            m_stats.indexBufferBinds += batch.indexBufferBinds;
+            m_stats.descriptorSetBinds += batch.descriptorSetBinds;
+        }
+
+        m_stats.batches = static_cast<uint32_t>(batchCount);
+
+        std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+        m_stats.recordTime = time.count();
+    }
+
+    vk::DeviceSize DrawList::getPaletteSize() const {
+        vk::DeviceSize size = 0;
+
+        // Model matrix, node matrix and joints of each instance, see recordRange
+        for (auto& draw : m_draws) size += (2 + draw.constants.jointCount) * sizeof(glm::mat4);
+
+        return size;
+    }
+
+    const DrawList::Stats& DrawList::getStats() const {
+        return m_stats;
+    }
+
+    void DrawList::sort() {
+        // The pipeline follows the vertex layout, sorting on the layout keeps the order well defined. The mesh and the
+        // constants come last so the instances of a group are next to each other
+        auto key = [](const Draw& draw) {
+            return std::make_tuple(draw.mesh->getLayout(), draw.variant, draw.mesh->getVertexPage(), draw.mesh->getIndexType(),
+                                   draw.mesh->getIndexPage(), static_cast<VkDescriptorSet>(draw.textureSet), draw.mesh,
+                                   draw.constants.jointCount, draw.constants.textureIndex);
+        };
+
+        std::sort(m_draws.begin(), m_draws.end(), [&key](const Draw& a, const Draw& b) { return key(a) < key(b); });
+    }
+
+    void DrawList::group() {
+        m_groups.clear();
+
+        for (size_t i = 0; i < m_draws.size(); ++i) {
+            const Draw& draw = m_draws[i];
+
+            if (!m_groups.empty()) {
+                const Draw& first = m_draws[m_groups.back().first];
+
+                if (draw.pipeline == first.pipeline && draw.variant == first.variant && draw.mesh == first.mesh
+                    && draw.textureSet == first.textureSet && draw.constants.jointCount == first.constants.jointCount
+                    && draw.constants.textureIndex == first.constants.textureIndex) {
+                    m_groups.back().count++;
+                    continue;
+                }
+            }
+
+            m_groups.push_back({i, 1});
+        }
+    }
+
+    void DrawList::recordRange(const vk::CommandBuffer& cmdBuffer, RingBuffer& palettes, const MVP& mvp, size_t first, size_t last,
+                               Stats& stats) const {
+        if (first >= last) return;
+
+        vk::PipelineLayout layout = m_draws[m_groups[first].first].pipeline->getLayout();
+        cmdBuffer.pushConstants(layout, vk::ShaderStageFlagBits::eVertex, 0, offsetof(MVP, model), &mvp);
+
+        GraphicsPipeline* pipeline = nullptr;
+        uint32_t variant = 0;
+        vk::Buffer vertexBuffer{};
+        vk::Buffer indexBuffer{};
+        vk::IndexType indexType{};
+        vk::DescriptorSet textureSet{};
+
+        for (size_t g = first; g < last; ++g) {
+            const Group& group = m_groups[g];
+            const Draw& draw = m_draws[group.first];
+
+            // Model matrix, node matrix and joints of each instance, in the order of gl_InstanceIndex
+            uint32_t blockSize = 2 + draw.constants.jointCount;
+            uint32_t offset = palettes.allocate(static_cast<vk::DeviceSize>(group.count) * blockSize * sizeof(glm::mat4));
+
+            if (offset == RingBuffer::INVALID_OFFSET) {
+                stats.dropped += group.count;
+                continue;
+            }
+
+            for (uint32_t i = 0; i < group.count; ++i) {
+                const Draw& instance = m_draws[group.first + i];
+                uint32_t block = offset + i * blockSize * static_cast<uint32_t>(sizeof(glm::mat4));
+
+                palettes.write(block, &instance.model, sizeof(glm::mat4));
+                palettes.write(block + sizeof(glm::mat4), &m_palettes[instance.palette], (blockSize - 1) * sizeof(glm::mat4));
+            }
+
+            if (draw.pipeline != pipeline || draw.variant != variant) {
+                pipeline = draw.pipeline;
+                variant = draw.variant;
+                pipeline->bind(cmdBuffer, variant);
+                stats.pipelineBinds++;
+            }
+
+            if (draw.mesh->getVertexBuffer() != vertexBuffer) {
+                vertexBuffer = draw.mesh->getVertexBuffer();
+                vk::DeviceSize vertexOffset = 0;
+                cmdBuffer.bindVertexBuffers(0, 1, &vertexBuffer, &vertexOffset);
+                stats.vertexBufferBinds++;
+            }
+
+            if (draw.mesh->getIndexBuffer() != indexBuffer || draw.mesh->getIndexType() != indexType) {
+                indexBuffer = draw.mesh->getIndexBuffer();
+                indexType = draw.mesh->getIndexType();
+                cmdBuffer.bindIndexBuffer(indexBuffer, 0, indexType);
+                stats.indexBufferBinds++;
+            }
+
+            if (draw.textureSet != textureSet) {
+                textureSet = draw.textureSet;
+                cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->getLayout(), 1, 1, &textureSet, 0, nullptr);
+                stats.descriptorSetBinds++;
+            }
+
+            DrawConstants constants = draw.constants;
+            constants.paletteOffset = static_cast<uint32_t>(offset / sizeof(glm::mat4));
+            cmdBuffer.pushConstants(pipeline->getLayout(), vk::ShaderStageFlagBits::eVertex, offsetof(MVP, model), sizeof(DrawConstants),
+                                    &constants);
+            cmdBuffer.drawIndexed(draw.mesh->getIndexCount(), group.count, draw.mesh->getFirstIndex(), draw.mesh->getVertexOffset(), 0);
+            stats.draws++;
+        }
+    }
+
+} // namespace engine
@@ -0,0 +1,122 @@
+#ifndef PROTOTYPE_ACTION_RPG_DRAWLIST_HPP
+#define PROTOTYPE_ACTION_RPG_DRAWLIST_HPP
+
+
+#include <limits>
+#include <vector>
+#include <cstdint>
+
+#include "glm/glm.hpp"
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include "vulkan/vulkan.hpp"
+
+#include "RingBuffer.hpp"
+#include "GraphicsPipeline.hpp"
+#include "../camera/Frustum.hpp"
+#include "../Utilities.hpp"
+#include "../mesh/Mesh.hpp"
+
+
+namespace engine {
+
+    class ThreadPool;
+    class SecondaryCommands;
+
+    // Draws of a frame collected from every model, recorded sorted by pipeline, geometry pages and texture so each
+    // state is bound once per run of draws sharing it instead of once per mesh. Draws of the same mesh, texture and
+    // variant are one instanced draw
+    class DrawList {
+    public:
+        struct Draw {
+            GraphicsPipeline* pipeline{};
+            uint32_t variant{};
+            // Owned by the resource manager, meshes are only destroyed between two frames
+            const Mesh* mesh{};
+            vk::DescriptorSet textureSet{};
+            glm::mat4 model{1.0f};
+            // Index of the node matrix in the palettes of the list, its jointCount joint matrices follow it. Set by add
+            uint32_t palette{};
+            // The palette offset is written when the instances are grouped
+            DrawConstants constants{};
+            // World space sphere, the default one is never culled
+            glm::vec4 bounds{0.0f, 0.0f, 0.0f, std::numeric_limits<float>::max()};
+        };
+
+        // Commands recorded by the last record call, summed over its batches
+        struct Stats {
+            uint32_t culled{};
+            // Instances left undrawn because the palette ring segment of the frame was full
+            uint32_t dropped{};
+            // Draws left after culling, each one would be a draw call without instancing
+            uint32_t instances{};
+            uint32_t draws{};
+            uint32_t pipelineBinds{};
+            uint32_t vertexBufferBinds{};
+            uint32_t indexBufferBinds{};
+            uint32_t descriptorSetBinds{};
+            // Secondary buffers recorded, one per batch
+            uint32_t batches{};
+            // Wall time of the cull and record calls, in milliseconds
+            float cullTime{};
+            float recordTime{};
+        };
+
+    public:
+        DrawList();
+
+        ~DrawList();
+
+        void clear();
+
+        // The node matrix and the joint matrices of the draw are copied, the palette can be built again once add returns
+        void add(const Draw& draw, const glm::mat4* palette);
+
+        // Removes the draws whose bounds are outside the frustum, split in batches of at least CULL_BATCH_SPHERES tested
+        // on the calling thread and the workers of the pool
+        void cull(const Frustum& frustum, ThreadPool& pool);
+
+        // Instanced draws split in batches of at least RECORD_BATCH_DRAWS, each one recorded into its own secondary buffer.
+        // The first batch is recorded on the calling thread, the others on the workers of the pool. The model, node and
+        // joint matrices of every instance are written to the ring of the frame
+        void record(SecondaryCommands& commands, ThreadPool& pool, RingBuffer& palettes, const MVP& mvp);
+
+        // Bytes the draws left write to the palette ring when they are recorded
+        [[nodiscard]] vk::DeviceSize getPaletteSize() const;
+
+        [[nodiscard]] const Stats& getStats() const;
+
+    private:
+        // Draws sharing every state and constant but the palette, recorded as the instances of one draw
+        struct Group {
+            size_t first{};
+            uint32_t count{};
+        };
+
+    private:
+        void sort();
+
+        void group();
+
+        // The projection and view of the MVP are pushed once, the constants with each group
+        void recordRange(const vk::CommandBuffer& cmdBuffer, RingBuffer& palettes, const MVP& mvp, size_t first, size_t last,
+                         Stats& stats) const;
+
+    private:
+        std::vector<Draw> m_draws;
+        std::vector<Group> m_groups;
+        std::vector<glm::mat4> m_palettes;
+        // Bounds of the draws split by component for the frustum test
+        std::vector<float> m_boundsX;
+        std::vector<float> m_boundsY;
+        std::vector<float> m_boundsZ;
+        std::vector<float> m_boundsRadius;
+        std::vector<uint8_t> m_visible;
+        uint32_t m_culled{};
+        float m_cullTime{};
+        Stats m_stats{};
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_DRAWLIST_HPP
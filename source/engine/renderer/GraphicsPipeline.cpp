@@ -1,8 +1,13 @@
 #include "GraphicsPipeline.hpp"
 
 #include <utility>
+#include <chrono>
+#include <algorithm>
+
+#include "spdlog/spdlog.h"
 
 #include "SwapChain.hpp"
+#include "DescriptorLayoutCache.hpp"
 #include "../Utilities.hpp"
 #include "../Application.hpp"
 #include "../resources/Shader.hpp"
@@ -10,13 +15,54 @@
 
 namespace engine {
 
-    GraphicsPipeline::GraphicsPipeline(std::shared_ptr<Shader> shader, const vk::Device& device)
-            : m_shader(std::move(shader)), m_device(device) {
+    GraphicsPipeline::GraphicsPipeline(std::shared_ptr<Shader> shader, const vk::Device& device, DescriptorLayoutCache* layoutCache,
+                                       vk::PipelineCache cache)
+            : m_shader(std::move(shader)), m_device(device), m_layoutCache(layoutCache), m_cache(cache) {
 
     }
 
     void GraphicsPipeline::create(const std::vector<vk::DescriptorSetLayout>& layouts, const engine::SwapChain& swapChain,
                                   const vk::RenderPass& renderPass, vk::SampleCountFlagBits sampleCount) {
+        m_setLayouts = layouts;
+        m_swapChain = &swapChain;
+        m_renderPass = renderPass;
+        m_sampleCount = sampleCount;
+
+        std::vector<vk::DescriptorSetLayout> setLayouts = layouts;
+
+        for (uint32_t set = 0; set < m_shader->getSetCount(); ++set) {
+            std::vector<vk::DescriptorSetLayoutBinding> bindings = m_shader->getSetBindings(set);
+
+            if (set >= setLayouts.size()) {
+                setLayouts.push_back(m_layoutCache->getSetLayout(bindings));
+                continue;
+            }
+
+            const auto* declared = m_layoutCache->getBindings(setLayouts[set]);
+
+            if (!declared) continue;
+
+            for (auto& binding : bindings) {
+                auto it = std::find_if(declared->begin(), declared->end(), [&](const auto& b) { return b.binding == binding.binding; });
+
+                if (it == declared->end() || it->descriptorType != binding.descriptorType || it->descriptorCount < binding.descriptorCount
+                        || (it->stageFlags & binding.stageFlags) != binding.stageFlags) {
+                    spdlog::error("[Pipeline] Set {} binding {} of the shader does not match the given layout", set, binding.binding);
+                }
+            }
+        }
+
+        m_layout = m_layoutCache->getPipelineLayout(setLayouts, m_shader->getPushConstants());
+
+        // Variants used before a recreation are built again with the new state
+        m_variants[0] = nullptr;
+
+        for (auto& variant : m_variants) variant.second = createVariant(variant.first);
+
+        m_pipeline = m_variants[0];
+    }
+
+    vk::Pipeline GraphicsPipeline::createVariant(uint32_t variant) {
         auto attributes = m_shader->getAttributes();
 
         vk::PipelineVertexInputStateCreateInfo vertexInputInfo{
@@ -31,25 +77,19 @@ namespace engine {
                 .primitiveRestartEnable = VK_FALSE
         };
 
-        vk::Viewport viewport{
-                .x = 0.0f,
-                .y = 0.0f,
-                .width = static_cast<float>(swapChain.getExtent().width),
-                .height = static_cast<float>(swapChain.getExtent().height),
-                .minDepth = 0.0f,
-                .maxDepth = 1.0f
-        };
-
-        vk::Rect2D scissor{
-                .offset = {0, 0},
-                .extent = swapChain.getExtent()
-        };
-
+        // Set with the extent of the swapchain when the render pass begins
         vk::PipelineViewportStateCreateInfo viewportState{
                 .viewportCount = 1,
-                .pViewports = &viewport,
+                .pViewports = nullptr,
                 .scissorCount = 1,
-                .pScissors = &scissor,
+                .pScissors = nullptr,
+        };
+
+        std::array<vk::DynamicState, 2> dynamicStates = {vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+
+        vk::PipelineDynamicStateCreateInfo dynamicState{
+                .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
+                .pDynamicStates = dynamicStates.data()
         };
 
         vk::PipelineRasterizationStateCreateInfo rasterizer{
@@ -66,7 +106,7 @@ namespace engine {
         };
 
         vk::PipelineMultisampleStateCreateInfo multisampling{
-                .rasterizationSamples = sampleCount,
+                .rasterizationSamples = m_sampleCount,
                 .sampleShadingEnable = VK_FALSE,
                 .minSampleShading = 1.0f,
                 .pSampleMask = nullptr,
@@ -94,15 +134,6 @@ namespace engine {
                 .blendConstants = {{0.0f, 0.0f, 0.0f, 0.0}}
         };
 
-        auto pushConstants = m_shader->getPushConstants();
-
-        m_layout = m_device.createPipelineLayout({
-            .setLayoutCount = static_cast<uint32_t>(layouts.size()),
-            .pSetLayouts = layouts.empty() ? nullptr : layouts.data(),
-            .pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size()),
-            .pPushConstantRanges = pushConstants.data()
-        });
-
         vk::PipelineDepthStencilStateCreateInfo depthStencil{
                 .depthTestEnable = VK_TRUE,
                 .depthWriteEnable = VK_TRUE,
@@ -113,9 +144,30 @@ namespace engine {
                 .maxDepthBounds = 1.0f,
         };
 
+        // Bit i of the variant is the boolean specialization constant i, constants a stage does not declare are ignored
+        std::array<vk::Bool32, MAX_VARIANT_CONSTANTS> constants{};
+        std::array<vk::SpecializationMapEntry, MAX_VARIANT_CONSTANTS> entries{};
+
+        for (uint32_t i = 0; i < MAX_VARIANT_CONSTANTS; ++i) {
+            constants[i] = (variant >> i) & 1u;
+            entries[i] = {.constantID = i, .offset = static_cast<uint32_t>(i * sizeof(vk::Bool32)), .size = sizeof(vk::Bool32)};
+        }
+
+        vk::SpecializationInfo specialization{
+                .mapEntryCount = static_cast<uint32_t>(entries.size()),
+                .pMapEntries = entries.data(),
+                .dataSize = sizeof(constants),
+                .pData = constants.data()
+        };
+
         auto shaderStages = m_shader->getShaderstages();
+
+        for (auto& stage : shaderStages) stage.pSpecializationInfo = &specialization;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        vk::Pipeline pipeline;
         vk::Result result;
-        std::tie(result, m_pipeline) = m_device.createGraphicsPipeline(nullptr, {
+        std::tie(result, pipeline) = m_device.createGraphicsPipeline(m_cache, {
                 .stageCount = static_cast<uint32_t>(shaderStages.size()),
                 .pStages = shaderStages.data(),
                 .pVertexInputState = &vertexInputInfo,
@@ -125,32 +177,75 @@ namespace engine {
                 .pMultisampleState = &multisampling,
                 .pDepthStencilState = &depthStencil,
                 .pColorBlendState = &colorBlending,
-                .pDynamicState = nullptr,
+                .pDynamicState = &dynamicState,
                 .layout = m_layout,
-                .renderPass = renderPass,
+                .renderPass = m_renderPass,
                 .subpass = 0,
                 .basePipelineHandle = nullptr,
                 .basePipelineIndex = -1
         });
 
         VK_CHECK_RESULT_HPP(result)
+
+        std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+        spdlog::info("[Pipeline] Variant {} created in {:.2f} ms{}", variant, time.count(), m_cache ? "" : " without cache");
+
+        return pipeline;
+    }
+
+    void GraphicsPipeline::recreate() {
+        if (!m_swapChain) return;
+
+        cleanup();
+        create(m_setLayouts, *m_swapChain, m_renderPass, m_sampleCount);
+    }
+
+    void GraphicsPipeline::recreate(const vk::RenderPass& renderPass) {
+        m_renderPass = renderPass;
+
+        recreate();
     }
 
     void GraphicsPipeline::cleanup() {
-        m_device.destroy(m_pipeline);
-        m_device.destroy(m_layout);
+        for (auto& variant : m_variants) {
+            m_device.destroy(variant.second);
+            variant.second = nullptr;
+        }
+
+        // Owned by the layout cache
+        m_pipeline = nullptr;
+        m_layout = nullptr;
     }
 
-    void GraphicsPipeline::bind(const vk::CommandBuffer& cmdBuffer) {
-        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipeline);
+    void GraphicsPipeline::addVariant(uint32_t variant) {
+        if (m_variants.contains(variant)) return;
+
+        m_variants[variant] = m_layout ? createVariant(variant) : nullptr;
     }
 
-    vk::Pipeline GraphicsPipeline::getPipeline() {
-        return m_pipeline;
+    void GraphicsPipeline::bind(const vk::CommandBuffer& cmdBuffer, uint32_t variant) {
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, getPipeline(variant));
+    }
+
+    vk::Pipeline GraphicsPipeline::getPipeline(uint32_t variant) {
+        if (variant == 0) return m_pipeline;
+
+        auto it = m_variants.find(variant);
+
+        if (it == m_variants.end() || !it->second) {
+            addVariant(variant);
+            it = m_variants.find(variant);
+        }
+
+        return it->second;
     }
 
     vk::PipelineLayout GraphicsPipeline::getLayout() {
         return m_layout;
     }
 
+    std::shared_ptr<Shader> GraphicsPipeline::getShader() {
+        return m_shader;
+    }
+
 } // namespace vkc
\ No newline at end of file
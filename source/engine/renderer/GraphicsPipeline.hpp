@@ -4,6 +4,7 @@
 
 #include <string>
 #include <array>
+#include <unordered_map>
 
 #define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
 #include "vulkan/vulkan.hpp"
@@ -13,27 +14,59 @@ namespace engine {
 
     class Shader;
     class SwapChain;
+    class DescriptorLayoutCache;
 
+    // Variants of a pipeline only differ by the boolean specialization constants of its shaders, they share its layout
     class GraphicsPipeline {
     public:
-        GraphicsPipeline(std::shared_ptr<Shader> shader, const vk::Device& device);
+        static constexpr uint32_t MAX_VARIANT_CONSTANTS = 4;
+        // Mesh with a skin, model.vert only reads joints in this variant
+        static constexpr uint32_t VARIANT_SKINNED = 1u << 0;
 
+    public:
+        GraphicsPipeline(std::shared_ptr<Shader> shader, const vk::Device& device, DescriptorLayoutCache* layoutCache,
+                         vk::PipelineCache cache = nullptr);
+
+        // Viewport and scissor are dynamic state, the pipeline is kept when the swapchain is resized. The given layouts are
+        // used for the first sets and checked against the shader, the layouts of the next sets come from its reflection
         void create(const std::vector<vk::DescriptorSetLayout>& layouts, const engine::SwapChain& swapChain,
                     const vk::RenderPass& renderPass, vk::SampleCountFlagBits sampleCount);
 
+        // Rebuilds the pipeline with the arguments of the last create, after its shader modules changed
+        void recreate();
+
+        // Rebuilds the pipeline for a render pass that is not compatible with the previous one
+        void recreate(const vk::RenderPass& renderPass);
+
         void cleanup();
 
-        void bind(const vk::CommandBuffer& cmdBuffer);
+        // Built now when the pipeline is created, otherwise with it
+        void addVariant(uint32_t variant);
 
-        vk::Pipeline getPipeline();
+        void bind(const vk::CommandBuffer& cmdBuffer, uint32_t variant = 0);
+
+        // A variant not added before is built on its first use
+        vk::Pipeline getPipeline(uint32_t variant = 0);
 
         vk::PipelineLayout getLayout();
 
+        std::shared_ptr<Shader> getShader();
+
+    private:
+        vk::Pipeline createVariant(uint32_t variant);
+
     private:
         vk::Pipeline m_pipeline;
         vk::PipelineLayout m_layout;
         vk::Device m_device;
+        DescriptorLayoutCache* m_layoutCache{};
+        vk::PipelineCache m_cache;
         std::shared_ptr<Shader> m_shader;
+        std::vector<vk::DescriptorSetLayout> m_setLayouts;
+        const engine::SwapChain* m_swapChain{};
+        vk::RenderPass m_renderPass{};
+        vk::SampleCountFlagBits m_sampleCount{vk::SampleCountFlagBits::e1};
+        std::unordered_map<uint32_t, vk::Pipeline> m_variants;
     };
 
 } // namespace vkc
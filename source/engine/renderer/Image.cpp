@@ -15,13 +15,13 @@ namespace engine {
 
     Image::~Image() = default;
 
-    void Image::bind(vk::Device logicalDevice, uint32_t memoryTypeIndex, vk::DeviceSize size, vk::ImageAspectFlagBits aspectFlags) {
-        m_memory = logicalDevice.allocateMemory({
-            .allocationSize = size,
-            .memoryTypeIndex = memoryTypeIndex
-        });
+    void Image::bind(MemoryAllocator& allocator, vk::Device logicalDevice, vk::MemoryPropertyFlags properties,
+                     vk::ImageAspectFlagBits aspectFlags, bool dedicated) {
+        m_allocator = &allocator;
+        m_allocation = allocator.allocate(logicalDevice.getImageMemoryRequirements(m_image), properties, true,
+                                          MemoryAllocator::Strategy::BUDDY, dedicated);
 
-        logicalDevice.bindImageMemory(m_image, m_memory, 0);
+        logicalDevice.bindImageMemory(m_image, m_allocation.memory, m_allocation.offset);
 
         // Create an image view after the image has been bound to GPU memory
         vk::ImageViewCreateInfo viewInfo{
@@ -43,7 +43,8 @@ namespace engine {
     void Image::cleanup(vk::Device logicalDevice) {
         logicalDevice.destroy(m_view);
         logicalDevice.destroy(m_image);
-        logicalDevice.free(m_memory);
+
+        if (m_allocator) m_allocator->free(m_allocation);
     }
 
     vk::Format Image::getFormat() const {
@@ -70,6 +71,10 @@ namespace engine {
         return m_mipLevels;
     }
 
+    vk::DeviceSize Image::getMemorySize() const {
+        return m_allocation.size;
+    }
+
     void Image::createImageView(vk::Device logicalDevice, vk::ImageAspectFlagBits aspectFlags) {
 
     }
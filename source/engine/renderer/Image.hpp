@@ -5,6 +5,8 @@
 #define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
 #include "vulkan/vulkan.hpp"
 
+#include "MemoryAllocator.hpp"
+
 
 namespace engine {
 
@@ -16,7 +18,8 @@ namespace engine {
 
         ~Image();
 
-        void bind(vk::Device logicalDevice, uint32_t memoryTypeIndex, vk::DeviceSize size, vk::ImageAspectFlagBits aspectFlags);
+        void bind(MemoryAllocator& allocator, vk::Device logicalDevice, vk::MemoryPropertyFlags properties,
+                  vk::ImageAspectFlagBits aspectFlags, bool dedicated = false);
 
         void cleanup(vk::Device logicalDevice);
 
@@ -32,6 +35,8 @@ namespace engine {
 
         [[nodiscard]] uint32_t getMipLevel() const;
 
+        [[nodiscard]] vk::DeviceSize getMemorySize() const;
+
     private:
 
         void createImageView(vk::Device logicalDevice, vk::ImageAspectFlagBits aspectFlags);
@@ -40,7 +45,8 @@ namespace engine {
         vk::Image m_image = {};
         vk::ImageView m_view = {};
         vk::Format m_format = {};
-        vk::DeviceMemory m_memory = {};
+        MemoryAllocator* m_allocator = nullptr;
+        MemoryAllocator::Allocation m_allocation{};
         vk::Extent3D m_extent = {};
         uint32_t m_mipLevels = 1;
     };
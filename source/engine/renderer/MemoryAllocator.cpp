@@ -0,0 +1,183 @@
+#include "MemoryAllocator.hpp"
+
+#include <algorithm>
+
+#include "fmt/format.h"
+#include "spdlog/spdlog.h"
+
+
+const uint64_t MIN_BUDDY_BLOCK_SIZE = 256;
+
+inline uint32_t poolKey(uint32_t memoryType, bool image, engine::MemoryAllocator::Strategy strategy) {
+    return (memoryType << 2) | (image ? 2u : 0u) | (strategy == engine::MemoryAllocator::Strategy::LINEAR ? 1u : 0u);
+}
+
+namespace engine {
+
+    MemoryAllocator::MemoryAllocator() = default;
+
+    MemoryAllocator::~MemoryAllocator() = default;
+
+    void MemoryAllocator::create(vk::PhysicalDevice physicalDevice, vk::Device logicalDevice, vk::DeviceSize blockSize) {
+        m_logicalDevice = logicalDevice;
+        m_memoryProperties = physicalDevice.getMemoryProperties();
+        m_blockSize = blockSize;
+    }
+
+    void MemoryAllocator::cleanup() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for (auto& [key, pool] : m_pools) {
+            for (auto& block : pool.blocks) m_logicalDevice.free(block->memory);
+        }
+
+        if (m_stats.dedicated > 0) spdlog::warn("[Memory] {} dedicated allocations still alive at cleanup", m_stats.dedicated);
+
+        m_pools.clear();
+        m_stats = {};
+    }
+
+    MemoryAllocator::Allocation MemoryAllocator::allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties,
+                                                          bool image, Strategy strategy, bool dedicated) {
+        uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+        uint32_t key = poolKey(memoryType, image, strategy);
+        Allocation allocation{
+            .size = requirements.size,
+            .pool = key
+        };
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_stats.allocations++;
+
+        // Render targets and anything bigger than half a block get their own memory
+        if (dedicated || requirements.size > m_blockSize / 2) {
+            allocation.memory = allocateMemory(requirements.size, memoryType, &allocation.mapped);
+            m_stats.dedicated++;
+            m_stats.reserved += requirements.size;
+            m_stats.used += requirements.size;
+
+            return allocation;
+        }
+
+        Pool& pool = m_pools[key];
+        pool.memoryType = memoryType;
+        pool.hostVisible = static_cast<bool>(m_memoryProperties.memoryTypes[memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible);
+        pool.strategy = strategy;
+
+        for (auto& block : pool.blocks) {
+            bool found = block->buddy ? block->buddy->allocate(requirements.size, requirements.alignment, allocation.offset) :
+                         block->linear->allocate(requirements.size, requirements.alignment, allocation.offset);
+
+            if (found) {
+                allocation.block = block.get();
+                break;
+            }
+        }
+
+        if (!allocation.block) {
+            auto block = std::make_unique<Block>();
+            block->memory = allocateMemory(m_blockSize, memoryType, pool.hostVisible ? &block->mapped : nullptr);
+
+            bool found;
+
+            if (strategy == Strategy::BUDDY) {
+                block->buddy = std::make_unique<BuddyAllocator>(m_blockSize, MIN_BUDDY_BLOCK_SIZE);
+                found = block->buddy->allocate(requirements.size, requirements.alignment, allocation.offset);
+            } else {
+                block->linear = std::make_unique<LinearAllocator>(m_blockSize);
+                found = block->linear->allocate(requirements.size, requirements.alignment, allocation.offset);
+            }
+
+            // An alignment larger than the block does not fit even in an empty one
+            if (!found) {
+                m_logicalDevice.free(block->memory);
+                m_stats.allocations--;
+
+                throw std::runtime_error(fmt::format("Failed to allocate {} bytes aligned to {} in a new memory block of {} bytes",
+                                                     requirements.size, requirements.alignment, m_blockSize));
+            }
+
+            allocation.block = block.get();
+            pool.blocks.push_back(std::move(block));
+            m_stats.blocks++;
+            m_stats.reserved += m_blockSize;
+        }
+
+        allocation.memory = allocation.block->memory;
+
+        if (allocation.block->mapped) allocation.mapped = static_cast<char*>(allocation.block->mapped) + allocation.offset;
+
+        m_stats.used += requirements.size;
+
+        return allocation;
+    }
+
+    void MemoryAllocator::free(const Allocation& allocation) {
+        if (!allocation.memory) return;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_stats.allocations--;
+        m_stats.used -= allocation.size;
+
+        if (!allocation.block) {
+            m_logicalDevice.free(allocation.memory);
+            m_stats.dedicated--;
+            m_stats.reserved -= allocation.size;
+
+            return;
+        }
+
+        Block* block = allocation.block;
+        block->buddy ? block->buddy->free(allocation.offset) : block->linear->free(allocation.offset);
+
+        // Keep the first block of every pool around, the others go back to the driver once empty
+        Pool& pool = m_pools[allocation.pool];
+        bool empty = block->buddy ? block->buddy->empty() : block->linear->empty();
+
+        if (empty && pool.blocks.size() > 1 && pool.blocks.front().get() != block) {
+            m_logicalDevice.free(block->memory);
+            std::erase_if(pool.blocks, [block](const std::unique_ptr<Block>& b) { return b.get() == block; });
+            m_stats.blocks--;
+            m_stats.reserved -= m_blockSize;
+        }
+    }
+
+    MemoryAllocator::Stats MemoryAllocator::getStats() const {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        return m_stats;
+    }
+
+    void MemoryAllocator::logStats() const {
+        Stats stats = getStats();
+
+        spdlog::info("[Memory] {} allocations in {} blocks and {} dedicated, {:.1f} MB used of {:.1f} MB reserved",
+                     stats.allocations, stats.blocks, stats.dedicated, static_cast<float>(stats.used) / (1024.0f * 1024.0f),
+                     static_cast<float>(stats.reserved) / (1024.0f * 1024.0f));
+    }
+
+    uint32_t MemoryAllocator::findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties) const {
+        for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+            if ((typeBits & (1 << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+                return i;
+        }
+
+        throw std::runtime_error("Failed to find suitable memory type");
+    }
+
+    vk::DeviceMemory MemoryAllocator::allocateMemory(vk::DeviceSize size, uint32_t memoryType, void** mapped) {
+        vk::DeviceMemory memory = m_logicalDevice.allocateMemory({
+            .allocationSize = size,
+            .memoryTypeIndex = memoryType
+        });
+
+        if (mapped && (m_memoryProperties.memoryTypes[memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)) {
+            *mapped = m_logicalDevice.mapMemory(memory, 0, VK_WHOLE_SIZE);
+        }
+
+        return memory;
+    }
+
+} // namespace engine
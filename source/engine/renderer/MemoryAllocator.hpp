@@ -0,0 +1,93 @@
+#ifndef PROTOTYPE_ACTION_RPG_MEMORYALLOCATOR_HPP
+#define PROTOTYPE_ACTION_RPG_MEMORYALLOCATOR_HPP
+
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include "vulkan/vulkan.hpp"
+
+#include "BlockAllocator.hpp"
+
+
+namespace engine {
+
+    class MemoryAllocator {
+    public:
+        enum class Strategy { BUDDY, LINEAR };
+
+        struct Block {
+            vk::DeviceMemory memory{};
+            void* mapped{};
+            std::unique_ptr<BuddyAllocator> buddy;
+            std::unique_ptr<LinearAllocator> linear;
+        };
+
+        struct Allocation {
+            vk::DeviceMemory memory{};
+            vk::DeviceSize offset{};
+            vk::DeviceSize size{};
+            // Host visible blocks stay mapped for their whole life
+            void* mapped{};
+            uint32_t pool{};
+            // nullptr for dedicated allocations
+            Block* block{};
+        };
+
+        struct Stats {
+            uint32_t blocks{};
+            uint32_t dedicated{};
+            uint32_t allocations{};
+            vk::DeviceSize reserved{};
+            vk::DeviceSize used{};
+        };
+
+    public:
+        MemoryAllocator();
+
+        ~MemoryAllocator();
+
+        void create(vk::PhysicalDevice physicalDevice, vk::Device logicalDevice, vk::DeviceSize blockSize);
+
+        void cleanup();
+
+        // Buffers and images use separate pools, so bufferImageGranularity never has to be checked between neighbours
+        Allocation allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, bool image,
+                            Strategy strategy = Strategy::BUDDY, bool dedicated = false);
+
+        void free(const Allocation& allocation);
+
+        [[nodiscard]] Stats getStats() const;
+
+        void logStats() const;
+
+    private:
+        struct Pool {
+            uint32_t memoryType{};
+            bool hostVisible{};
+            Strategy strategy{};
+            std::vector<std::unique_ptr<Block>> blocks;
+        };
+
+    private:
+        [[nodiscard]] uint32_t findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties) const;
+
+        vk::DeviceMemory allocateMemory(vk::DeviceSize size, uint32_t memoryType, void** mapped);
+
+    private:
+        vk::Device m_logicalDevice{};
+        vk::PhysicalDeviceMemoryProperties m_memoryProperties{};
+        vk::DeviceSize m_blockSize{};
+        std::map<uint32_t, Pool> m_pools;
+        Stats m_stats{};
+        mutable std::mutex m_mutex;
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_MEMORYALLOCATOR_HPP
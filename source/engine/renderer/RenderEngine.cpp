@@ -1,6 +1,7 @@
 #include "RenderEngine.hpp"
 
 #include <utility>
+#include <chrono>
 
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include "glm/glm.hpp"
@@ -52,9 +53,17 @@ namespace engine {
     RenderEngine::~RenderEngine() = default;
 
     void RenderEngine::init() {
+        m_startupStart = std::chrono::high_resolution_clock::now();
+
         createRenderPass();
         createDescriptorSetLayout();
+
+        auto start = std::chrono::high_resolution_clock::now();
         createGraphicsPipeline();
+        std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+        spdlog::info("[Renderer] {} pipelines created in {:.2f} ms, {} pipeline cache", m_pipelines.size(), time.count(),
+                     m_device->m_pipelineCacheWarm ? "warm" : "cold");
+
         createMsaaResources();
         createDepthResources();
         createFramebuffers();
@@ -70,11 +79,13 @@ namespace engine {
 
         cleanSwapChain();
 
-        instance->destroy(m_swapChain.getSurface());
+        for (auto& pipeline : m_pipelines) pipeline->cleanup();
+
+        m_logicalDevice.destroy(m_renderPass);
 
-        m_logicalDevice.destroy(m_descriptorSetLayout);
+        instance->destroy(m_swapChain.getSurface());
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
             m_logicalDevice.destroy(m_imageAvailableSemaphores[i]);
             m_logicalDevice.destroy(m_renderFinishedSemaphores[i]);
             m_logicalDevice.destroy(m_fences[i]);
@@ -88,6 +99,8 @@ namespace engine {
     }
 
     void RenderEngine::acquireNextImage() {
+        auto start = std::chrono::high_resolution_clock::now();
+
         VK_CHECK_RESULT_HPP(waitForFence(m_logicalDevice, &m_fences[m_currentFrame]))
 
         vk::Result result = m_swapChain.acquireNextImage(m_imageAvailableSemaphores[m_currentFrame], &m_indexImage);
@@ -103,6 +116,8 @@ namespace engine {
         VK_CHECK_RESULT_HPP(waitForFence(m_logicalDevice, &m_imageFences[m_indexImage]))
 
         m_imageFences[m_indexImage] = m_fences[m_currentFrame];
+
+        updateFrameStats(start);
     }
 
     void RenderEngine::render() {
@@ -146,11 +161,57 @@ namespace engine {
             recreateSwapchain();
         } else if (result != vk::Result::eSuccess) {
             throw std::runtime_error("Failed to present swap chain image");
+        } else {
+            logPresentLatency();
         }
 
         m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
     }
 
+    void RenderEngine::logPresentLatency() {
+        if (!m_startupLogged) {
+            m_startupLogged = true;
+            std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - m_startupStart;
+            spdlog::info("[Renderer] First frame presented {:.2f} ms after init, {} pipeline cache", time.count(),
+                         m_device->m_pipelineCacheWarm ? "warm" : "cold");
+        }
+
+        if (m_resizing) {
+            m_resizing = false;
+            std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - m_resizeStart;
+            spdlog::info("[Renderer] First frame after the resize presented in {:.2f} ms", time.count());
+        }
+    }
+
+    void RenderEngine::updateFrameStats(std::chrono::high_resolution_clock::time_point waitStart) {
+        auto now = std::chrono::high_resolution_clock::now();
+
+        if (m_statsFrames++ > 0) {
+            std::chrono::duration<float, std::milli> frame = now - m_frameStart;
+            std::chrono::duration<float, std::milli> wait = now - waitStart;
+
+            m_frameTime += frame.count();
+            m_waitTime += wait.count();
+        }
+
+        m_frameStart = now;
+
+        if (m_statsFrames <= FRAME_STATS_INTERVAL) return;
+
+        // Share of the frame the CPU spends outside the fence wait. It is not a measure of the overlap with the GPU, which
+        // would need GPU timestamps, but it drops towards 0 when the GPU is the bottleneck and the CPU waits on every frame
+        float frameTime = m_frameTime / FRAME_STATS_INTERVAL;
+        float waitTime = m_waitTime / FRAME_STATS_INTERVAL;
+
+        spdlog::info("[Renderer] {} frames in flight: frame {:.2f} ms, CPU {:.2f} ms, fence wait {:.2f} ms, CPU busy {:.0f}%",
+                     MAX_FRAMES_IN_FLIGHT, frameTime, frameTime - waitTime, waitTime,
+                     frameTime > 0.0f ? 100.0f * (frameTime - waitTime) / frameTime : 0.0f);
+
+        m_statsFrames = 1;
+        m_frameTime = 0.0f;
+        m_waitTime = 0.0f;
+    }
+
     void RenderEngine::createRenderPass() {
         vk::AttachmentDescription colorAttachment{
             .format = m_swapChain.getFormat(),
@@ -265,7 +326,7 @@ namespace engine {
         m_fences.resize(MAX_FRAMES_IN_FLIGHT);
         m_imageFences.resize(m_swapChain.getImageCount(), nullptr);
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
             m_imageAvailableSemaphores[i] = m_logicalDevice.createSemaphore({});
             m_renderFinishedSemaphores[i] = m_logicalDevice.createSemaphore({});
 
@@ -276,30 +337,49 @@ namespace engine {
     }
 
     void RenderEngine::recreateSwapchain() {
-        // TODO: Optimize window resize
         while (m_windowSize.width == 0 || m_windowSize.height == 0)  {
             m_windowSize = m_window->getSize();
             glfwWaitEvents();
         }
 
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // A resize spanning several recreations is measured from the first one
+        if (!m_resizing) m_resizeStart = start;
+        m_resizing = true;
+
         m_logicalDevice.waitIdle();
 
+        vk::Format format = m_swapChain.getFormat();
+
         cleanSwapChain();
 
         m_swapChain.create(m_windowSize.width, m_windowSize.height, m_device->m_queueFamilyIndices.graphics, m_device->m_queueFamilyIndices.graphics);
-        createRenderPass();
-        createGraphicsPipeline();
+
+        // Viewport and scissor are dynamic, the render pass and the pipelines only change with the surface format
+        if (m_swapChain.getFormat() != format) {
+            m_logicalDevice.destroy(m_renderPass);
+            createRenderPass();
+
+            for (auto& pipeline : m_pipelines) pipeline->recreate(m_renderPass);
+        }
+
         createMsaaResources();
         createDepthResources();
         createFramebuffers();
         createDescriptorPool();
         createDescriptorSets();
 
-        for (auto& cmd : m_mainCommands) cmd->initBuffers(m_swapChain.getImageCount(), &m_indexImage);
+        m_imageFences.assign(m_swapChain.getImageCount(), nullptr);
+
+        for (auto& cmd : m_mainCommands) cmd->initBuffers(MAX_FRAMES_IN_FLIGHT, &m_currentFrame);
 
         // TODO: Include UIImGui in resize window
 //        m_ui.resize(m_swapChain);
         engine::Application::m_resourceManager->recreateResources();
+
+        std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+        spdlog::info("[Renderer] Swapchain recreated {}x{} in {:.2f} ms", m_windowSize.width, m_windowSize.height, time.count());
     }
 
     void RenderEngine::cleanSwapChain() {
@@ -310,10 +390,6 @@ namespace engine {
 
         for (auto& cmd : m_mainCommands) cmd->free();
 
-        for (auto& pipeline : m_pipelines) pipeline->cleanup();
-
-        m_logicalDevice.destroy(m_renderPass);
-
         m_swapChain.cleanup();
 
         m_logicalDevice.destroy(m_descriptorPool);
@@ -329,32 +405,29 @@ namespace engine {
             .pImmutableSamplers = nullptr
         };
 
-        m_descriptorSetLayout = m_logicalDevice.createDescriptorSetLayout({
-            .bindingCount = 1,
-            .pBindings = &uboLayoutBinding
-        });
+        m_descriptorSetLayout = m_device->m_layoutCache->getSetLayout({uboLayoutBinding});
     }
 
     void RenderEngine::createDescriptorPool() {
         vk::DescriptorPoolSize descriptorPoolSize{
             .type = vk::DescriptorType::eUniformBuffer,
-            .descriptorCount = m_swapChain.getImageCount()
+            .descriptorCount = MAX_FRAMES_IN_FLIGHT
         };
 
         m_descriptorPool = m_logicalDevice.createDescriptorPool({
             .flags = {},
-            .maxSets = m_swapChain.getImageCount(),
+            .maxSets = MAX_FRAMES_IN_FLIGHT,
             .poolSizeCount = 1,
             .pPoolSizes = &descriptorPoolSize,
         });
     }
 
     void RenderEngine::createDescriptorSets() {
-        std::vector<vk::DescriptorSetLayout> layouts(m_swapChain.getImageCount(), m_descriptorSetLayout);
+        std::vector<vk::DescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, m_descriptorSetLayout);
 
         m_descriptorSets = m_logicalDevice.allocateDescriptorSets({
             .descriptorPool = m_descriptorPool,
-            .descriptorSetCount = m_swapChain.getImageCount(),
+            .descriptorSetCount = MAX_FRAMES_IN_FLIGHT,
             .pSetLayouts = layouts.data()
         });
     }
@@ -377,10 +450,8 @@ namespace engine {
                 .initialLayout = vk::ImageLayout::eUndefined
         });
 
-        vk::MemoryRequirements memoryRequirements = m_logicalDevice.getImageMemoryRequirements(m_depthBuffer.getImage());
-        uint32_t memType = m_device->getMemoryType(memoryRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-        m_depthBuffer.bind(m_logicalDevice, memType, memoryRequirements.size, vk::ImageAspectFlagBits::eDepth);
+        m_depthBuffer.bind(*m_device->m_allocator, m_logicalDevice, vk::MemoryPropertyFlagBits::eDeviceLocal,
+                           vk::ImageAspectFlagBits::eDepth, true);
 
         m_device->transitionImageLayout(m_depthBuffer.getImage(), static_cast<vk::Format>(m_depthBuffer.getFormat()), m_graphicsQueue,
                                         vk::ImageLayout::eUndefined, vk::ImageLayout::eDepthStencilAttachmentOptimal);
@@ -406,10 +477,8 @@ namespace engine {
                 .initialLayout = vk::ImageLayout::eUndefined
         });
 
-        vk::MemoryRequirements memoryRequirements = m_logicalDevice.getImageMemoryRequirements(m_colorImage.getImage());
-        uint32_t  memType = m_device->getMemoryType(memoryRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-        m_colorImage.bind(m_logicalDevice, memType, memoryRequirements.size, vk::ImageAspectFlagBits::eColor);
+        m_colorImage.bind(*m_device->m_allocator, m_logicalDevice, vk::MemoryPropertyFlagBits::eDeviceLocal,
+                          vk::ImageAspectFlagBits::eColor, true);
     }
 
     void RenderEngine::updateVP(const glm::mat4& view, const glm::mat4& proj) {
@@ -425,7 +494,7 @@ namespace engine {
         m_mainCommands.push_back(std::make_shared<CommandList>(m_device->createCommandPool(), m_logicalDevice));
         std::shared_ptr<CommandList> cmd = m_mainCommands.back();
 
-        cmd->initBuffers(m_swapChain.getImageCount(), &m_indexImage);
+        cmd->initBuffers(MAX_FRAMES_IN_FLIGHT, &m_currentFrame);
 
         return cmd;
     }
@@ -434,6 +503,10 @@ namespace engine {
         return m_framebuffers[m_indexImage];
     }
 
+    uint32_t RenderEngine::getCurrentFrame() const {
+        return m_currentFrame;
+    }
+
     vk::Extent2D RenderEngine::getSwapChainExtent() {
         return m_swapChain.getExtent();
     }
@@ -443,12 +516,13 @@ namespace engine {
     }
 
     vk::DescriptorSet &RenderEngine::getDescriptorSet() {
-        return m_descriptorSets[m_indexImage];
+        return m_descriptorSets[m_currentFrame];
     }
 
     std::shared_ptr<GraphicsPipeline> RenderEngine::addPipeline(const std::shared_ptr<engine::Shader>& shaderID, vk::Device device,
                                                                 std::vector<vk::DescriptorSetLayout>* pLayouts, bool inited) {
-        m_pipelines.push_back(std::make_shared<GraphicsPipeline>(shaderID, device));
+        m_pipelines.push_back(std::make_shared<GraphicsPipeline>(shaderID, device, m_device->m_layoutCache.get(),
+                                                                 m_device->m_pipelineCache));
 
         if (inited) {
             if (pLayouts) {
@@ -466,6 +540,12 @@ namespace engine {
         return m_pipelines.back();
     }
 
+    void RenderEngine::reloadPipelines(const std::shared_ptr<engine::Shader>& shader) {
+        for (auto& pipeline : m_pipelines) {
+            if (pipeline->getShader() == shader) pipeline->recreate();
+        }
+    }
+
     SwapChain &RenderEngine::getSwapChain() {
         return m_swapChain;
     }
@@ -3,6 +3,7 @@
 
 
 #include <thread>
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -48,6 +49,8 @@ namespace engine {
 
         vk::Framebuffer& getFrameBuffer();
 
+        [[nodiscard]] uint32_t getCurrentFrame() const;
+
         vk::Extent2D getSwapChainExtent();
 
         vk::RenderPass& getRenderPass();
@@ -57,6 +60,9 @@ namespace engine {
         std::shared_ptr<GraphicsPipeline> addPipeline(const std::shared_ptr<engine::Shader>& shaderID, vk::Device device,
                                                       std::vector<vk::DescriptorSetLayout>* layouts = nullptr, bool inited = false);
 
+        // Recreates the pipelines built from the shader, the device must be idle
+        void reloadPipelines(const std::shared_ptr<engine::Shader>& shader);
+
         SwapChain& getSwapChain();
 
         [[nodiscard]] uint32_t getImageIndex() const;
@@ -72,6 +78,12 @@ namespace engine {
 
         void createSyncObjects();
 
+        // Averages the frame time and the time blocked on fences, logged every FRAME_STATS_INTERVAL frames
+        void updateFrameStats(std::chrono::high_resolution_clock::time_point waitStart);
+
+        // Time from init, and from the start of a swapchain recreation, to the next frame presented
+        void logPresentLatency();
+
         void recreateSwapchain();
 
         void cleanSwapChain();
@@ -113,9 +125,20 @@ namespace engine {
         std::vector<vk::Fence> m_fences;
         std::vector<vk::Fence> m_imageFences;
 
-        size_t m_currentFrame = 0;
+        // Command buffers and descriptor sets are per frame in flight, framebuffers per swapchain image
+        uint32_t m_currentFrame = 0;
         uint32_t m_indexImage{};
 
+        std::chrono::high_resolution_clock::time_point m_frameStart{};
+        uint32_t m_statsFrames{};
+        float m_frameTime{};
+        float m_waitTime{};
+
+        std::chrono::high_resolution_clock::time_point m_startupStart{};
+        std::chrono::high_resolution_clock::time_point m_resizeStart{};
+        bool m_startupLogged = false;
+        bool m_resizing = false;
+
         vk::DescriptorSetLayout m_descriptorSetLayout{};
         vk::DescriptorPool m_descriptorPool{};
         std::vector<vk::DescriptorSet> m_descriptorSets;
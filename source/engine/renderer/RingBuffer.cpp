@@ -0,0 +1,66 @@
+#include "RingBuffer.hpp"
+
+#include "spdlog/spdlog.h"
+
+
+namespace engine {
+
+    RingBuffer::RingBuffer() = default;
+
+    RingBuffer::~RingBuffer() = default;
+
+    void RingBuffer::create(const std::shared_ptr<Device>& device, vk::BufferUsageFlags usage, vk::DeviceSize segmentSize,
+                            uint32_t segmentCount, vk::DeviceSize alignment) {
+        m_alignment = std::max<vk::DeviceSize>(alignment, 1);
+        m_segmentSize = (segmentSize + m_alignment - 1) / m_alignment * m_alignment;
+        m_segmentCount = segmentCount;
+
+        vk::DeviceSize size = m_segmentSize * m_segmentCount;
+        m_buffer = device->createBuffer(usage, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, size,
+                                        nullptr, MemoryAllocator::Strategy::LINEAR);
+        m_buffer.map(size);
+        m_buffer.setupDescriptor(size);
+
+        beginFrame(0);
+    }
+
+    void RingBuffer::cleanup() {
+        m_buffer.unmap();
+        m_buffer.destroy();
+    }
+
+    void RingBuffer::beginFrame(uint32_t frameIndex) {
+        m_segmentStart = m_segmentSize * (frameIndex % m_segmentCount);
+        m_head = 0;
+    }
+
+    uint32_t RingBuffer::allocate(vk::DeviceSize size) {
+        vk::DeviceSize alignedSize = (size + m_alignment - 1) / m_alignment * m_alignment;
+        vk::DeviceSize offset = m_head.fetch_add(alignedSize);
+
+        if (offset + alignedSize > m_segmentSize) {
+            spdlog::warn("[RingBuffer] Frame segment of {} bytes is full", m_segmentSize);
+
+            return INVALID_OFFSET;
+        }
+
+        return static_cast<uint32_t>(m_segmentStart + offset);
+    }
+
+    void RingBuffer::write(uint32_t offset, const void* data, vk::DeviceSize size) {
+        std::memcpy(static_cast<char*>(m_buffer.m_mapped) + offset, data, size);
+    }
+
+    const Buffer& RingBuffer::getBuffer() const {
+        return m_buffer;
+    }
+
+    vk::DeviceSize RingBuffer::getUsedSize() const {
+        return std::min(m_head.load(), m_segmentSize);
+    }
+
+    vk::DeviceSize RingBuffer::getSegmentSize() const {
+        return m_segmentSize;
+    }
+
+} // namespace engine
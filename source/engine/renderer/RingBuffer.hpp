@@ -0,0 +1,57 @@
+#ifndef PROTOTYPE_ACTION_RPG_RINGBUFFER_HPP
+#define PROTOTYPE_ACTION_RPG_RINGBUFFER_HPP
+
+
+#include <atomic>
+#include <memory>
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include "vulkan/vulkan.hpp"
+
+#include "Buffer.hpp"
+#include "Device.hpp"
+
+
+namespace engine {
+
+    // Host visible buffer split in one segment per frame in flight, the segment of a frame is reused once its fence is signaled
+    class RingBuffer {
+    public:
+        static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+    public:
+        RingBuffer();
+
+        ~RingBuffer();
+
+        void create(const std::shared_ptr<Device>& device, vk::BufferUsageFlags usage, vk::DeviceSize segmentSize,
+                    uint32_t segmentCount, vk::DeviceSize alignment);
+
+        void cleanup();
+
+        void beginFrame(uint32_t frameIndex);
+
+        // Returns the offset in bytes from the start of the buffer, INVALID_OFFSET when the segment is full
+        uint32_t allocate(vk::DeviceSize size);
+
+        void write(uint32_t offset, const void* data, vk::DeviceSize size);
+
+        [[nodiscard]] const Buffer& getBuffer() const;
+
+        [[nodiscard]] vk::DeviceSize getUsedSize() const;
+
+        [[nodiscard]] vk::DeviceSize getSegmentSize() const;
+
+    private:
+        Buffer m_buffer;
+        vk::DeviceSize m_segmentSize{};
+        vk::DeviceSize m_alignment{1};
+        uint32_t m_segmentCount{};
+        vk::DeviceSize m_segmentStart{};
+        std::atomic<vk::DeviceSize> m_head{};
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_RINGBUFFER_HPP
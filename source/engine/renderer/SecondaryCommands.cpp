@@ -0,0 +1,94 @@
+#include "SecondaryCommands.hpp"
+
+#include "../Constants.hpp"
+
+
+namespace engine {
+
+    SecondaryCommands::SecondaryCommands() = default;
+
+    SecondaryCommands::~SecondaryCommands() = default;
+
+    void SecondaryCommands::create(const std::shared_ptr<Device>& device, uint32_t slotCount) {
+        m_device = device;
+        m_slotCount = slotCount;
+
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT * m_slotCount; ++i) {
+            m_pools.push_back(m_device->createCommandPool(nullptr, vk::CommandPoolCreateFlagBits::eTransient));
+            m_buffers.push_back(m_device->createCommandBuffer(vk::CommandBufferLevel::eSecondary, m_pools.back(), false));
+        }
+    }
+
+    void SecondaryCommands::cleanup() {
+        for (auto& pool : m_pools) m_device->m_logicalDevice.destroy(pool);
+
+        m_pools.clear();
+        m_buffers.clear();
+    }
+
+    void SecondaryCommands::beginFrame(uint32_t frameIndex, vk::RenderPass renderPass, vk::Framebuffer framebuffer, vk::Extent2D extent) {
+        m_frameIndex = frameIndex;
+        m_acquired = 0;
+        m_renderPass = renderPass;
+        m_framebuffer = framebuffer;
+        m_extent = extent;
+        m_bindings.clear();
+
+        for (uint32_t i = 0; i < m_slotCount; ++i) m_device->m_logicalDevice.resetCommandPool(m_pools[m_frameIndex * m_slotCount + i], {});
+    }
+
+    void SecondaryCommands::bindDescriptorSet(vk::PipelineLayout layout, uint32_t set, vk::DescriptorSet descriptorSet) {
+        m_bindings.push_back({layout, set, descriptorSet});
+    }
+
+    vk::CommandBuffer SecondaryCommands::acquire() {
+        if (m_acquired == m_slotCount) throw std::runtime_error("No secondary command buffer left in the frame");
+
+        vk::CommandBuffer cmdBuffer = m_buffers[m_frameIndex * m_slotCount + m_acquired++];
+
+        vk::CommandBufferInheritanceInfo inheritance{
+            .renderPass = m_renderPass,
+            .subpass = 0,
+            .framebuffer = m_framebuffer
+        };
+
+        cmdBuffer.begin({
+            .flags = vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+            .pInheritanceInfo = &inheritance
+        });
+
+        cmdBuffer.setViewport(0, vk::Viewport{
+            .x = 0.0f,
+            .y = 0.0f,
+            .width = static_cast<float>(m_extent.width),
+            .height = static_cast<float>(m_extent.height),
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f
+        });
+        cmdBuffer.setScissor(0, vk::Rect2D{
+            .offset = {0, 0},
+            .extent = m_extent
+        });
+
+        for (auto& binding : m_bindings) {
+            cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, binding.layout, binding.set, 1, &binding.descriptorSet, 0, nullptr);
+        }
+
+        return cmdBuffer;
+    }
+
+    uint32_t SecondaryCommands::getAvailable() const {
+        return m_slotCount - m_acquired;
+    }
+
+    void SecondaryCommands::execute(const vk::CommandBuffer& primary) {
+        if (m_acquired == 0) return;
+
+        vk::CommandBuffer* buffers = &m_buffers[m_frameIndex * m_slotCount];
+
+        for (uint32_t i = 0; i < m_acquired; ++i) buffers[i].end();
+
+        primary.executeCommands(m_acquired, buffers);
+    }
+
+} // namespace engine
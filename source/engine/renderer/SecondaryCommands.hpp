@@ -0,0 +1,68 @@
+#ifndef PROTOTYPE_ACTION_RPG_SECONDARYCOMMANDS_HPP
+#define PROTOTYPE_ACTION_RPG_SECONDARYCOMMANDS_HPP
+
+
+#include <memory>
+#include <vector>
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include "vulkan/vulkan.hpp"
+
+#include "Device.hpp"
+
+
+namespace engine {
+
+    // Secondary command buffers of the main render pass, recorded on any thread and executed in the order they were
+    // acquired. Each slot has its own command pool per frame in flight, a slot is recorded by one thread at a time and its
+    // pool is reset once the fence of its frame is signaled, so pools are never shared between threads
+    class SecondaryCommands {
+    public:
+        SecondaryCommands();
+
+        ~SecondaryCommands();
+
+        void create(const std::shared_ptr<Device>& device, uint32_t slotCount);
+
+        void cleanup();
+
+        // The fence of the frame must have been waited on
+        void beginFrame(uint32_t frameIndex, vk::RenderPass renderPass, vk::Framebuffer framebuffer, vk::Extent2D extent);
+
+        // Bound at the start of every buffer acquired after the call, secondary buffers inherit no state from the primary
+        void bindDescriptorSet(vk::PipelineLayout layout, uint32_t set, vk::DescriptorSet descriptorSet);
+
+        // Begun with the viewport, scissor and descriptor sets of the frame, it can then be recorded on another thread
+        vk::CommandBuffer acquire();
+
+        [[nodiscard]] uint32_t getAvailable() const;
+
+        // Every acquired buffer must be done recording, the primary buffer is inside a render pass begun with secondary contents
+        void execute(const vk::CommandBuffer& primary);
+
+    private:
+        struct Binding {
+            vk::PipelineLayout layout;
+            uint32_t set{};
+            vk::DescriptorSet descriptorSet;
+        };
+
+    private:
+        std::shared_ptr<Device> m_device;
+        uint32_t m_slotCount{};
+        // Indexed by frame * slot count + slot
+        std::vector<vk::CommandPool> m_pools;
+        std::vector<vk::CommandBuffer> m_buffers;
+
+        uint32_t m_frameIndex{};
+        uint32_t m_acquired{};
+        vk::RenderPass m_renderPass;
+        vk::Framebuffer m_framebuffer;
+        vk::Extent2D m_extent;
+        std::vector<Binding> m_bindings;
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_SECONDARYCOMMANDS_HPP
@@ -0,0 +1,262 @@
+#include "UploadBatch.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include "../Utilities.hpp"
+#include "../Application.hpp"
+
+
+inline vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+namespace engine {
+
+    UploadBatch::UploadBatch() = default;
+
+    UploadBatch::~UploadBatch() = default;
+
+    void UploadBatch::create(const std::shared_ptr<Device>& device, vk::Queue queue, uint32_t queueFamily, vk::DeviceSize stagingSize) {
+        m_device = device;
+        m_queue = queue;
+        m_commandPool = m_device->createCommandPool(&queueFamily);
+        m_commandBuffer = m_device->createCommandBuffer(vk::CommandBufferLevel::ePrimary, m_commandPool);
+        m_fence = m_device->m_logicalDevice.createFence({});
+
+        m_staging = m_device->createBuffer(vk::BufferUsageFlagBits::eTransferSrc,
+                                           vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                           stagingSize, nullptr, MemoryAllocator::Strategy::LINEAR);
+        m_staging.map(stagingSize);
+    }
+
+    void UploadBatch::cleanup() {
+        m_staging.unmap();
+        m_staging.destroy();
+
+        m_device->m_logicalDevice.destroy(m_fence);
+        m_device->m_logicalDevice.destroy(m_commandPool);
+    }
+
+    void UploadBatch::begin() {
+        if (m_depth++ > 0) return;
+
+        m_stats = {};
+        m_start = std::chrono::steady_clock::now();
+        beginCommands();
+    }
+
+    void UploadBatch::uploadBuffer(const void* data, vk::DeviceSize size, const Buffer& dst, vk::DeviceSize dstOffset) {
+        vk::Buffer source;
+        vk::BufferCopy region{
+            .srcOffset = stage(data, size, 4, source),
+            .dstOffset = dstOffset,
+            .size = size
+        };
+
+        m_commandBuffer.copyBuffer(source, dst.m_buffer, 1, &region);
+        m_stats.buffers++;
+    }
+
+    void UploadBatch::uploadImage(const void* data, vk::DeviceSize size, vk::Image image, vk::Format format, vk::Extent2D extent,
+                                  uint32_t mipLevels) {
+        vk::FormatProperties formatProperties = m_device->m_physicalDevice.getFormatProperties(format);
+
+        if (mipLevels > 1 && !(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
+            engine::throw_ex("texture image format does not support linear blitting");
+        }
+
+        vk::Buffer source;
+        vk::DeviceSize offset = stage(data, size, 16, source);
+
+        vk::ImageMemoryBarrier barrier{
+            .srcAccessMask = {},
+            .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .oldLayout = vk::ImageLayout::eUndefined,
+            .newLayout = vk::ImageLayout::eTransferDstOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image,
+            .subresourceRange = {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .baseMipLevel = 0,
+                    .levelCount = mipLevels,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1
+            }
+        };
+
+        m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {},
+                                        0, nullptr, 0, nullptr, 1, &barrier);
+
+        vk::BufferImageCopy region{
+            .bufferOffset = offset,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .mipLevel = 0,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1
+            },
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {
+                    .width = extent.width,
+                    .height = extent.height,
+                    .depth = 1
+            }
+        };
+
+        m_commandBuffer.copyBufferToImage(source, image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
+
+        generateMipmaps(image, extent, mipLevels);
+        m_stats.images++;
+    }
+
+    void UploadBatch::submit() {
+        if (m_depth == 0 || --m_depth > 0) return;
+
+        flush();
+
+        m_stats.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+        m_lastStats = m_stats;
+
+        if (m_stats.bytes > 0) {
+            spdlog::info("[Upload] {:.2f} MB in {} buffers and {} images, {} submits, {:.2f} ms, {:.0f} bytes/ms",
+                         static_cast<float>(m_stats.bytes) / (1024.0f * 1024.0f), m_stats.buffers, m_stats.images, m_stats.submits,
+                         m_stats.milliseconds, static_cast<float>(m_stats.bytes) / std::max(m_stats.milliseconds, 0.001f));
+        }
+    }
+
+    const UploadBatch::Stats& UploadBatch::getLastStats() const {
+        return m_lastStats;
+    }
+
+    vk::DeviceSize UploadBatch::stage(const void* data, vk::DeviceSize size, vk::DeviceSize alignment, vk::Buffer& source) {
+        m_stats.bytes += size;
+
+        if (size > m_staging.m_size) {
+            m_overflow.push_back(m_device->createBuffer(vk::BufferUsageFlagBits::eTransferSrc,
+                                                        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                                        size, const_cast<void*>(data)));
+            source = m_overflow.back().m_buffer;
+
+            return 0;
+        }
+
+        vk::DeviceSize offset = alignUp(m_head, alignment);
+
+        // The ring is full, everything recorded so far has to reach the GPU before its space is reused
+        if (offset + size > m_staging.m_size) {
+            flush();
+            beginCommands();
+            offset = 0;
+        }
+
+        std::memcpy(static_cast<char*>(m_staging.m_mapped) + offset, data, size);
+        m_head = offset + size;
+        source = m_staging.m_buffer;
+
+        return offset;
+    }
+
+    void UploadBatch::beginCommands() {
+        m_commandBuffer.begin({
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+        });
+    }
+
+    void UploadBatch::flush() {
+        m_commandBuffer.end();
+
+        vk::SubmitInfo submitInfo{
+            .commandBufferCount = 1,
+            .pCommandBuffers = &m_commandBuffer
+        };
+
+        {
+            std::unique_lock<std::mutex> lock(Application::m_renderer->m_queueMutex);
+
+            VK_CHECK_RESULT_HPP(m_queue.submit(1, &submitInfo, m_fence))
+        }
+
+        VK_CHECK_RESULT_HPP(m_device->m_logicalDevice.waitForFences(1, &m_fence, VK_TRUE, std::numeric_limits<uint64_t>::max()))
+        VK_CHECK_RESULT_HPP(m_device->m_logicalDevice.resetFences(1, &m_fence))
+
+        m_device->m_logicalDevice.resetCommandPool(m_commandPool, {});
+
+        for (auto& buffer : m_overflow) buffer.destroy();
+
+        m_overflow.clear();
+        m_head = 0;
+        m_stats.submits++;
+    }
+
+    void UploadBatch::generateMipmaps(vk::Image image, vk::Extent2D extent, uint32_t mipLevels) {
+        vk::ImageMemoryBarrier barrier{
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image,
+            .subresourceRange = {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .levelCount = 1,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+            }
+        };
+
+        auto mipWidth = static_cast<int32_t>(extent.width);
+        auto mipHeight = static_cast<int32_t>(extent.height);
+
+        for (uint32_t i = 1; i < mipLevels; ++i) {
+            barrier.subresourceRange.baseMipLevel = i - 1;
+            barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+            barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+            barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+            barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+
+            m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {},
+                                            0, nullptr, 0, nullptr, 1, &barrier);
+
+            vk::ImageBlit blit{
+                .srcSubresource = {
+                        .aspectMask = vk::ImageAspectFlagBits::eColor,
+                        .mipLevel = i - 1,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1
+                },
+                .srcOffsets = {std::array<vk::Offset3D, 2>({ { {0, 0, 0}, {mipWidth, mipHeight, 1} } })},
+                .dstSubresource = {
+                        .aspectMask = vk::ImageAspectFlagBits::eColor,
+                        .mipLevel = i,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1
+                },
+                .dstOffsets = {std::array<vk::Offset3D, 2>({ { {0, 0, 0}, {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1} } })}
+            };
+
+            m_commandBuffer.blitImage(image, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal,
+                                      1, &blit, vk::Filter::eLinear);
+
+            barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+            barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+            barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
+            barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+
+            m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
+                                            0, nullptr, 0, nullptr, 1, &barrier);
+
+            if (mipWidth > 1) mipWidth /= 2;
+            if (mipHeight > 1) mipHeight /= 2;
+        }
+
+        barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+
+        m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
+                                        0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+} // namespace engine
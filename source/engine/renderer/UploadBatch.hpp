@@ -0,0 +1,79 @@
+#ifndef PROTOTYPE_ACTION_RPG_UPLOADBATCH_HPP
+#define PROTOTYPE_ACTION_RPG_UPLOADBATCH_HPP
+
+
+#include <memory>
+#include <vector>
+#include <chrono>
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include "vulkan/vulkan.hpp"
+
+#include "Buffer.hpp"
+#include "Device.hpp"
+
+
+namespace engine {
+
+    // Records every copy, layout transition and mip blit of a loading step in one command buffer. The sources go
+    // through a persistent staging ring, the whole batch costs one submit and one fence wait
+    class UploadBatch {
+    public:
+        struct Stats {
+            vk::DeviceSize bytes{};
+            uint32_t buffers{};
+            uint32_t images{};
+            uint32_t submits{};
+            float milliseconds{};
+        };
+
+    public:
+        UploadBatch();
+
+        ~UploadBatch();
+
+        void create(const std::shared_ptr<Device>& device, vk::Queue queue, uint32_t queueFamily, vk::DeviceSize stagingSize);
+
+        void cleanup();
+
+        // Batches can be nested, only the outermost submit reaches the queue
+        void begin();
+
+        void uploadBuffer(const void* data, vk::DeviceSize size, const Buffer& dst, vk::DeviceSize dstOffset = 0);
+
+        // Leaves every mip level of the image in shader read only layout
+        void uploadImage(const void* data, vk::DeviceSize size, vk::Image image, vk::Format format, vk::Extent2D extent, uint32_t mipLevels);
+
+        void submit();
+
+        [[nodiscard]] const Stats& getLastStats() const;
+
+    private:
+        vk::DeviceSize stage(const void* data, vk::DeviceSize size, vk::DeviceSize alignment, vk::Buffer& source);
+
+        void beginCommands();
+
+        void flush();
+
+        void generateMipmaps(vk::Image image, vk::Extent2D extent, uint32_t mipLevels);
+
+    private:
+        std::shared_ptr<Device> m_device;
+        vk::Queue m_queue{};
+        vk::CommandPool m_commandPool{};
+        vk::CommandBuffer m_commandBuffer{};
+        vk::Fence m_fence{};
+        Buffer m_staging;
+        vk::DeviceSize m_head{};
+        // Sources larger than the ring get their own staging buffer until the batch is flushed
+        std::vector<Buffer> m_overflow;
+        uint32_t m_depth{};
+        Stats m_stats{};
+        Stats m_lastStats{};
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_UPLOADBATCH_HPP
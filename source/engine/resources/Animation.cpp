@@ -1,8 +1,167 @@
 #include "Animation.hpp"
 
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#include "spdlog/spdlog.h"
+
+#include "../Hash.hpp"
+
+
+const uint32_t CLIP_CACHE_MAGIC = 0x50494C43; // "CLIP"
+const uint32_t CLIP_CACHE_VERSION = 1;
+
+template<typename T>
+inline void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+inline T readValue(std::ifstream& file) {
+    T value{};
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+
+    return value;
+}
 
 namespace engine {
 
     Animation::Animation() = default;
 
+    Animation::SourceStamp Animation::getSourceStamp(const std::string& path) {
+        std::error_code error;
+        SourceStamp stamp{};
+
+        stamp.pathHash = tools::hash(std::filesystem::path(path).lexically_normal().string());
+        stamp.size = std::filesystem::file_size(path, error);
+        stamp.writeTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+
+        return stamp;
+    }
+
+    bool Animation::save(const std::string& path, const SourceStamp& source) const {
+        std::ofstream file(path, std::ios::binary);
+
+        if (!file.is_open()) return false;
+
+        writeValue(file, CLIP_CACHE_MAGIC);
+        writeValue(file, CLIP_CACHE_VERSION);
+        writeValue(file, source);
+        writeValue(file, static_cast<uint32_t>(m_name.size()));
+        file.write(m_name.data(), static_cast<std::streamsize>(m_name.size()));
+        writeValue(file, m_start);
+        writeValue(file, m_end);
+
+        writeValue(file, static_cast<uint32_t>(m_samplers.size()));
+        for (auto& sampler : m_samplers) {
+            writeValue(file, static_cast<uint32_t>(sampler.interpolation));
+            writeValue(file, static_cast<uint32_t>(sampler.inputs.size()));
+            writeValue(file, static_cast<uint32_t>(sampler.outputs.size()));
+            file.write(reinterpret_cast<const char*>(sampler.inputs.data()), static_cast<std::streamsize>(sampler.inputs.size() * sizeof(float)));
+            file.write(reinterpret_cast<const char*>(sampler.outputs.data()),
+                       static_cast<std::streamsize>(sampler.outputs.size() * sizeof(glm::vec4)));
+        }
+
+        writeValue(file, static_cast<uint32_t>(m_channels.size()));
+        file.write(reinterpret_cast<const char*>(m_channels.data()), static_cast<std::streamsize>(m_channels.size() * sizeof(Channel)));
+
+        return file.good();
+    }
+
+    bool Animation::load(const std::string& path, const SourceStamp& source) {
+        std::ifstream file(path, std::ios::binary);
+
+        if (!file.is_open()) return false;
+
+        auto magic = readValue<uint32_t>(file);
+        auto version = readValue<uint32_t>(file);
+        auto stamp = readValue<SourceStamp>(file);
+
+        // A cache written from another file, or before the file was exported again, is read again from the glTF
+        if (!file.good() || magic != CLIP_CACHE_MAGIC || version != CLIP_CACHE_VERSION || stamp.pathHash != source.pathHash
+                || stamp.size != source.size || stamp.writeTime != source.writeTime) {
+            return false;
+        }
+
+        // Counts are checked against the file size before anything is allocated for them
+        std::error_code error;
+        uint64_t fileSize = std::filesystem::file_size(path, error);
+        auto fits = [fileSize](uint64_t count, size_t size) { return count * size <= fileSize; };
+
+        auto nameSize = readValue<uint32_t>(file);
+        if (!fits(nameSize, 1)) return false;
+
+        m_name.resize(nameSize);
+        file.read(m_name.data(), nameSize);
+        m_start = readValue<float>(file);
+        m_end = readValue<float>(file);
+
+        auto samplerCount = readValue<uint32_t>(file);
+        if (!file.good() || !fits(samplerCount, 3 * sizeof(uint32_t))) return false;
+
+        m_samplers.resize(samplerCount);
+        for (auto& sampler : m_samplers) {
+            sampler.interpolation = static_cast<Sampler::InterpolationType>(readValue<uint32_t>(file));
+            auto inputs = readValue<uint32_t>(file);
+            auto outputs = readValue<uint32_t>(file);
+
+            if (!file.good() || !fits(inputs, sizeof(float)) || !fits(outputs, sizeof(glm::vec4))) return false;
+
+            sampler.inputs.resize(inputs);
+            sampler.outputs.resize(outputs);
+            file.read(reinterpret_cast<char*>(sampler.inputs.data()), static_cast<std::streamsize>(inputs * sizeof(float)));
+            file.read(reinterpret_cast<char*>(sampler.outputs.data()), static_cast<std::streamsize>(outputs * sizeof(glm::vec4)));
+        }
+
+        auto channelCount = readValue<uint32_t>(file);
+        if (!file.good() || !fits(channelCount, sizeof(Channel))) return false;
+
+        m_channels.resize(channelCount);
+        file.read(reinterpret_cast<char*>(m_channels.data()), static_cast<std::streamsize>(channelCount * sizeof(Channel)));
+
+        return file.good() && std::all_of(m_channels.begin(), m_channels.end(), [samplerCount](const Channel& channel) {
+            return channel.samplerIndex < samplerCount;
+        });
+    }
+
+    uint64_t Animation::hashKeys() const {
+        auto bytes = [](const auto& values) {
+            return std::string_view(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(values[0]));
+        };
+        uint64_t hash = tools::hash(bytes(m_channels));
+
+        for (auto& sampler : m_samplers) {
+            hash = tools::hash(std::string_view(reinterpret_cast<const char*>(&sampler.interpolation), sizeof(sampler.interpolation)), hash);
+            hash = tools::hash(bytes(sampler.inputs), hash);
+            hash = tools::hash(bytes(sampler.outputs), hash);
+        }
+
+        return hash;
+    }
+
+    void Animation::compress(const CompressedClip::Settings& settings) {
+        m_compressed.compress(*this, settings);
+
+        // The compressed tracks replace the raw keys
+        for (uint32_t i = 0; i < m_samplers.size(); ++i) {
+            if (m_compressed.contains(i)) {
+                std::vector<float>().swap(m_samplers[i].inputs);
+                std::vector<glm::vec4>().swap(m_samplers[i].outputs);
+            }
+        }
+
+        const CompressedClip::MemoryReport& report = m_compressed.getReport();
+        spdlog::info("[Animation] {}: {} -> {} keys, {:.1f} -> {:.1f} KB", m_name, report.rawKeys, report.compressedKeys,
+                     static_cast<float>(report.rawBytes) / 1024.0f, static_cast<float>(report.compressedBytes) / 1024.0f);
+    }
+
+    size_t Animation::getMemorySize() const {
+        size_t size = m_channels.size() * sizeof(Channel) + m_compressed.getReport().compressedBytes + m_poseCache.getMemorySize();
+
+        for (auto& sampler : m_samplers) size += sampler.inputs.size() * sizeof(float) + sampler.outputs.size() * sizeof(glm::vec4);
+
+        return size;
+    }
+
 } // namespace engine
\ No newline at end of file
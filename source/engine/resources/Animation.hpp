@@ -4,10 +4,14 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <functional>
 
 #include "glm/glm.hpp"
 
+#include "CompressedClip.hpp"
+#include "PoseCache.hpp"
+
 
 namespace engine {
 
@@ -26,6 +30,7 @@ namespace engine {
 
             InterpolationType interpolation{};
             std::vector<float> inputs;
+            // CUBICSPLINE stores three outputs per input: in tangent, value and out tangent
             std::vector<glm::vec4> outputs;
         };
 
@@ -37,16 +42,40 @@ namespace engine {
             uint32_t samplerIndex;
         };
 
+        // File a clip was read from, a cached clip is only used while its source is unchanged
+        struct SourceStamp {
+            uint64_t pathHash{};
+            uint64_t size{};
+            int64_t writeTime{};
+        };
+
     public:
         Animation();
 
+        static SourceStamp getSourceStamp(const std::string& path);
+
+        // Raw keys before compression, read instead of the glTF file the next time the clip is loaded
+        bool save(const std::string& path, const SourceStamp& source) const;
+
+        bool load(const std::string& path, const SourceStamp& source);
+
+        // Raw keys and channels, taken before compression, the baked frames on disk are only used for the same hash
+        [[nodiscard]] uint64_t hashKeys() const;
+
+        void compress(const CompressedClip::Settings& settings);
+
+        // Raw keys left after compression, compressed tracks and baked frames
+        [[nodiscard]] size_t getMemorySize() const;
+
     public:
         std::string m_name;
         std::vector<Sampler> m_samplers;
         std::vector<Channel> m_channels;
         float m_start{std::numeric_limits<float>::max()};
         float m_end{std::numeric_limits<float>::min()};
-        float m_currentTime{1.0f};
+        uint64_t m_keysHash{};
+        CompressedClip m_compressed;
+        PoseCache m_poseCache;
     };
 
 } // namespace engine
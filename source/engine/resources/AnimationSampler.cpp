@@ -0,0 +1,291 @@
+#include "AnimationSampler.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+#include "glm/gtc/quaternion.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANIMATION_SAMPLER_SSE
+#include <xmmintrin.h>
+#endif
+
+
+// Finds the key starting the segment that holds time, returns false when time is clamped to the key returned
+inline bool locateKey(const std::vector<float>& inputs, float time, uint32_t& key, float& t, float& duration) {
+    auto count = static_cast<uint32_t>(inputs.size());
+
+    if (count == 1 || time <= inputs.front()) {
+        key = 0;
+        return false;
+    }
+
+    if (time >= inputs.back()) {
+        key = count - 1;
+        return false;
+    }
+
+    key = static_cast<uint32_t>(std::upper_bound(inputs.begin(), inputs.end(), time) - inputs.begin()) - 1;
+    duration = inputs[key + 1] - inputs[key];
+    t = duration > 0.0f ? (time - inputs[key]) / duration : 0.0f;
+
+    return true;
+}
+
+// Cubic spline keys are stored as (in tangent, value, out tangent), keys points to the triplet of the first key
+inline glm::vec4 hermite(const glm::vec4* keys, float t, float duration) {
+    float t2 = t * t;
+    float t3 = t2 * t;
+
+    return (2.0f * t3 - 3.0f * t2 + 1.0f) * keys[1] + (t3 - 2.0f * t2 + t) * duration * keys[2]
+           + (3.0f * t2 - 2.0f * t3) * keys[4] + (t3 - t2) * duration * keys[3];
+}
+
+inline glm::vec4 slerp(const glm::vec4& a, const glm::vec4& b, float t) {
+    glm::quat q = glm::slerp(glm::quat(a.w, a.x, a.y, a.z), glm::quat(b.w, b.x, b.y, b.z), t);
+
+    return {q.x, q.y, q.z, q.w};
+}
+
+inline float difference(const glm::vec4& a, const glm::vec4& b, bool rotation) {
+    glm::vec4 d = glm::abs(a - b);
+    float result = std::max(std::max(d.x, d.y), std::max(d.z, d.w));
+
+    if (rotation) {
+        d = glm::abs(a + b);
+        result = std::min(result, std::max(std::max(d.x, d.y), std::max(d.z, d.w)));
+    }
+
+    return result;
+}
+
+// Quaternion slerp written from its definition, taking the shortest arc
+inline glm::vec4 referenceSlerp(const glm::vec4& a, glm::vec4 b, float t) {
+    float cosine = glm::dot(a, b);
+
+    if (cosine < 0.0f) {
+        b = -b;
+        cosine = -cosine;
+    }
+
+    if (cosine > 0.9995f) return glm::normalize(a + t * (b - a));
+
+    float angle = std::acos(cosine);
+
+    return (std::sin((1.0f - t) * angle) * a + std::sin(t * angle) * b) / std::sin(angle);
+}
+
+// The interpolation rules of the glTF specification applied to the source keys, with a linear key search and none of
+// the helpers of the sampler, so verify checks both paths against values computed on their own
+inline glm::vec4 referenceSample(const engine::Animation::Sampler& sampler, bool rotation, float time) {
+    const std::vector<float>& inputs = sampler.inputs;
+    const std::vector<glm::vec4>& outputs = sampler.outputs;
+    bool cubic = sampler.interpolation == engine::Animation::Sampler::InterpolationType::CUBICSPLINE;
+    auto key = [&](size_t index) { return cubic ? outputs[index * 3 + 1] : outputs[index]; };
+    size_t next = 0;
+
+    // First key after time, a time on a key starts the segment of that key
+    while (next < inputs.size() && inputs[next] <= time) next++;
+
+    glm::vec4 value;
+
+    if (next == 0) {
+        value = key(0);
+    } else if (next == inputs.size()) {
+        value = key(inputs.size() - 1);
+    } else {
+        size_t previous = next - 1;
+        float duration = inputs[next] - inputs[previous];
+        float t = (time - inputs[previous]) / duration;
+
+        switch (sampler.interpolation) {
+            case engine::Animation::Sampler::InterpolationType::STEP:
+                value = key(previous);
+                break;
+            case engine::Animation::Sampler::InterpolationType::LINEAR:
+                value = rotation ? referenceSlerp(key(previous), key(next), t) : key(previous) + t * (key(next) - key(previous));
+                break;
+            case engine::Animation::Sampler::InterpolationType::CUBICSPLINE: {
+                // p(t) = (2t³ - 3t² + 1) p0 + (t³ - 2t² + t) m0 + (-2t³ + 3t²) p1 + (t³ - t²) m1, tangents scaled by the segment
+                glm::vec4 m0 = duration * outputs[previous * 3 + 2];
+                glm::vec4 m1 = duration * outputs[next * 3];
+                float t2 = t * t;
+                float t3 = t2 * t;
+
+                value = (2.0f * t3 - 3.0f * t2 + 1.0f) * key(previous) + (t3 - 2.0f * t2 + t) * m0
+                        + (-2.0f * t3 + 3.0f * t2) * key(next) + (t3 - t2) * m1;
+                break;
+            }
+        }
+    }
+
+    return rotation ? glm::normalize(value) : value;
+}
+
+namespace engine {
+
+    AnimationSampler::AnimationSampler() = default;
+
+    void AnimationSampler::sample(const Animation& animation, float time, const std::vector<uint32_t>& channels,
+                                  std::vector<glm::vec4>& values) {
+        values.resize(channels.size());
+        m_cubicJobs.clear();
+
+        for (uint32_t i = 0; i < channels.size(); ++i) {
+            const Animation::Channel& channel = animation.m_channels[channels[i]];
+
+            if (animation.m_compressed.contains(channel.samplerIndex)) {
+                values[i] = animation.m_compressed.sample(channel.samplerIndex, time);
+                continue;
+            }
+
+            const Animation::Sampler& sampler = animation.m_samplers[channel.samplerIndex];
+            bool cubic = sampler.interpolation == Animation::Sampler::InterpolationType::CUBICSPLINE;
+            uint32_t key;
+            float t, duration;
+
+            if (!locateKey(sampler.inputs, time, key, t, duration)) {
+                values[i] = cubic ? sampler.outputs[key * 3 + 1] : sampler.outputs[key];
+                continue;
+            }
+
+            switch (sampler.interpolation) {
+                case Animation::Sampler::InterpolationType::STEP:
+                    values[i] = sampler.outputs[key];
+                    break;
+                case Animation::Sampler::InterpolationType::LINEAR:
+                    values[i] = channel.path == Animation::Channel::PathType::ROTATION ?
+                                slerp(sampler.outputs[key], sampler.outputs[key + 1], t) :
+                                glm::mix(sampler.outputs[key], sampler.outputs[key + 1], t);
+                    break;
+                case Animation::Sampler::InterpolationType::CUBICSPLINE:
+                    m_cubicJobs.push_back({i, t, duration, channel.path == Animation::Channel::PathType::ROTATION,
+                                           &sampler.outputs[key * 3]});
+                    break;
+            }
+        }
+
+        size_t job = 0;
+
+#ifdef ANIMATION_SAMPLER_SSE
+        // Basis weights of four segments at once, then each value is a sum of four weighted keys
+        for (; job + 4 <= m_cubicJobs.size(); job += 4) {
+            const CubicJob* jobs = &m_cubicJobs[job];
+            __m128 t = _mm_setr_ps(jobs[0].t, jobs[1].t, jobs[2].t, jobs[3].t);
+            __m128 duration = _mm_setr_ps(jobs[0].duration, jobs[1].duration, jobs[2].duration, jobs[3].duration);
+            __m128 t2 = _mm_mul_ps(t, t);
+            __m128 t3 = _mm_mul_ps(t2, t);
+            __m128 two = _mm_set1_ps(2.0f);
+            __m128 three = _mm_set1_ps(3.0f);
+
+            alignas(16) float weights[4][4];
+            _mm_store_ps(weights[0], _mm_add_ps(_mm_sub_ps(_mm_mul_ps(two, t3), _mm_mul_ps(three, t2)), _mm_set1_ps(1.0f)));
+            _mm_store_ps(weights[1], _mm_mul_ps(_mm_add_ps(_mm_sub_ps(t3, _mm_mul_ps(two, t2)), t), duration));
+            _mm_store_ps(weights[2], _mm_sub_ps(_mm_mul_ps(three, t2), _mm_mul_ps(two, t3)));
+            _mm_store_ps(weights[3], _mm_mul_ps(_mm_sub_ps(t3, t2), duration));
+
+            for (int i = 0; i < 4; ++i) {
+                const glm::vec4* keys = jobs[i].keys;
+                __m128 value = _mm_mul_ps(_mm_set1_ps(weights[0][i]), _mm_loadu_ps(&keys[1].x));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(weights[1][i]), _mm_loadu_ps(&keys[2].x)));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(weights[2][i]), _mm_loadu_ps(&keys[4].x)));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(weights[3][i]), _mm_loadu_ps(&keys[3].x)));
+
+                _mm_storeu_ps(&values[jobs[i].value].x, value);
+            }
+        }
+#endif
+
+        for (; job < m_cubicJobs.size(); ++job) {
+            values[m_cubicJobs[job].value] = hermite(m_cubicJobs[job].keys, m_cubicJobs[job].t, m_cubicJobs[job].duration);
+        }
+
+        for (auto& cubicJob : m_cubicJobs) {
+            if (cubicJob.rotation) values[cubicJob.value] = glm::normalize(values[cubicJob.value]);
+        }
+    }
+
+    glm::vec4 AnimationSampler::sampleChannel(const Animation& animation, uint32_t channelIndex, float time) {
+        const Animation::Channel& channel = animation.m_channels[channelIndex];
+
+        if (animation.m_compressed.contains(channel.samplerIndex)) return animation.m_compressed.sample(channel.samplerIndex, time);
+
+        const Animation::Sampler& sampler = animation.m_samplers[channel.samplerIndex];
+        bool rotation = channel.path == Animation::Channel::PathType::ROTATION;
+        bool cubic = sampler.interpolation == Animation::Sampler::InterpolationType::CUBICSPLINE;
+        uint32_t key;
+        float t, duration;
+
+        if (!locateKey(sampler.inputs, time, key, t, duration)) return cubic ? sampler.outputs[key * 3 + 1] : sampler.outputs[key];
+
+        switch (sampler.interpolation) {
+            case Animation::Sampler::InterpolationType::STEP:
+                return sampler.outputs[key];
+            case Animation::Sampler::InterpolationType::LINEAR:
+                return rotation ? slerp(sampler.outputs[key], sampler.outputs[key + 1], t) :
+                       glm::mix(sampler.outputs[key], sampler.outputs[key + 1], t);
+            case Animation::Sampler::InterpolationType::CUBICSPLINE: {
+                glm::vec4 value = hermite(&sampler.outputs[key * 3], t, duration);
+
+                return rotation ? glm::normalize(value) : value;
+            }
+        }
+
+        return {};
+    }
+
+    uint32_t AnimationSampler::verify(const Animation& animation, float tolerance) {
+        std::vector<uint32_t> channels;
+        std::vector<float> times;
+
+        for (uint32_t i = 0; i < animation.m_channels.size(); ++i) {
+            const Animation::Channel& channel = animation.m_channels[i];
+
+            if (channel.nodeID < 0) continue;
+
+            channels.push_back(i);
+
+            // Every key, three points inside every segment and both sides of the clip
+            const std::vector<float>& inputs = animation.m_samplers[channel.samplerIndex].inputs;
+            times.push_back(inputs.front() - 0.1f);
+            times.push_back(inputs.back() + 0.1f);
+
+            for (size_t key = 0; key < inputs.size(); ++key) {
+                times.push_back(inputs[key]);
+
+                if (key + 1 < inputs.size()) {
+                    for (float t : {0.25f, 0.5f, 0.75f}) times.push_back(inputs[key] + (inputs[key + 1] - inputs[key]) * t);
+                }
+            }
+        }
+
+        std::sort(times.begin(), times.end());
+        times.erase(std::unique(times.begin(), times.end()), times.end());
+
+        AnimationSampler sampler;
+        std::vector<glm::vec4> values;
+        uint32_t mismatches = 0;
+
+        // The batch and the scalar paths against the reference, rotations compared once normalized
+        for (float time : times) {
+            sampler.sample(animation, time, channels, values);
+
+            for (uint32_t i = 0; i < channels.size(); ++i) {
+                const Animation::Channel& channel = animation.m_channels[channels[i]];
+                bool rotation = channel.path == Animation::Channel::PathType::ROTATION;
+                glm::vec4 expected = referenceSample(animation.m_samplers[channel.samplerIndex], rotation, time);
+                glm::vec4 batch = rotation ? glm::normalize(values[i]) : values[i];
+                glm::vec4 scalar = sampleChannel(animation, channels[i], time);
+
+                if (rotation) scalar = glm::normalize(scalar);
+
+                if (difference(batch, expected, rotation) > tolerance) mismatches++;
+
+                if (difference(scalar, expected, rotation) > tolerance) mismatches++;
+            }
+        }
+
+        return mismatches;
+    }
+
+} // namespace engine
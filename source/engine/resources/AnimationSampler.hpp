@@ -0,0 +1,47 @@
+#ifndef PROTOTYPE_ACTION_RPG_ANIMATIONSAMPLER_HPP
+#define PROTOTYPE_ACTION_RPG_ANIMATIONSAMPLER_HPP
+
+
+#include <vector>
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+#include "Animation.hpp"
+
+
+namespace engine {
+
+    // Evaluates many channels of a clip in one call. Keys are located first, then every channel sharing an
+    // interpolation mode is evaluated in the same pass, cubic Hermite four channels at a time with SSE
+    class AnimationSampler {
+    public:
+        AnimationSampler();
+
+        // values[i] receives the value of channels[i], quaternions as (x, y, z, w)
+        void sample(const Animation& animation, float time, const std::vector<uint32_t>& channels, std::vector<glm::vec4>& values);
+
+        // Scalar evaluation of a single channel, used as reference for the batch path
+        static glm::vec4 sampleChannel(const Animation& animation, uint32_t channel, float time);
+
+        // Checks the batch and the scalar paths against the glTF rules evaluated on the raw keys, returns the number of
+        // mismatches. Compressed channels are not covered, call it before compressing the clip
+        static uint32_t verify(const Animation& animation, float tolerance = 1e-4f);
+
+    private:
+        struct CubicJob {
+            uint32_t value;
+            float t;
+            float duration;
+            bool rotation;
+            const glm::vec4* keys;
+        };
+
+    private:
+        std::vector<CubicJob> m_cubicJobs;
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_ANIMATIONSAMPLER_HPP
@@ -0,0 +1,299 @@
+#include "CompressedClip.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "spdlog/spdlog.h"
+
+#include "Animation.hpp"
+
+
+const float SMALLEST_THREE_RANGE = 0.70710678f;
+const float KEY_TIME_EPSILON = 1e-5f;
+
+inline glm::vec4 alignRotation(const glm::vec4& reference, const glm::vec4& q) {
+    return glm::dot(reference, q) < 0.0f ? -q : q;
+}
+
+inline glm::vec4 interpolate(const glm::vec4& a, const glm::vec4& b, float alpha, bool rotation) {
+    if (rotation) return glm::normalize(glm::mix(a, alignRotation(a, b), alpha));
+
+    return glm::mix(a, b, alpha);
+}
+
+inline float maxDifference(const glm::vec4& a, const glm::vec4& b, bool rotation) {
+    glm::vec4 difference = glm::abs(a - (rotation ? alignRotation(a, b) : b));
+
+    return std::max(std::max(difference.x, difference.y), std::max(difference.z, difference.w));
+}
+
+// Largest error the 16 bit range quantization adds to a key of a vector track, half a step of its widest component
+inline float quantizationError(const std::vector<glm::vec4>& values) {
+    glm::vec3 rangeMin = glm::vec3(values.front());
+    glm::vec3 rangeMax = rangeMin;
+
+    for (auto& value : values) {
+        rangeMin = glm::min(rangeMin, glm::vec3(value));
+        rangeMax = glm::max(rangeMax, glm::vec3(value));
+    }
+
+    glm::vec3 extent = rangeMax - rangeMin;
+
+    return 0.5f * std::max(std::max(extent.x, extent.y), extent.z) / 65535.0f;
+}
+
+inline std::vector<uint32_t> reduceKeys(const std::vector<float>& times, const std::vector<glm::vec4>& values,
+                                        bool rotation, bool step, float tolerance) {
+    std::vector<uint32_t> kept;
+    auto count = static_cast<uint32_t>(times.size());
+
+    if (count <= 2) {
+        for (uint32_t i = 0; i < count; ++i) kept.push_back(i);
+
+        return kept;
+    }
+
+    kept.push_back(0);
+
+    if (step) {
+        // A step key can go away when it holds the same value than the previous kept key
+        for (uint32_t i = 1; i < count - 1; ++i) {
+            if (maxDifference(values[kept.back()], values[i], rotation) > tolerance) kept.push_back(i);
+        }
+    } else {
+        // Grow the segment from the anchor while every skipped key can be rebuilt inside the tolerance
+        uint32_t anchor = 0;
+
+        for (uint32_t candidate = 2; candidate < count; ++candidate) {
+            float duration = times[candidate] - times[anchor];
+            bool fits = true;
+
+            for (uint32_t j = anchor + 1; j < candidate && fits; ++j) {
+                float alpha = duration > 0.0f ? (times[j] - times[anchor]) / duration : 0.0f;
+                fits = maxDifference(interpolate(values[anchor], values[candidate], alpha, rotation), values[j], rotation) <= tolerance;
+            }
+
+            if (!fits) {
+                anchor = candidate - 1;
+                kept.push_back(anchor);
+            }
+        }
+    }
+
+    kept.push_back(count - 1);
+
+    return kept;
+}
+
+inline std::array<uint16_t, 3> encodeRotation(glm::vec4 q) {
+    q = glm::normalize(q);
+
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (std::abs(q[i]) > std::abs(q[largest])) largest = i;
+    }
+
+    // q and -q are the same rotation, keep the dropped component positive
+    if (q[largest] < 0.0f) q = -q;
+
+    auto packed = static_cast<uint64_t>(largest);
+    for (int i = 0; i < 4; ++i) {
+        if (i == largest) continue;
+
+        float normalized = (glm::clamp(q[i], -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE) + SMALLEST_THREE_RANGE) / (2.0f * SMALLEST_THREE_RANGE);
+        packed = (packed << 15) | static_cast<uint64_t>(std::lround(normalized * 32767.0f));
+    }
+
+    return {static_cast<uint16_t>(packed >> 32), static_cast<uint16_t>(packed >> 16), static_cast<uint16_t>(packed)};
+}
+
+inline glm::vec4 decodeRotation(const std::array<uint16_t, 3>& key) {
+    uint64_t packed = (static_cast<uint64_t>(key[0]) << 32) | (static_cast<uint64_t>(key[1]) << 16) | key[2];
+    auto largest = static_cast<int>((packed >> 45) & 0x3);
+
+    glm::vec4 q;
+    float sum = 0.0f;
+    int shift = 30;
+
+    for (int i = 0; i < 4; ++i) {
+        if (i == largest) continue;
+
+        float normalized = static_cast<float>((packed >> shift) & 0x7FFF) / 32767.0f;
+        q[i] = normalized * (2.0f * SMALLEST_THREE_RANGE) - SMALLEST_THREE_RANGE;
+        sum += q[i] * q[i];
+        shift -= 15;
+    }
+
+    q[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+
+    return q;
+}
+
+namespace engine {
+
+    CompressedClip::CompressedClip() = default;
+
+    void CompressedClip::compress(const Animation& animation, const Settings& settings) {
+        m_timeBase.clear();
+        m_tracks.assign(animation.m_samplers.size(), {});
+        m_keyTimes.clear();
+        m_keys.clear();
+        m_report = {};
+
+        std::vector<float> tolerances(animation.m_samplers.size(), settings.translationTolerance);
+
+        for (auto& channel : animation.m_channels) {
+            Track& track = m_tracks[channel.samplerIndex];
+
+            if (channel.path == Animation::Channel::PathType::ROTATION) {
+                track.encoding = Track::Encoding::ROTATION;
+                tolerances[channel.samplerIndex] = settings.rotationTolerance;
+            } else {
+                track.encoding = Track::Encoding::VECTOR;
+                tolerances[channel.samplerIndex] = channel.path == Animation::Channel::PathType::SCALE ?
+                                                   settings.scaleTolerance : settings.translationTolerance;
+            }
+        }
+
+        // Keyframe reduction, the key times left are merged in the clip time base
+        std::vector<std::vector<uint32_t>> keptKeys(animation.m_samplers.size());
+
+        for (uint32_t i = 0; i < animation.m_samplers.size(); ++i) {
+            const Animation::Sampler& sampler = animation.m_samplers[i];
+            Track& track = m_tracks[i];
+
+            m_report.rawKeys += sampler.inputs.size();
+            m_report.rawBytes += sampler.inputs.size() * sizeof(float) + sampler.outputs.size() * sizeof(glm::vec4);
+
+            if (sampler.interpolation == Animation::Sampler::InterpolationType::CUBICSPLINE || sampler.inputs.empty()
+                    || sampler.inputs.size() != sampler.outputs.size()) {
+                track.encoding = Track::Encoding::NONE;
+            }
+
+            if (track.encoding == Track::Encoding::NONE) continue;
+
+            track.step = sampler.interpolation == Animation::Sampler::InterpolationType::STEP;
+
+            // The range of the kept keys is never wider than the one of every key, its quantization error is bounded by this
+            float tolerance = tolerances[i];
+            if (track.encoding == Track::Encoding::VECTOR) tolerance = std::max(0.0f, tolerance - quantizationError(sampler.outputs));
+
+            keptKeys[i] = reduceKeys(sampler.inputs, sampler.outputs, track.encoding == Track::Encoding::ROTATION,
+                                     track.step, tolerance);
+
+            for (uint32_t key : keptKeys[i]) m_timeBase.push_back(sampler.inputs[key]);
+        }
+
+        std::sort(m_timeBase.begin(), m_timeBase.end());
+        m_timeBase.erase(std::unique(m_timeBase.begin(), m_timeBase.end(), [](float a, float b) {
+            return std::abs(a - b) <= KEY_TIME_EPSILON;
+        }), m_timeBase.end());
+
+        if (m_timeBase.size() > std::numeric_limits<uint16_t>::max()) {
+            spdlog::warn("[Animation] {} has too many key times to be compressed", animation.m_name);
+
+            for (auto& track : m_tracks) track.encoding = Track::Encoding::NONE;
+            m_timeBase.clear();
+            m_report.compressedKeys = m_report.rawKeys;
+            m_report.compressedBytes = m_report.rawBytes;
+
+            return;
+        }
+
+        // Quantization
+        for (uint32_t i = 0; i < animation.m_samplers.size(); ++i) {
+            const Animation::Sampler& sampler = animation.m_samplers[i];
+            Track& track = m_tracks[i];
+
+            if (track.encoding == Track::Encoding::NONE) {
+                m_report.compressedKeys += sampler.inputs.size();
+                m_report.compressedBytes += sampler.inputs.size() * sizeof(float) + sampler.outputs.size() * sizeof(glm::vec4);
+
+                continue;
+            }
+
+            track.firstKey = static_cast<uint32_t>(m_keys.size());
+            track.keyCount = static_cast<uint32_t>(keptKeys[i].size());
+
+            if (track.encoding == Track::Encoding::VECTOR) {
+                glm::vec3 rangeMax = glm::vec3(sampler.outputs[keptKeys[i].front()]);
+                track.rangeMin = rangeMax;
+
+                for (uint32_t key : keptKeys[i]) {
+                    track.rangeMin = glm::min(track.rangeMin, glm::vec3(sampler.outputs[key]));
+                    rangeMax = glm::max(rangeMax, glm::vec3(sampler.outputs[key]));
+                }
+
+                track.rangeExtent = rangeMax - track.rangeMin;
+            }
+
+            for (uint32_t key : keptKeys[i]) {
+                auto time = std::lower_bound(m_timeBase.begin(), m_timeBase.end(), sampler.inputs[key] - KEY_TIME_EPSILON);
+                m_keyTimes.push_back(static_cast<uint16_t>(time - m_timeBase.begin()));
+
+                if (track.encoding == Track::Encoding::ROTATION) {
+                    m_keys.push_back(encodeRotation(sampler.outputs[key]));
+                } else {
+                    std::array<uint16_t, 3> encoded{};
+
+                    for (int c = 0; c < 3; ++c) {
+                        float normalized = track.rangeExtent[c] > 0.0f ? (sampler.outputs[key][c] - track.rangeMin[c]) / track.rangeExtent[c] : 0.0f;
+                        encoded[c] = static_cast<uint16_t>(std::lround(glm::clamp(normalized, 0.0f, 1.0f) * 65535.0f));
+                    }
+
+                    m_keys.push_back(encoded);
+                }
+            }
+
+            m_report.compressedKeys += track.keyCount;
+        }
+
+        m_report.compressedBytes += m_timeBase.size() * sizeof(float) + m_keyTimes.size() * sizeof(uint16_t)
+                + m_keys.size() * sizeof(std::array<uint16_t, 3>) + m_tracks.size() * sizeof(Track);
+    }
+
+    bool CompressedClip::contains(uint32_t samplerIndex) const {
+        return samplerIndex < m_tracks.size() && m_tracks[samplerIndex].encoding != Track::Encoding::NONE;
+    }
+
+    glm::vec4 CompressedClip::sample(uint32_t samplerIndex, float time) const {
+        const Track& track = m_tracks[samplerIndex];
+        const uint16_t* keyTimes = &m_keyTimes[track.firstKey];
+        uint32_t lastKey = track.keyCount - 1;
+
+        if (track.keyCount == 1 || time <= m_timeBase[keyTimes[0]]) return decode(track, 0);
+
+        if (time >= m_timeBase[keyTimes[lastKey]]) return decode(track, lastKey);
+
+        const uint16_t* next = std::upper_bound(keyTimes, keyTimes + track.keyCount, time, [this](float t, uint16_t key) {
+            return t < m_timeBase[key];
+        });
+
+        auto nextKey = static_cast<uint32_t>(next - keyTimes);
+        glm::vec4 previous = decode(track, nextKey - 1);
+
+        if (track.step) return previous;
+
+        float start = m_timeBase[keyTimes[nextKey - 1]];
+        float end = m_timeBase[keyTimes[nextKey]];
+
+        return interpolate(previous, decode(track, nextKey), (time - start) / (end - start),
+                           track.encoding == Track::Encoding::ROTATION);
+    }
+
+    const CompressedClip::MemoryReport& CompressedClip::getReport() const {
+        return m_report;
+    }
+
+    glm::vec4 CompressedClip::decode(const Track& track, uint32_t key) const {
+        const std::array<uint16_t, 3>& encoded = m_keys[track.firstKey + key];
+
+        if (track.encoding == Track::Encoding::ROTATION) return decodeRotation(encoded);
+
+        glm::vec3 normalized = glm::vec3(encoded[0], encoded[1], encoded[2]) / 65535.0f;
+
+        return {track.rangeMin + normalized * track.rangeExtent, 0.0f};
+    }
+
+} // namespace engine
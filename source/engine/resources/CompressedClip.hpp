@@ -0,0 +1,70 @@
+#ifndef PROTOTYPE_ACTION_RPG_COMPRESSEDCLIP_HPP
+#define PROTOTYPE_ACTION_RPG_COMPRESSEDCLIP_HPP
+
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+
+namespace engine {
+
+    class Animation;
+
+    class CompressedClip {
+    public:
+        struct Settings {
+            float translationTolerance{0.0005f};
+            float rotationTolerance{0.0005f};
+            float scaleTolerance{0.0005f};
+        };
+
+        struct MemoryReport {
+            size_t rawKeys{};
+            size_t compressedKeys{};
+            size_t rawBytes{};
+            size_t compressedBytes{};
+        };
+
+        struct Track {
+            enum Encoding { NONE, VECTOR, ROTATION };
+
+            Encoding encoding{NONE};
+            bool step{false};
+            uint32_t firstKey{};
+            uint32_t keyCount{};
+            glm::vec3 rangeMin{};
+            glm::vec3 rangeExtent{};
+        };
+
+    public:
+        CompressedClip();
+
+        // Reduce and quantize every LINEAR/STEP sampler of the animation, CUBICSPLINE samplers are left untouched
+        void compress(const Animation& animation, const Settings& settings);
+
+        [[nodiscard]] bool contains(uint32_t samplerIndex) const;
+
+        [[nodiscard]] glm::vec4 sample(uint32_t samplerIndex, float time) const;
+
+        [[nodiscard]] const MemoryReport& getReport() const;
+
+    private:
+        [[nodiscard]] glm::vec4 decode(const Track& track, uint32_t key) const;
+
+    private:
+        // Key times shared by all the tracks of the clip, each key stores a 16 bits index into it
+        std::vector<float> m_timeBase;
+        std::vector<Track> m_tracks;
+        std::vector<uint16_t> m_keyTimes;
+        // 48 bits per key: smallest three for rotations, 16 bits per component for translations and scales
+        std::vector<std::array<uint16_t, 3>> m_keys;
+        MemoryReport m_report{};
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_COMPRESSEDCLIP_HPP
@@ -0,0 +1,185 @@
+#include "CookedModel.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+#include "GltfFile.hpp"
+
+
+inline bool fits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize) {
+    return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+}
+
+namespace engine {
+
+    CookedModel::CookedModel() = default;
+
+    bool CookedModel::isUpToDate(const std::string& cookedPath, const std::string& sourcePath) {
+        std::error_code error;
+        auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+
+        if (error) return false;
+
+        auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+
+        if (error) return true;
+
+        for (auto& buffer : GltfFile::getBufferFiles(sourcePath)) {
+            auto bufferTime = std::filesystem::last_write_time(buffer, error);
+
+            if (!error) sourceTime = std::max(sourceTime, bufferTime);
+        }
+
+        return cookedTime >= sourceTime;
+    }
+
+    bool CookedModel::open(const std::string& path, uint32_t staticVertexSize, uint32_t skinnedVertexSize) {
+        close();
+
+        if (!m_file.open(path)) return false;
+
+        m_header = m_file.getSize() >= sizeof(Header) ? section<Header>(0) : nullptr;
+
+        if (!m_header || !validate(staticVertexSize, skinnedVertexSize)) {
+            close();
+
+            return false;
+        }
+
+        return true;
+    }
+
+    void CookedModel::close() {
+        m_file.close();
+        m_header = nullptr;
+    }
+
+    const CookedModel::Header& CookedModel::getHeader() const {
+        return *m_header;
+    }
+
+    const CookedModel::NodeRecord* CookedModel::getNodes() const {
+        return section<NodeRecord>(m_header->nodesOffset);
+    }
+
+    const uint32_t* CookedModel::getChildren() const {
+        return section<uint32_t>(m_header->childrenOffset);
+    }
+
+    const CookedModel::MeshRecord* CookedModel::getMeshes() const {
+        return section<MeshRecord>(m_header->meshesOffset);
+    }
+
+    const CookedModel::SkinRecord* CookedModel::getSkins() const {
+        return section<SkinRecord>(m_header->skinsOffset);
+    }
+
+    const uint32_t* CookedModel::getJoints() const {
+        return section<uint32_t>(m_header->jointsOffset);
+    }
+
+    const float* CookedModel::getInverseBindMatrices() const {
+        return section<float>(m_header->inverseBindOffset);
+    }
+
+    const CookedModel::TextureRecord* CookedModel::getTextures() const {
+        return section<TextureRecord>(m_header->texturesOffset);
+    }
+
+    std::string_view CookedModel::getString(const String& string) const {
+        return {section<char>(m_header->stringsOffset + string.offset), string.length};
+    }
+
+    const void* CookedModel::getVertices(const MeshRecord& mesh) const {
+        return m_file.getData() + m_header->verticesOffset + mesh.vertexOffset;
+    }
+
+    const void* CookedModel::getIndices(const MeshRecord& mesh) const {
+        return m_file.getData() + m_header->indicesOffset + mesh.indexOffset;
+    }
+
+    const uint8_t* CookedModel::getImage(const TextureRecord& texture) const {
+        return texture.imageSize > 0 ? m_file.getData() + m_header->imagesOffset + texture.imageOffset : nullptr;
+    }
+
+    size_t CookedModel::getFileSize() const {
+        return m_file.getSize();
+    }
+
+    bool CookedModel::validate(uint32_t staticVertexSize, uint32_t skinnedVertexSize) const {
+        const Header& header = *m_header;
+        uint64_t size = m_file.getSize();
+
+        if (header.magic != MAGIC || header.version != VERSION || header.staticVertexSize != staticVertexSize
+                || header.skinnedVertexSize != skinnedVertexSize) {
+            return false;
+        }
+
+        bool sections = fits(header.nodesOffset, header.nodeCount, sizeof(NodeRecord), size)
+                && fits(header.childrenOffset, header.childCount, sizeof(uint32_t), size)
+                && fits(header.meshesOffset, header.meshCount, sizeof(MeshRecord), size)
+                && fits(header.skinsOffset, header.skinCount, sizeof(SkinRecord), size)
+                && fits(header.jointsOffset, header.jointCount, sizeof(uint32_t), size)
+                && fits(header.inverseBindOffset, header.jointCount, 16 * sizeof(float), size)
+                && fits(header.texturesOffset, header.textureCount, sizeof(TextureRecord), size)
+                && fits(header.stringsOffset, header.stringsSize, 1, size)
+                && fits(header.verticesOffset, header.vertexBytes, 1, size)
+                && fits(header.indicesOffset, header.indexBytes, 1, size)
+                && fits(header.imagesOffset, header.imageBytes, 1, size);
+
+        if (!sections || header.rootNode >= std::max(header.nodeCount, 1u)) return false;
+
+        auto validString = [&](const String& string) {
+            return static_cast<uint64_t>(string.offset) + string.length <= header.stringsSize;
+        };
+
+        for (uint32_t i = 0; i < header.nodeCount; ++i) {
+            const NodeRecord& node = getNodes()[i];
+
+            if (!validString(node.name) || node.parent >= static_cast<int32_t>(header.nodeCount)
+                    || node.mesh >= static_cast<int32_t>(header.meshCount) || node.skin >= static_cast<int32_t>(header.skinCount)
+                    || static_cast<uint64_t>(node.firstChild) + node.childCount > header.childCount) {
+                return false;
+            }
+        }
+
+        for (uint32_t i = 0; i < header.childCount; ++i) {
+            if (getChildren()[i] >= header.nodeCount) return false;
+        }
+
+        for (uint32_t i = 0; i < header.meshCount; ++i) {
+            const MeshRecord& mesh = getMeshes()[i];
+
+            uint64_t vertexSize = mesh.layout == 0 ? staticVertexSize : skinnedVertexSize;
+
+            if (!validString(mesh.name) || mesh.layout > 1 || mesh.vertexOffset + mesh.vertexCount * vertexSize > header.vertexBytes
+                    || (mesh.indexSize != sizeof(uint16_t) && mesh.indexSize != sizeof(uint32_t))
+                    || mesh.indexOffset + static_cast<uint64_t>(mesh.indexCount) * mesh.indexSize > header.indexBytes
+                    || (mesh.texture != NO_TEXTURE && mesh.texture >= header.textureCount)) {
+                return false;
+            }
+        }
+
+        for (uint32_t i = 0; i < header.skinCount; ++i) {
+            const SkinRecord& skin = getSkins()[i];
+
+            if (!validString(skin.name) || static_cast<uint64_t>(skin.firstJoint) + skin.jointCount > header.jointCount) return false;
+        }
+
+        for (uint32_t i = 0; i < header.jointCount; ++i) {
+            if (getJoints()[i] >= header.nodeCount) return false;
+        }
+
+        for (uint32_t i = 0; i < header.textureCount; ++i) {
+            const TextureRecord& texture = getTextures()[i];
+
+            if (!validString(texture.name) || !validString(texture.uri) || texture.imageOffset + texture.imageSize > header.imageBytes
+                    || texture.imageOffset + texture.imageSize < texture.imageOffset) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+} // namespace engine
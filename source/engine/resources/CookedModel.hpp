@@ -0,0 +1,160 @@
+#ifndef PROTOTYPE_ACTION_RPG_COOKEDMODEL_HPP
+#define PROTOTYPE_ACTION_RPG_COOKEDMODEL_HPP
+
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+#include "MappedFile.hpp"
+
+
+namespace engine {
+
+    // Model written by the AssetCooker, every section is a flat array that can be used straight from the mapped file.
+    // Vertices are packed in the static or skinned vertex layout of their mesh and indices in 16 or 32 bits, both are copied to
+    // the GPU as they are.
+    class CookedModel {
+    public:
+        static constexpr uint32_t MAGIC = 0x4C444D41; // "AMDL"
+        static constexpr uint32_t VERSION = 4;
+        static constexpr uint64_t SECTION_ALIGNMENT = 16;
+        static constexpr uint32_t NO_TEXTURE = UINT32_MAX;
+
+        struct String {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t staticVertexSize;
+            uint32_t skinnedVertexSize;
+            uint32_t rootNode;
+            uint32_t nodeCount;
+            uint32_t childCount;
+            uint32_t meshCount;
+            uint32_t skinCount;
+            uint32_t jointCount;
+            uint32_t textureCount;
+            uint32_t padding;
+            uint64_t vertexBytes;
+            uint64_t indexBytes;
+            uint64_t stringsSize;
+            uint64_t imageBytes;
+            uint64_t nodesOffset;
+            uint64_t childrenOffset;
+            uint64_t meshesOffset;
+            uint64_t skinsOffset;
+            uint64_t jointsOffset;
+            uint64_t inverseBindOffset;
+            uint64_t texturesOffset;
+            uint64_t stringsOffset;
+            uint64_t verticesOffset;
+            uint64_t indicesOffset;
+            uint64_t imagesOffset;
+        };
+
+        struct NodeRecord {
+            String name;
+            int32_t parent;
+            int32_t skin;
+            int32_t mesh;
+            uint32_t depth;
+            uint32_t firstChild;
+            uint32_t childCount;
+            float translation[3];
+            float rotation[4];
+            float scale[3];
+            float matrix[16];
+        };
+
+        struct MeshRecord {
+            String name;
+            uint32_t texture;
+            uint32_t vertexCount;
+            uint32_t indexCount;
+            // engine::VertexLayout
+            uint32_t layout;
+            // 2 or 4
+            uint32_t indexSize;
+            uint32_t padding;
+            // In bytes into the vertex and index sections
+            uint64_t vertexOffset;
+            uint64_t indexOffset;
+        };
+
+        // Joints and inverse bind matrices share the same range
+        struct SkinRecord {
+            String name;
+            int32_t rootNode;
+            uint32_t firstJoint;
+            uint32_t jointCount;
+        };
+
+        // An image embedded in the source model has no uri, its encoded file is copied in the image section
+        struct TextureRecord {
+            String name;
+            String uri;
+            uint64_t imageOffset;
+            uint64_t imageSize;
+        };
+
+    public:
+        CookedModel();
+
+        // The cooked file is at least as recent as the source model and every buffer file it references, a .bin edited
+        // alone makes the cook stale too. A cooked file without its source is up to date
+        static bool isUpToDate(const std::string& cookedPath, const std::string& sourcePath);
+
+        // Maps the file and checks that every section lies inside of it
+        bool open(const std::string& path, uint32_t staticVertexSize, uint32_t skinnedVertexSize);
+
+        void close();
+
+        [[nodiscard]] const Header& getHeader() const;
+
+        [[nodiscard]] const NodeRecord* getNodes() const;
+
+        [[nodiscard]] const uint32_t* getChildren() const;
+
+        [[nodiscard]] const MeshRecord* getMeshes() const;
+
+        [[nodiscard]] const SkinRecord* getSkins() const;
+
+        [[nodiscard]] const uint32_t* getJoints() const;
+
+        // 16 floats per joint, column major
+        [[nodiscard]] const float* getInverseBindMatrices() const;
+
+        [[nodiscard]] const TextureRecord* getTextures() const;
+
+        [[nodiscard]] std::string_view getString(const String& string) const;
+
+        [[nodiscard]] const void* getVertices(const MeshRecord& mesh) const;
+
+        [[nodiscard]] const void* getIndices(const MeshRecord& mesh) const;
+
+        // Encoded image of an embedded texture, nullptr when the texture is read from its uri
+        [[nodiscard]] const uint8_t* getImage(const TextureRecord& texture) const;
+
+        [[nodiscard]] size_t getFileSize() const;
+
+    private:
+        template<typename T>
+        [[nodiscard]] const T* section(uint64_t offset) const {
+            return reinterpret_cast<const T*>(m_file.getData() + offset);
+        }
+
+        [[nodiscard]] bool validate(uint32_t staticVertexSize, uint32_t skinnedVertexSize) const;
+
+    private:
+        MappedFile m_file;
+        const Header* m_header{};
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_COOKEDMODEL_HPP
@@ -0,0 +1,123 @@
+#include "FileWatcher.hpp"
+
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#include "spdlog/spdlog.h"
+
+
+// Wakes up the watcher thread regularly so stop does not wait for the next file event
+const int WATCH_POLL_TIMEOUT_MS = 100;
+
+namespace engine {
+
+    FileWatcher::FileWatcher() = default;
+
+    FileWatcher::~FileWatcher() {
+        stop();
+    }
+
+    bool FileWatcher::start() {
+#ifdef __linux__
+        if (m_running) return true;
+
+        m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (m_fd < 0) {
+            spdlog::error("[FileWatcher] inotify is not available");
+
+            return false;
+        }
+
+        m_running = true;
+        m_thread = std::thread(&FileWatcher::run, this);
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void FileWatcher::stop() {
+        if (!m_running) return;
+
+        m_running = false;
+        m_thread.join();
+
+#ifdef __linux__
+        close(m_fd);
+#endif
+        m_fd = -1;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_directories.clear();
+        m_changes.clear();
+    }
+
+    void FileWatcher::watch(const std::string& directory) {
+#ifdef __linux__
+        if (!m_running) return;
+
+        std::string path = std::filesystem::path(directory).lexically_normal().string();
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& watched : m_directories) {
+            if (watched.second == path) return;
+        }
+
+        // Editors either rewrite the file or move a temporary file over it
+        int wd = inotify_add_watch(m_fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+        if (wd < 0) {
+            spdlog::warn("[FileWatcher] {} can not be watched", path);
+
+            return;
+        }
+
+        m_directories[wd] = path;
+#endif
+    }
+
+    std::vector<std::string> FileWatcher::takeChanges() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<std::string> changes(m_changes.begin(), m_changes.end());
+        m_changes.clear();
+
+        return changes;
+    }
+
+    bool FileWatcher::isRunning() const {
+        return m_running;
+    }
+
+    void FileWatcher::run() {
+#ifdef __linux__
+        alignas(inotify_event) char buffer[4096];
+        pollfd descriptor{.fd = m_fd, .events = POLLIN, .revents = 0};
+
+        while (m_running) {
+            if (::poll(&descriptor, 1, WATCH_POLL_TIMEOUT_MS) <= 0) continue;
+
+            ssize_t length;
+            while ((length = read(m_fd, buffer, sizeof(buffer))) > 0) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                for (char* it = buffer; it < buffer + length; it += sizeof(inotify_event) + reinterpret_cast<inotify_event*>(it)->len) {
+                    auto* event = reinterpret_cast<inotify_event*>(it);
+                    auto directory = m_directories.find(event->wd);
+
+                    if (event->len == 0 || directory == m_directories.end()) continue;
+
+                    m_changes.insert((std::filesystem::path(directory->second) / event->name).string());
+                }
+            }
+        }
+#endif
+    }
+
+} // namespace engine
@@ -0,0 +1,55 @@
+#ifndef PROTOTYPE_ACTION_RPG_FILEWATCHER_HPP
+#define PROTOTYPE_ACTION_RPG_FILEWATCHER_HPP
+
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace engine {
+
+    // Collects the files written or moved into the watched directories from a background thread. Built on inotify,
+    // on other platforms start fails and nothing is ever reported
+    class FileWatcher {
+    public:
+        FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        ~FileWatcher();
+
+        bool start();
+
+        void stop();
+
+        // Directories are not watched recursively, watching the same directory twice does nothing
+        void watch(const std::string& directory);
+
+        // Every file changed since the last call, once each even when it was written several times
+        std::vector<std::string> takeChanges();
+
+        [[nodiscard]] bool isRunning() const;
+
+    private:
+        void run();
+
+    private:
+        int m_fd{-1};
+        std::thread m_thread;
+        std::atomic<bool> m_running{false};
+        std::mutex m_mutex;
+        std::unordered_map<int, std::string> m_directories;
+        std::unordered_set<std::string> m_changes;
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_FILEWATCHER_HPP
@@ -0,0 +1,341 @@
+#include "GltfFile.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+
+// Images are decoded by the resource manager from their file or buffer view, tinygltf only records them
+inline bool skipImage(tinygltf::Image*, const int, std::string*, std::string*, int, int, const unsigned char*, int, void*) {
+    return true;
+}
+
+inline uint32_t readWord(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(uint32_t));
+
+    return value;
+}
+
+inline bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+
+    return false;
+}
+
+inline int getType(const std::string& type) {
+    if (type == "SCALAR") return TINYGLTF_TYPE_SCALAR;
+    if (type == "VEC2") return TINYGLTF_TYPE_VEC2;
+    if (type == "VEC3") return TINYGLTF_TYPE_VEC3;
+    if (type == "VEC4") return TINYGLTF_TYPE_VEC4;
+    if (type == "MAT2") return TINYGLTF_TYPE_MAT2;
+    if (type == "MAT3") return TINYGLTF_TYPE_MAT3;
+    if (type == "MAT4") return TINYGLTF_TYPE_MAT4;
+
+    return -1;
+}
+
+// Sections are iterated in place, json::value would copy them
+inline const json& section(const json& object, const char* key) {
+    static const json empty = json::array();
+    auto it = object.find(key);
+
+    return it != object.end() ? *it : empty;
+}
+
+template<typename T>
+inline std::vector<T> readArray(const json& object, const char* key) {
+    auto it = object.find(key);
+
+    return it != object.end() ? it->get<std::vector<T>>() : std::vector<T>{};
+}
+
+namespace engine {
+
+    GltfFile::GltfFile() = default;
+
+    GltfFile::~GltfFile() = default;
+
+    bool GltfFile::load(const std::string& path, std::string* error) {
+        m_model = {};
+        m_files.clear();
+        m_buffers.clear();
+        m_byteLengths.clear();
+        m_mapped = std::filesystem::path(path).extension() == ".glb";
+
+        if (m_mapped) return loadBinary(path, error);
+
+        tinygltf::TinyGLTF loader;
+        std::string loaderError, warning;
+
+        loader.SetImageLoader(skipImage, nullptr);
+
+        if (!loader.LoadASCIIFromFile(&m_model, &loaderError, &warning, path)) return fail(error, loaderError);
+
+        for (auto& buffer : m_model.buffers) m_buffers.push_back(buffer.data.data());
+
+        return true;
+    }
+
+    std::vector<std::string> GltfFile::getBufferFiles(const std::string& path) {
+        std::string text;
+
+        if (std::filesystem::path(path).extension() == ".glb") {
+            MappedFile file;
+
+            if (!file.open(path) || file.getSize() < 20 || readWord(file.getData()) != GLB_MAGIC
+                    || readWord(file.getData() + 16) != CHUNK_JSON || 20 + static_cast<size_t>(readWord(file.getData() + 12)) > file.getSize()) {
+                return {};
+            }
+
+            text.assign(reinterpret_cast<const char*>(file.getData() + 20), readWord(file.getData() + 12));
+        } else {
+            std::ifstream file(path, std::ios::binary);
+            text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        json document = json::parse(text, nullptr, false);
+        std::vector<std::string> files;
+
+        if (document.is_discarded() || !document.is_object()) return files;
+
+        for (auto& buffer : section(document, "buffers")) {
+            std::string uri = buffer.value("uri", "");
+
+            if (!uri.empty() && uri.rfind("data:", 0) != 0) files.push_back((std::filesystem::path(path).parent_path() / uri).string());
+        }
+
+        return files;
+    }
+
+    bool GltfFile::loadBinary(const std::string& path, std::string* error) {
+        m_files.emplace_back();
+        MappedFile& file = m_files.back();
+
+        if (!file.open(path)) return fail(error, "cannot open " + path);
+
+        const uint8_t* data = file.getData();
+        size_t size = file.getSize();
+
+        // 12 bytes header then chunks of length, type and data, the JSON chunk first and an optional BIN chunk
+        if (size < 20 || readWord(data) != GLB_MAGIC || readWord(data + 4) != GLB_VERSION || readWord(data + 8) > size) {
+            return fail(error, path + " is not a glTF 2.0 binary file");
+        }
+
+        size = readWord(data + 8);
+        uint32_t jsonLength = readWord(data + 12);
+
+        if (readWord(data + 16) != CHUNK_JSON || 20 + static_cast<size_t>(jsonLength) > size) {
+            return fail(error, path + " has no valid JSON chunk");
+        }
+
+        const char* jsonBegin = reinterpret_cast<const char*>(data + 20);
+        size_t binOffset = 20 + ((static_cast<size_t>(jsonLength) + 3) & ~static_cast<size_t>(3));
+        const uint8_t* bin = nullptr;
+        size_t binLength = 0;
+
+        if (binOffset + 8 <= size && readWord(data + binOffset + 4) == CHUNK_BIN) {
+            binLength = readWord(data + binOffset);
+
+            if (binOffset + 8 + binLength > size) return fail(error, path + " has a truncated BIN chunk");
+
+            bin = data + binOffset + 8;
+        }
+
+        if (!parseJson(jsonBegin, jsonBegin + jsonLength, std::filesystem::path(path).stem().string(), error)) return false;
+
+        // Only the first buffer may be stored in the BIN chunk, the others are external files
+        for (size_t i = 0; i < m_model.buffers.size(); ++i) {
+            const tinygltf::Buffer& buffer = m_model.buffers[i];
+            const uint8_t* bufferData = nullptr;
+            size_t bufferSize = 0;
+
+            if (buffer.uri.empty()) {
+                if (i != 0 || !bin) return fail(error, path + ": buffer " + std::to_string(i) + " has no data");
+
+                bufferData = bin;
+                bufferSize = binLength;
+            } else if (buffer.uri.rfind("data:", 0) == 0) {
+                return fail(error, path + ": embedded data URIs are not supported in binary files");
+            } else {
+                m_files.emplace_back();
+                MappedFile& external = m_files.back();
+                std::string externalPath = (std::filesystem::path(path).parent_path() / buffer.uri).string();
+
+                if (!external.open(externalPath)) return fail(error, "cannot open " + externalPath);
+
+                bufferData = external.getData();
+                bufferSize = external.getSize();
+            }
+
+            if (bufferSize < m_byteLengths[i]) return fail(error, path + ": buffer " + std::to_string(i) + " is truncated");
+
+            m_buffers.push_back(bufferData);
+        }
+
+        for (auto& view : m_model.bufferViews) {
+            if (view.buffer < 0 || view.buffer >= static_cast<int>(m_buffers.size())
+                    || view.byteOffset + view.byteLength > m_byteLengths[view.buffer]) {
+                return fail(error, path + ": buffer view out of its buffer");
+            }
+        }
+
+        return true;
+    }
+
+    bool GltfFile::parseJson(const char* begin, const char* end, const std::string& stem, std::string* error) {
+        json document = json::parse(begin, end, nullptr, false);
+
+        if (document.is_discarded() || !document.is_object()) return fail(error, "invalid JSON chunk");
+
+        try {
+            m_model.defaultScene = document.value("scene", 0);
+
+            for (auto& input : section(document, "scenes")) {
+                tinygltf::Scene& scene = m_model.scenes.emplace_back();
+                scene.name = input.value("name", "");
+                scene.nodes = readArray<int>(input, "nodes");
+            }
+
+            for (auto& input : section(document, "nodes")) {
+                tinygltf::Node& node = m_model.nodes.emplace_back();
+                node.name = input.value("name", "");
+                node.mesh = input.value("mesh", -1);
+                node.skin = input.value("skin", -1);
+                node.children = readArray<int>(input, "children");
+                node.translation = readArray<double>(input, "translation");
+                node.rotation = readArray<double>(input, "rotation");
+                node.scale = readArray<double>(input, "scale");
+                node.matrix = readArray<double>(input, "matrix");
+            }
+
+            for (auto& input : section(document, "meshes")) {
+                tinygltf::Mesh& mesh = m_model.meshes.emplace_back();
+                mesh.name = input.value("name", "");
+
+                for (auto& inputPrimitive : section(input, "primitives")) {
+                    tinygltf::Primitive& primitive = mesh.primitives.emplace_back();
+                    primitive.material = inputPrimitive.value("material", -1);
+                    primitive.indices = inputPrimitive.value("indices", -1);
+                    primitive.mode = inputPrimitive.value("mode", TINYGLTF_MODE_TRIANGLES);
+                    primitive.attributes = inputPrimitive.value("attributes", std::map<std::string, int>{});
+                }
+            }
+
+            for (auto& input : section(document, "accessors")) {
+                tinygltf::Accessor& accessor = m_model.accessors.emplace_back();
+                accessor.bufferView = input.value("bufferView", -1);
+                accessor.byteOffset = input.value("byteOffset", size_t{0});
+                accessor.componentType = input.value("componentType", -1);
+                accessor.normalized = input.value("normalized", false);
+                accessor.count = input.value("count", size_t{0});
+                accessor.type = getType(input.value("type", ""));
+            }
+
+            for (auto& input : section(document, "bufferViews")) {
+                tinygltf::BufferView& view = m_model.bufferViews.emplace_back();
+                view.buffer = input.value("buffer", -1);
+                view.byteOffset = input.value("byteOffset", size_t{0});
+                view.byteLength = input.value("byteLength", size_t{0});
+                view.byteStride = input.value("byteStride", size_t{0});
+            }
+
+            // Buffer bytes stay in the mapping, the byte lengths are kept to validate the views against them
+            for (auto& input : section(document, "buffers")) {
+                tinygltf::Buffer& buffer = m_model.buffers.emplace_back();
+                buffer.uri = input.value("uri", "");
+                m_byteLengths.push_back(input.value("byteLength", size_t{0}));
+            }
+
+            for (auto& input : section(document, "materials")) {
+                tinygltf::Material& material = m_model.materials.emplace_back();
+                material.name = input.value("name", "");
+
+                auto pbr = input.find("pbrMetallicRoughness");
+                if (pbr != input.end() && pbr->contains("baseColorTexture")) {
+                    material.pbrMetallicRoughness.baseColorTexture.index = pbr->at("baseColorTexture").value("index", -1);
+                }
+            }
+
+            for (auto& input : section(document, "textures")) {
+                tinygltf::Texture& texture = m_model.textures.emplace_back();
+                texture.source = input.value("source", -1);
+            }
+
+            // Textures are looked up by name, images without one are named after their file or their index
+            for (auto& input : section(document, "images")) {
+                tinygltf::Image& image = m_model.images.emplace_back();
+                image.uri = input.value("uri", "");
+                image.mimeType = input.value("mimeType", "");
+                image.bufferView = input.value("bufferView", -1);
+                image.name = input.value("name", "");
+
+                if (image.name.empty()) {
+                    image.name = !image.uri.empty() ? image.uri : stem + "_image" + std::to_string(m_model.images.size() - 1);
+                }
+            }
+
+            for (auto& input : section(document, "skins")) {
+                tinygltf::Skin& skin = m_model.skins.emplace_back();
+                skin.name = input.value("name", "");
+                skin.inverseBindMatrices = input.value("inverseBindMatrices", -1);
+                skin.skeleton = input.value("skeleton", -1);
+                skin.joints = readArray<int>(input, "joints");
+            }
+
+            for (auto& input : section(document, "animations")) {
+                tinygltf::Animation& animation = m_model.animations.emplace_back();
+                animation.name = input.value("name", "");
+
+                for (auto& inputSampler : section(input, "samplers")) {
+                    tinygltf::AnimationSampler& sampler = animation.samplers.emplace_back();
+                    sampler.input = inputSampler.value("input", -1);
+                    sampler.output = inputSampler.value("output", -1);
+                    sampler.interpolation = inputSampler.value("interpolation", "LINEAR");
+                }
+
+                for (auto& inputChannel : section(input, "channels")) {
+                    tinygltf::AnimationChannel& channel = animation.channels.emplace_back();
+                    channel.sampler = inputChannel.value("sampler", -1);
+
+                    auto target = inputChannel.find("target");
+                    if (target != inputChannel.end()) {
+                        channel.target_node = target->value("node", -1);
+                        channel.target_path = target->value("path", "");
+                    }
+                }
+            }
+        } catch (const json::exception& exception) {
+            return fail(error, exception.what());
+        }
+
+        return true;
+    }
+
+    const tinygltf::Model& GltfFile::getModel() const {
+        return m_model;
+    }
+
+    const uint8_t* GltfFile::getBuffer(int buffer) const {
+        return buffer >= 0 && buffer < static_cast<int>(m_buffers.size()) ? m_buffers[buffer] : nullptr;
+    }
+
+    const uint8_t* GltfFile::getBufferView(int bufferView) const {
+        if (bufferView < 0 || bufferView >= static_cast<int>(m_model.bufferViews.size())) return nullptr;
+
+        const tinygltf::BufferView& view = m_model.bufferViews[bufferView];
+        const uint8_t* buffer = getBuffer(view.buffer);
+
+        return buffer ? buffer + view.byteOffset : nullptr;
+    }
+
+    bool GltfFile::isMapped() const {
+        return m_mapped;
+    }
+
+} // namespace engine
@@ -0,0 +1,67 @@
+#ifndef PROTOTYPE_ACTION_RPG_GLTFFILE_HPP
+#define PROTOTYPE_ACTION_RPG_GLTFFILE_HPP
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#include "tiny_gltf.h"
+
+#include "MappedFile.hpp"
+
+
+namespace engine {
+
+    // A glTF model and the bytes of its buffers. A .gltf is read by tinygltf, which copies its buffers, without decoding
+    // the images. A .glb is mapped and only the JSON sections the engine uses are parsed, cameras, materials beyond the
+    // base color, extensions and extras are skipped. Accessors then read the binary chunk in place
+    class GltfFile {
+    public:
+        static constexpr uint32_t GLB_MAGIC = 0x46546C67;
+        static constexpr uint32_t GLB_VERSION = 2;
+        static constexpr uint32_t CHUNK_JSON = 0x4E4F534A;
+        static constexpr uint32_t CHUNK_BIN = 0x004E4942;
+
+    public:
+        GltfFile();
+
+        GltfFile(const GltfFile&) = delete;
+
+        GltfFile& operator=(const GltfFile&) = delete;
+
+        ~GltfFile();
+
+        bool load(const std::string& path, std::string* error = nullptr);
+
+        // External buffer files of a .gltf or .glb, next to it, read from the JSON alone. Embedded buffers are not listed
+        static std::vector<std::string> getBufferFiles(const std::string& path);
+
+        [[nodiscard]] const tinygltf::Model& getModel() const;
+
+        // Start of the buffer, in the mapping for a .glb. nullptr when the index is out of range
+        [[nodiscard]] const uint8_t* getBuffer(int buffer) const;
+
+        [[nodiscard]] const uint8_t* getBufferView(int bufferView) const;
+
+        [[nodiscard]] bool isMapped() const;
+
+    private:
+        bool loadBinary(const std::string& path, std::string* error);
+
+        bool parseJson(const char* begin, const char* end, const std::string& stem, std::string* error);
+
+    private:
+        tinygltf::Model m_model;
+        // The .glb and the external buffers it references, mappings keep their address when the vector grows
+        std::vector<MappedFile> m_files;
+        std::vector<const uint8_t*> m_buffers;
+        std::vector<size_t> m_byteLengths;
+        bool m_mapped{};
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_GLTFFILE_HPP
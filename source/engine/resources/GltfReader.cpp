@@ -0,0 +1,219 @@
+#include "GltfReader.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+#include "spdlog/spdlog.h"
+
+
+template<typename T>
+inline T load(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+
+    return value;
+}
+
+inline int findAttribute(const tinygltf::Primitive& primitive, const std::string& name) {
+    auto attribute = primitive.attributes.find(name);
+
+    return attribute != primitive.attributes.end() ? attribute->second : -1;
+}
+
+namespace engine {
+
+    AccessorView::AccessorView() = default;
+
+    AccessorView::AccessorView(const GltfFile& file, int accessorIndex) {
+        const tinygltf::Model& model = file.getModel();
+
+        if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size())) return;
+
+        const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+
+        // Sparse accessors without a buffer view are not supported
+        if (accessor.bufferView < 0) return;
+
+        const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+        const uint8_t* data = file.getBufferView(accessor.bufferView);
+        int stride = accessor.ByteStride(view);
+
+        if (stride <= 0 || !data) return;
+
+        m_data = data + accessor.byteOffset;
+        m_count = accessor.count;
+        m_stride = static_cast<size_t>(stride);
+        m_componentType = accessor.componentType;
+        m_componentCount = tinygltf::GetNumComponentsInType(accessor.type);
+        m_normalized = accessor.normalized;
+    }
+
+    bool AccessorView::isValid() const {
+        return m_data != nullptr;
+    }
+
+    size_t AccessorView::size() const {
+        return m_count;
+    }
+
+    int AccessorView::getComponentType() const {
+        return m_componentType;
+    }
+
+    glm::vec4 AccessorView::read(size_t index) const {
+        glm::vec4 value(0.0f);
+        const uint8_t* element = m_data + index * m_stride;
+
+        for (int c = 0; c < std::min(m_componentCount, 4); ++c) value[c] = readComponent(element, c);
+
+        return value;
+    }
+
+    glm::mat4 AccessorView::readMatrix(size_t index) const {
+        if (m_componentCount != 16) return glm::mat4(1.0f);
+
+        glm::mat4 value;
+        const uint8_t* element = m_data + index * m_stride;
+
+        for (int c = 0; c < 16; ++c) value[c / 4][c % 4] = readComponent(element, c);
+
+        return value;
+    }
+
+    uint32_t AccessorView::readIndex(size_t index) const {
+        const uint8_t* element = m_data + index * m_stride;
+
+        switch (m_componentType) {
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                return load<uint32_t>(element);
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                return load<uint16_t>(element);
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                return load<uint8_t>(element);
+            default:
+                return 0;
+        }
+    }
+
+    float AccessorView::readComponent(const uint8_t* element, int component) const {
+        switch (m_componentType) {
+            case TINYGLTF_COMPONENT_TYPE_FLOAT:
+                return load<float>(element + component * sizeof(float));
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+                float value = load<uint8_t>(element + component);
+
+                return m_normalized ? value / 255.0f : value;
+            }
+            case TINYGLTF_COMPONENT_TYPE_BYTE: {
+                float value = load<int8_t>(element + component);
+
+                return m_normalized ? std::max(value / 127.0f, -1.0f) : value;
+            }
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+                float value = load<uint16_t>(element + component * sizeof(uint16_t));
+
+                return m_normalized ? value / 65535.0f : value;
+            }
+            case TINYGLTF_COMPONENT_TYPE_SHORT: {
+                float value = load<int16_t>(element + component * sizeof(int16_t));
+
+                return m_normalized ? std::max(value / 32767.0f, -1.0f) : value;
+            }
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                return static_cast<float>(load<uint32_t>(element + component * sizeof(uint32_t)));
+            default:
+                return 0.0f;
+        }
+    }
+
+    namespace gltf {
+
+        bool readMesh(const GltfFile& file, const tinygltf::Mesh& mesh, std::vector<Vertex>& vertices,
+                      std::vector<uint32_t>& indices) {
+            bool skinned = false;
+
+            for (auto& primitive : mesh.primitives) {
+                AccessorView positions(file, findAttribute(primitive, "POSITION"));
+
+                if (!positions.isValid()) continue;
+
+                AccessorView normals(file, findAttribute(primitive, "NORMAL"));
+                AccessorView uv0(file, findAttribute(primitive, "TEXCOORD_0"));
+                AccessorView uv1(file, findAttribute(primitive, "TEXCOORD_1"));
+                AccessorView joints(file, findAttribute(primitive, "JOINTS_0"));
+                AccessorView weights(file, findAttribute(primitive, "WEIGHTS_0"));
+
+                bool hasSkin = joints.isValid() && weights.isValid();
+
+                if (hasSkin && joints.getComponentType() != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT
+                        && joints.getComponentType() != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+                    spdlog::error("Joint component type {} not supported!", joints.getComponentType());
+                    hasSkin = false;
+                }
+
+                skinned |= hasSkin;
+
+                size_t vertexStart = vertices.size();
+                vertices.resize(vertexStart + positions.size());
+
+                for (size_t v = 0; v < positions.size(); ++v) {
+                    Vertex& vert = vertices[vertexStart + v];
+                    vert.position = glm::vec3(positions.read(v));
+                    vert.normal = normals.isValid() ? glm::normalize(glm::vec3(normals.read(v))) : glm::vec3(0.0f);
+                    vert.uv0 = uv0.isValid() ? glm::vec2(uv0.read(v)) : glm::vec2(0.0f);
+                    vert.uv1 = uv1.isValid() ? glm::vec2(uv1.read(v)) : glm::vec2(0.0f);
+                    vert.joint0 = hasSkin ? joints.read(v) : glm::vec4(0.0f);
+                    vert.weight0 = hasSkin ? weights.read(v) : glm::vec4(0.0f);
+
+                    // Fix for all zero weights
+                    if (glm::length(vert.weight0) == 0.0f)
+                        vert.weight0 = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+                }
+
+                auto base = static_cast<uint32_t>(vertexStart);
+
+                if (primitive.indices > -1) {
+                    AccessorView primitiveIndices(file, primitive.indices);
+
+                    if (primitiveIndices.getComponentType() != TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT
+                            && primitiveIndices.getComponentType() != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT
+                            && primitiveIndices.getComponentType() != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
+                        spdlog::error("Index component type {} not supported!", primitiveIndices.getComponentType());
+                        continue;
+                    }
+
+                    size_t indexStart = indices.size();
+                    indices.resize(indexStart + primitiveIndices.size());
+
+                    for (size_t i = 0; i < primitiveIndices.size(); ++i) indices[indexStart + i] = base + primitiveIndices.readIndex(i);
+                } else {
+                    // Non indexed primitive
+                    for (uint32_t i = 0; i < positions.size(); ++i) indices.push_back(base + i);
+                }
+            }
+
+            return skinned;
+        }
+
+        void readSkin(const GltfFile& file, const tinygltf::Skin& skin, std::vector<uint32_t>& joints,
+                      std::vector<glm::mat4>& inverseBindMatrices) {
+            joints.assign(skin.joints.begin(), skin.joints.end());
+            inverseBindMatrices.assign(joints.size(), glm::mat4(1.0f));
+
+            AccessorView matrices(file, skin.inverseBindMatrices);
+
+            for (size_t i = 0; i < std::min(matrices.size(), joints.size()); ++i) inverseBindMatrices[i] = matrices.readMatrix(i);
+        }
+
+        int getBaseColorImage(const tinygltf::Model& model, const tinygltf::Mesh& mesh) {
+            if (mesh.primitives.empty() || mesh.primitives[0].material < 0) return -1;
+
+            const tinygltf::Material& material = model.materials[mesh.primitives[0].material];
+            int texture = material.pbrMetallicRoughness.baseColorTexture.index;
+
+            return texture > -1 ? model.textures[texture].source : -1;
+        }
+
+    } // namespace gltf
+
+} // namespace engine
@@ -0,0 +1,66 @@
+#ifndef PROTOTYPE_ACTION_RPG_GLTFREADER_HPP
+#define PROTOTYPE_ACTION_RPG_GLTFREADER_HPP
+
+
+#include <vector>
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+#include "GltfFile.hpp"
+#include "../mesh/Vertex.hpp"
+
+
+namespace engine {
+
+    // Strided view over a glTF accessor, components are converted to float (or to uint32 for indices) when read.
+    // The data is read in place from the buffers of the file, the file has to outlive the view
+    class AccessorView {
+    public:
+        AccessorView();
+
+        AccessorView(const GltfFile& file, int accessorIndex);
+
+        [[nodiscard]] bool isValid() const;
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] int getComponentType() const;
+
+        [[nodiscard]] glm::vec4 read(size_t index) const;
+
+        [[nodiscard]] glm::mat4 readMatrix(size_t index) const;
+
+        [[nodiscard]] uint32_t readIndex(size_t index) const;
+
+    private:
+        [[nodiscard]] float readComponent(const uint8_t* element, int component) const;
+
+    private:
+        const uint8_t* m_data{};
+        size_t m_count{};
+        size_t m_stride{};
+        int m_componentType{};
+        int m_componentCount{};
+        bool m_normalized{};
+    };
+
+    namespace gltf {
+
+        // Appends every primitive of the mesh, indices are rebased on the vertices already written.
+        // Returns true when the mesh has joints and weights.
+        bool readMesh(const GltfFile& file, const tinygltf::Mesh& mesh, std::vector<Vertex>& vertices,
+                      std::vector<uint32_t>& indices);
+
+        void readSkin(const GltfFile& file, const tinygltf::Skin& skin, std::vector<uint32_t>& joints,
+                      std::vector<glm::mat4>& inverseBindMatrices);
+
+        // Image of the base color texture used by the first primitive, -1 when the mesh has none
+        int getBaseColorImage(const tinygltf::Model& model, const tinygltf::Mesh& mesh);
+
+    } // namespace gltf
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_GLTFREADER_HPP
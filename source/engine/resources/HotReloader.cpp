@@ -0,0 +1,174 @@
+#include "HotReloader.hpp"
+
+#include <chrono>
+#include <utility>
+#include <filesystem>
+#include <unordered_set>
+
+#include "spdlog/spdlog.h"
+
+#include "../Utilities.hpp"
+#include "../Application.hpp"
+
+
+namespace engine {
+
+    HotReloader::HotReloader(std::shared_ptr<engine::Device> device) : m_device(std::move(device)) {
+
+    }
+
+    HotReloader::~HotReloader() = default;
+
+    void HotReloader::start() {
+        if (!m_watcher.start()) {
+            spdlog::warn("[HotReload] File watching is not supported, assets will not be reloaded");
+            return;
+        }
+
+        m_watchedSources = 0;
+        watchSources();
+    }
+
+    void HotReloader::stop() {
+        m_watcher.stop();
+    }
+
+    void HotReloader::update() {
+        if (!m_watcher.isRunning()) return;
+
+        watchSources();
+
+        for (auto& path : m_watcher.takeChanges()) {
+            const ResourceManager::AssetSource* source = Application::m_resourceManager->findSource(path);
+
+            if (!source) continue;
+
+            uint32_t generation = ++m_generations[path];
+            Application::m_threadPool->submit([this, path, source = *source, generation] {
+                decode(path, source, generation);
+            });
+        }
+
+        std::vector<Decoded> decoded;
+        {
+            std::lock_guard<std::mutex> lock(m_decodedMutex);
+            decoded.swap(m_decoded);
+        }
+
+        std::erase_if(decoded, [this](const Decoded& asset) { return asset.generation != m_generations[asset.path]; });
+
+        if (decoded.empty()) return;
+
+        // Nothing recorded with the old resources can still be executing once they are replaced, and no scene task can
+        // still be reading the models and clips overwritten in place
+        auto start = std::chrono::high_resolution_clock::now();
+        Application::m_scene->wait();
+        m_device->m_logicalDevice.waitIdle();
+
+        for (auto& asset : decoded) {
+            asset.apply();
+            spdlog::info("[HotReload] {} reloaded", asset.path);
+        }
+
+        std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+        spdlog::info("[HotReload] {} assets replaced in {:.2f} ms", decoded.size(), time.count());
+    }
+
+    void HotReloader::watchSources() {
+        const auto& sources = Application::m_resourceManager->getSources();
+
+        if (sources.size() == m_watchedSources) return;
+
+        std::unordered_set<std::string> directories;
+        for (auto& source : sources) directories.insert(std::filesystem::path(source.first).parent_path().string());
+
+        for (auto& directory : directories) m_watcher.watch(directory);
+
+        m_watchedSources = sources.size();
+    }
+
+    void HotReloader::decode(const std::string& path, const ResourceManager::AssetSource& source, uint32_t generation) {
+        std::function<void()> apply;
+
+        try {
+            switch (source.type) {
+                case ResourceManager::AssetType::TEXTURE: {
+                    int width, height;
+                    vk::DeviceSize size;
+                    std::shared_ptr<stbi_uc> pixels(engine::tools::loadTextureFile(source.uri, &width, &height, &size), stbi_image_free);
+
+                    apply = [name = source.name, pixels, width, height, size] {
+                        Application::m_resourceManager->reloadTexture(name, pixels.get(), width, height, size);
+                    };
+                    break;
+                }
+                case ResourceManager::AssetType::MODEL: {
+                    std::string cookedPath = MODELS_DIR + source.uri + COOKED_MODEL_EXTENSION;
+                    std::string extension = std::filesystem::path(path).extension().string();
+
+                    if (extension == COOKED_MODEL_EXTENSION) {
+                        auto cooked = std::make_shared<CookedModel>();
+
+                        if (!cooked->open(cookedPath, sizeof(StaticVertex), sizeof(SkinnedVertex))) {
+                            throw std::runtime_error("invalid cooked model");
+                        }
+
+                        apply = [name = source.name, cooked] { Application::m_resourceManager->reloadModel(name, *cooked); };
+                        break;
+                    }
+
+                    // The cooked file is now older than the source, the runtime loads the source until it is cooked again
+                    if (std::filesystem::exists(cookedPath)) {
+                        spdlog::info("[HotReload] {} changed, {} is stale until the AssetCooker is run", path, cookedPath);
+                    }
+
+                    // The binary file of a model is loaded before its text file, only its changes are applied
+                    if (extension == ".gltf" && std::filesystem::exists(MODELS_DIR + source.uri + ".glb")) {
+                        return;
+                    }
+
+                    // A changed buffer reloads the file of the model that references it
+                    std::string modelPath = path;
+                    if (extension != ".gltf" && extension != ".glb") {
+                        modelPath = std::filesystem::exists(MODELS_DIR + source.uri + ".glb") ? MODELS_DIR + source.uri + ".glb" : MODELS_DIR + source.uri + ".gltf";
+                    }
+
+                    auto model = std::make_shared<GltfFile>();
+                    std::string error;
+
+                    if (!model->load(modelPath, &error)) throw std::runtime_error(error);
+
+                    apply = [name = source.name, model] { Application::m_resourceManager->reloadModel(name, *model); };
+                    break;
+                }
+                case ResourceManager::AssetType::ANIMATION: {
+                    GltfFile inputFile;
+                    std::string error;
+
+                    // The clip file itself, path may be one of its buffers
+                    if (!inputFile.load(ANIMATIONS_DIR + source.uri, &error)) throw std::runtime_error(error);
+
+                    if (inputFile.getModel().animations.empty()) throw std::runtime_error("no animation in the file");
+
+                    std::shared_ptr<Animation> animation = ResourceManager::createAnimation(inputFile);
+
+                    apply = [name = source.name, animation] { Application::m_resourceManager->reloadAnimation(name, animation); };
+                    break;
+                }
+                case ResourceManager::AssetType::SHADER: {
+                    auto code = std::make_shared<std::vector<uint32_t>>(engine::tools::readFile(path));
+
+                    apply = [file = source.uri, code] { Application::m_resourceManager->reloadShader(file, *code); };
+                    break;
+                }
+            }
+        } catch (const std::exception& e) {
+            spdlog::error("[HotReload] {} could not be decoded: {}", path, e.what());
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        m_decoded.push_back({path, generation, std::move(apply)});
+    }
+
+} // namespace engine
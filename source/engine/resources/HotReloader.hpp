@@ -0,0 +1,59 @@
+#ifndef PROTOTYPE_ACTION_RPG_HOTRELOADER_HPP
+#define PROTOTYPE_ACTION_RPG_HOTRELOADER_HPP
+
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+#include "FileWatcher.hpp"
+#include "ResourceManager.hpp"
+#include "../renderer/Device.hpp"
+
+
+namespace engine {
+
+    // Watches the files the resource manager loaded from. Changed files are decoded on the thread pool, the GPU resources
+    // are swapped between two frames so the scene keeps every id, handle and descriptor set it already has
+    class HotReloader {
+    public:
+        explicit HotReloader(std::shared_ptr<engine::Device> device);
+
+        ~HotReloader();
+
+        void start();
+
+        void stop();
+
+        // Called between two frames, the device is idle while the decoded assets are applied
+        void update();
+
+    private:
+        struct Decoded {
+            std::string path;
+            uint32_t generation;
+            std::function<void()> apply;
+        };
+
+    private:
+        void watchSources();
+
+        void decode(const std::string& path, const ResourceManager::AssetSource& source, uint32_t generation);
+
+    private:
+        std::shared_ptr<engine::Device> m_device;
+        FileWatcher m_watcher;
+        size_t m_watchedSources{};
+        // A file written again while it is decoded only applies its last version
+        std::unordered_map<std::string, uint32_t> m_generations;
+        std::mutex m_decodedMutex;
+        std::vector<Decoded> m_decoded;
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_HOTRELOADER_HPP
@@ -0,0 +1,48 @@
+#ifndef PROTOTYPE_ACTION_RPG_MAPPEDFILE_HPP
+#define PROTOTYPE_ACTION_RPG_MAPPEDFILE_HPP
+
+
+#include <string>
+#include <cstdint>
+
+
+namespace engine {
+
+    // Read only view of a whole file mapped in memory, pages are loaded by the OS on first access
+    class MappedFile {
+    public:
+        MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        ~MappedFile();
+
+        bool open(const std::string& path);
+
+        void close();
+
+        [[nodiscard]] bool isOpen() const;
+
+        [[nodiscard]] const uint8_t* getData() const;
+
+        [[nodiscard]] size_t getSize() const;
+
+    private:
+        const uint8_t* m_data{};
+        size_t m_size{};
+#ifdef _WIN32
+        void* m_file{};
+        void* m_mapping{};
+#endif
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_MAPPEDFILE_HPP
@@ -4,6 +4,7 @@
 #include "glm/gtc/type_ptr.hpp"
 #include "fmt/format.h"
 
+#include "GltfReader.hpp"
 #include "../Utilities.hpp"
 #include "../Application.hpp"
 
@@ -15,11 +16,15 @@ namespace engine {
     }
 
     glm::mat4 Model::Node::getMatrix(const std::shared_ptr<Model>& model) const {
+        return getMatrix(model->getNodes());
+    }
+
+    glm::mat4 Model::Node::getMatrix(const std::vector<Node>& nodes) const {
         glm::mat4 nodeMatrix = getLocalMatrix();
         int32_t parenID = parent;
 
         while (parenID > -1) {
-            Model::Node& currentParent = model->getNode(parenID);
+            const Model::Node& currentParent = nodes[parenID];
             nodeMatrix = currentParent.getLocalMatrix() * nodeMatrix;
             parenID = currentParent.parent;
         }
@@ -52,7 +57,9 @@ namespace engine {
         return m_nodes;
     }
 
-    void Model::loadNode(const tinygltf::Node &inputNode, const tinygltf::Model &inputModel, uint32_t nodeID, int32_t parentID) {
+    void Model::loadNode(const tinygltf::Node &inputNode, const GltfFile& inputFile, uint32_t nodeID, int32_t parentID) {
+        const tinygltf::Model& inputModel = inputFile.getModel();
+
         Node node{};
         node.id = nodeID;
         node.name = inputNode.name;
@@ -78,11 +85,9 @@ namespace engine {
 
         if (inputNode.mesh > -1) {
             const tinygltf::Mesh& mesh = inputModel.meshes[inputNode.mesh];
-            const tinygltf::Material material = inputModel.materials[mesh.primitives[0].material];
-            const tinygltf::Texture texture = inputModel.textures[material.pbrMetallicRoughness.baseColorTexture.index];
-            const tinygltf::Image image = inputModel.images[texture.source];
-            uint64_t textureID = engine::tools::hashString(image.name);
-            node.mesh = engine::Application::m_resourceManager->loadMesh(node.name, mesh, inputModel, textureID);
+            int image = gltf::getBaseColorImage(inputModel, mesh);
+            uint64_t textureID = image > -1 ? engine::tools::hashString(inputModel.images[image].name) : 0;
+            node.mesh = engine::Application::m_resourceManager->loadMesh(node.name, mesh, inputFile, textureID);
         }
 
         if (inputNode.skin > -1) node.skin = inputNode.skin;
@@ -91,6 +96,7 @@ namespace engine {
             auto& parent = m_nodes[parentID];
             parent.children.push_back(node.id);
             node.parent = static_cast<int32_t>(parent.id);
+            node.depth = parent.depth + 1;
         } else {
             m_rootNode = node.id;
         }
@@ -99,7 +105,7 @@ namespace engine {
 
         if (!inputNode.children.empty()) {
             for (size_t i : inputNode.children) {
-                loadNode(inputModel.nodes[i], inputModel, static_cast<uint32_t>(i), static_cast<int32_t>(node.id));
+                loadNode(inputModel.nodes[i], inputFile, static_cast<uint32_t>(i), static_cast<int32_t>(node.id));
             }
         }
     }
@@ -112,7 +118,9 @@ namespace engine {
         return m_rootNode;
     }
 
-    void Model::loadSkins(const tinygltf::Model& inputModel, const std::shared_ptr<Device>& device, const vk::Queue& transfer) {
+    void Model::loadSkins(const GltfFile& inputFile, const std::shared_ptr<Device>& device, const vk::Queue& transfer) {
+        const tinygltf::Model& inputModel = inputFile.getModel();
+
         for (auto& node : m_nodes) {
             if (node.skin > -1) {
                 tinygltf::Skin gltfSkin = inputModel.skins[node.skin];
@@ -122,16 +130,52 @@ namespace engine {
                 skin.name = gltfSkin.name;
                 skin.rootNodeID = gltfSkin.skeleton;
 
-                for (int joint : gltfSkin.joints) skin.joints.push_back(joint);
+                gltf::readSkin(inputFile, gltfSkin, skin.joints, skin.inverseBindMatrices);
+            }
+        }
+    }
 
-                if (gltfSkin.inverseBindMatrices > -1) {
-                    const tinygltf::Accessor &accessor = inputModel.accessors[gltfSkin.inverseBindMatrices];
-                    const tinygltf::BufferView &bufferView = inputModel.bufferViews[accessor.bufferView];
-                    const tinygltf::Buffer &buffer = inputModel.buffers[bufferView.buffer];
-                    skin.inverseBindMatrices.resize(accessor.count);
+    void Model::loadCooked(const CookedModel& cooked) {
+        const CookedModel::Header& header = cooked.getHeader();
+        m_nodes.resize(header.nodeCount);
+        m_rootNode = header.rootNode;
 
-                    std::memcpy(skin.inverseBindMatrices.data(), &buffer.data[accessor.byteOffset + bufferView.byteOffset], accessor.count * sizeof(glm::mat4));
-                }
+        std::vector<uint64_t> meshes(header.meshCount);
+        for (uint32_t i = 0; i < header.meshCount; ++i) {
+            meshes[i] = engine::Application::m_resourceManager->loadCookedMesh(cooked, cooked.getMeshes()[i]);
+        }
+
+        for (uint32_t i = 0; i < header.nodeCount; ++i) {
+            const CookedModel::NodeRecord& record = cooked.getNodes()[i];
+            Node& node = m_nodes[i];
+
+            node.id = i;
+            node.name = cooked.getString(record.name);
+            node.position = glm::make_vec3(record.translation);
+            node.rotation = glm::make_quat(record.rotation);
+            node.scale = glm::make_vec3(record.scale);
+            node.matrix = glm::make_mat4x4(record.matrix);
+            node.children.assign(cooked.getChildren() + record.firstChild, cooked.getChildren() + record.firstChild + record.childCount);
+            node.mesh = record.mesh > -1 ? meshes[record.mesh] : 0;
+            node.parent = record.parent;
+            node.skin = record.skin;
+            node.depth = record.depth;
+        }
+
+        // Skins are referenced by node, in node order, like loadSkins does
+        for (auto& node : m_nodes) {
+            if (node.skin > -1) {
+                const CookedModel::SkinRecord& record = cooked.getSkins()[node.skin];
+
+                m_skins.push_back({});
+                Skin& skin = m_skins.back();
+                skin.name = cooked.getString(record.name);
+                skin.rootNodeID = record.rootNode;
+                skin.joints.assign(cooked.getJoints() + record.firstJoint, cooked.getJoints() + record.firstJoint + record.jointCount);
+                skin.inverseBindMatrices.resize(record.jointCount);
+
+                std::memcpy(skin.inverseBindMatrices.data(), cooked.getInverseBindMatrices() + 16 * record.firstJoint,
+                            record.jointCount * sizeof(glm::mat4));
             }
         }
     }
@@ -143,4 +187,34 @@ namespace engine {
     uint32_t Model::getSkinsCount() const {
         return static_cast<uint32_t>(m_skins.size());
     }
+
+    size_t Model::getMemorySize() const {
+        size_t size = m_nodes.size() * sizeof(Node);
+
+        for (auto& node : m_nodes) size += node.children.size() * sizeof(uint32_t) + node.name.size();
+
+        for (auto& skin : m_skins) size += skin.inverseBindMatrices.size() * sizeof(glm::mat4) + skin.joints.size() * sizeof(uint32_t);
+
+        return size;
+    }
+
+    void Model::buildPalette(const std::vector<Node>& nodes, std::vector<glm::mat4>& palette) const {
+        palette.clear();
+
+        for (auto& node : nodes) {
+            if (node.mesh > 0) {
+                glm::mat4 matrix = node.getMatrix(nodes);
+                palette.push_back(matrix);
+
+                if (node.skin > -1) {
+                    glm::mat4 inverseTransform = glm::inverse(matrix);
+                    const Skin& skin = m_skins[node.skin];
+
+                    for (size_t i = 0; i < skin.joints.size(); ++i) {
+                        palette.push_back(inverseTransform * nodes[skin.joints[i]].getMatrix(nodes) * skin.inverseBindMatrices[i]);
+                    }
+                }
+            }
+        }
+    }
 } // namespace core
@@ -8,9 +8,9 @@
 #include "vulkan/vulkan.h"
 #include "glm/glm.hpp"
 #include "glm/gtx/quaternion.hpp"
-#define TINYGLTF_NO_STB_IMAGE_WRITE
-#include "tiny_gltf.h"
 
+#include "GltfFile.hpp"
+#include "CookedModel.hpp"
 #include "../Constants.hpp"
 #include "../mesh/Mesh.hpp"
 #include "../renderer/Device.hpp"
@@ -31,10 +31,13 @@ namespace engine {
             uint64_t mesh{};
             int32_t parent{-1};
             int32_t skin{-1};
+            uint32_t depth{};
 
             glm::mat4 getLocalMatrix() const;
 
             glm::mat4 getMatrix(const std::shared_ptr<Model>& model) const;
+
+            glm::mat4 getMatrix(const std::vector<Node>& nodes) const;
         };
 
         struct Skin {
@@ -59,18 +62,27 @@ namespace engine {
 
         std::vector<Node>& getNodes();
 
-        void loadNode(const tinygltf::Node& inputNode, const tinygltf::Model& inputModel, uint32_t nodeID, int32_t parentID = -1);
+        void loadNode(const tinygltf::Node& inputNode, const GltfFile& inputFile, uint32_t nodeID, int32_t parentID = -1);
 
         std::string& getName();
 
         uint32_t getRootNode() const;
 
-        void loadSkins(const tinygltf::Model& inputModel, const std::shared_ptr<Device>& device, const vk::Queue& transfer);
+        void loadSkins(const GltfFile& inputFile, const std::shared_ptr<Device>& device, const vk::Queue& transfer);
+
+        // Nodes, skins and meshes straight from the flat arrays of a cooked model
+        void loadCooked(const CookedModel& cooked);
 
         Skin& getSkin(size_t i);
 
         uint32_t getSkinsCount() const;
 
+        // CPU memory of the nodes and skins, the meshes are owned by the ResourceManager
+        [[nodiscard]] size_t getMemorySize() const;
+
+        // One block per mesh node, in node order: the node matrix followed by its joint matrices
+        void buildPalette(const std::vector<Node>& nodes, std::vector<glm::mat4>& palette) const;
+
     private:
         std::vector<Node> m_nodes;
         std::string m_name{};
@@ -0,0 +1,171 @@
+#include "PoseCache.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <numeric>
+
+#include "spdlog/spdlog.h"
+
+#include "Animation.hpp"
+#include "AnimationSampler.hpp"
+
+
+const uint32_t POSE_CACHE_MAGIC = 0x45534F50; // "POSE"
+const uint32_t POSE_CACHE_VERSION = 3;
+
+inline uint32_t frameCount(const engine::Animation& animation, float rate) {
+    return static_cast<uint32_t>(std::ceil((animation.m_end - animation.m_start) * rate)) + 1;
+}
+
+namespace engine {
+
+    PoseCache::PoseCache() = default;
+
+    bool PoseCache::bake(const Animation& animation, const Settings& settings) {
+        m_frames.clear();
+        m_frameCount = 0;
+
+        uint32_t frames = frameCount(animation, settings.rate);
+        auto channelCount = static_cast<uint32_t>(animation.m_channels.size());
+        size_t size = static_cast<size_t>(frames) * channelCount * sizeof(glm::vec4);
+
+        if (size > settings.memoryBudget) {
+            spdlog::warn("[Animation] {}: {} frames at {} Hz need {} KB, over the {} KB budget", animation.m_name, frames,
+                         settings.rate, size / 1024, settings.memoryBudget / 1024);
+
+            return false;
+        }
+
+        std::vector<uint32_t> channels(channelCount);
+        std::iota(channels.begin(), channels.end(), 0);
+
+        // Skipped channels keep a zero value, they are never applied
+        std::erase_if(channels, [&animation](uint32_t channel) { return animation.m_channels[channel].nodeID < 0; });
+
+        AnimationSampler sampler;
+        std::vector<glm::vec4> values;
+        m_frames.assign(static_cast<size_t>(frames) * channelCount, glm::vec4(0.0f));
+
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            float time = std::min(animation.m_start + static_cast<float>(frame) / settings.rate, animation.m_end);
+            sampler.sample(animation, time, channels, values);
+
+            for (uint32_t i = 0; i < channels.size(); ++i) m_frames[frame * channelCount + channels[i]] = values[i];
+        }
+
+        m_keysHash = animation.m_keysHash;
+        m_rate = settings.rate;
+        m_start = animation.m_start;
+        m_end = animation.m_end;
+        m_frameCount = frames;
+        m_channelCount = channelCount;
+
+        spdlog::info("[Animation] {}: baked {} frames at {} Hz, {:.1f} KB", animation.m_name, frames, m_rate,
+                     static_cast<float>(getMemorySize()) / 1024.0f);
+
+        return true;
+    }
+
+    bool PoseCache::save(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+
+        if (!file.is_open()) return false;
+
+        file.write(reinterpret_cast<const char*>(&POSE_CACHE_MAGIC), sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(&POSE_CACHE_VERSION), sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(&m_keysHash), sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&m_rate), sizeof(float));
+        file.write(reinterpret_cast<const char*>(&m_start), sizeof(float));
+        file.write(reinterpret_cast<const char*>(&m_end), sizeof(float));
+        file.write(reinterpret_cast<const char*>(&m_frameCount), sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(&m_channelCount), sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(m_frames.data()), static_cast<std::streamsize>(m_frames.size() * sizeof(glm::vec4)));
+
+        return file.good();
+    }
+
+    bool PoseCache::load(const std::string& path, const Animation& animation, const Settings& settings) {
+        std::ifstream file(path, std::ios::binary);
+
+        if (!file.is_open()) return false;
+
+        uint32_t magic{}, version{}, frames{}, channelCount{};
+        uint64_t keysHash{};
+        float rate{}, start{}, end{};
+
+        file.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(&keysHash), sizeof(uint64_t));
+        file.read(reinterpret_cast<char*>(&rate), sizeof(float));
+        file.read(reinterpret_cast<char*>(&start), sizeof(float));
+        file.read(reinterpret_cast<char*>(&end), sizeof(float));
+        file.read(reinterpret_cast<char*>(&frames), sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(&channelCount), sizeof(uint32_t));
+
+        // A cache baked with other settings or from other keys of the clip is baked again
+        if (!file.good() || magic != POSE_CACHE_MAGIC || version != POSE_CACHE_VERSION || keysHash != animation.m_keysHash || rate != settings.rate
+                || start != animation.m_start || end != animation.m_end || frames != frameCount(animation, rate) || channelCount != animation.m_channels.size()
+                || static_cast<size_t>(frames) * channelCount * sizeof(glm::vec4) > settings.memoryBudget) {
+            return false;
+        }
+
+        m_frames.resize(static_cast<size_t>(frames) * channelCount);
+        file.read(reinterpret_cast<char*>(m_frames.data()), static_cast<std::streamsize>(m_frames.size() * sizeof(glm::vec4)));
+
+        if (!file.good()) {
+            m_frames.clear();
+
+            return false;
+        }
+
+        m_keysHash = keysHash;
+        m_rate = rate;
+        m_start = start;
+        m_end = end;
+        m_frameCount = frames;
+        m_channelCount = channelCount;
+
+        return true;
+    }
+
+    bool PoseCache::isBaked() const {
+        return m_frameCount > 0;
+    }
+
+    void PoseCache::sample(const Animation& animation, float time, const std::vector<uint32_t>& channels,
+                           std::vector<glm::vec4>& values) const {
+        values.resize(channels.size());
+
+        time = glm::clamp(time, m_start, m_end);
+        auto frame = std::min(static_cast<uint32_t>((time - m_start) * m_rate), m_frameCount - 1);
+        uint32_t next = std::min(frame + 1, m_frameCount - 1);
+
+        // Times of the two frames as they were baked, the last one is clamped to the end of the clip
+        float frameTime = std::min(m_start + static_cast<float>(frame) / m_rate, m_end);
+        float nextTime = std::min(m_start + static_cast<float>(next) / m_rate, m_end);
+        float alpha = nextTime > frameTime ? glm::clamp((time - frameTime) / (nextTime - frameTime), 0.0f, 1.0f) : 0.0f;
+
+        const glm::vec4* current = &m_frames[static_cast<size_t>(frame) * m_channelCount];
+        const glm::vec4* following = &m_frames[static_cast<size_t>(next) * m_channelCount];
+
+        for (uint32_t i = 0; i < channels.size(); ++i) {
+            const glm::vec4& a = current[channels[i]];
+            const glm::vec4& b = following[channels[i]];
+
+            const Animation::Channel& channel = animation.m_channels[channels[i]];
+
+            if (animation.m_samplers[channel.samplerIndex].interpolation == Animation::Sampler::InterpolationType::STEP) {
+                values[i] = a;
+            } else if (channel.path == Animation::Channel::PathType::ROTATION) {
+                values[i] = glm::normalize(glm::mix(a, glm::dot(a, b) < 0.0f ? -b : b, alpha));
+            } else {
+                values[i] = glm::mix(a, b, alpha);
+            }
+        }
+    }
+
+    size_t PoseCache::getMemorySize() const {
+        return m_frames.size() * sizeof(glm::vec4);
+    }
+
+} // namespace engine
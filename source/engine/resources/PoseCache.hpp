@@ -0,0 +1,60 @@
+#ifndef PROTOTYPE_ACTION_RPG_POSECACHE_HPP
+#define PROTOTYPE_ACTION_RPG_POSECACHE_HPP
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+
+namespace engine {
+
+    class Animation;
+
+    // Local pose of every channel of a clip sampled at a fixed rate, playback lerps between the two closest frames
+    class PoseCache {
+    public:
+        struct Settings {
+            float rate{30.0f};
+            size_t memoryBudget{512 * 1024};
+            // Keep the baked frames next to the clip and reuse them on the next run
+            bool onDisk{false};
+        };
+
+    public:
+        PoseCache();
+
+        // Returns false when the frames do not fit in the memory budget, the clip is then evaluated at runtime
+        bool bake(const Animation& animation, const Settings& settings);
+
+        bool save(const std::string& path) const;
+
+        // Fails for frames baked from other keys or at another rate, the caller bakes them again
+        bool load(const std::string& path, const Animation& animation, const Settings& settings);
+
+        [[nodiscard]] bool isBaked() const;
+
+        // Same contract as AnimationSampler::sample, values[i] receives the value of channels[i]
+        void sample(const Animation& animation, float time, const std::vector<uint32_t>& channels, std::vector<glm::vec4>& values) const;
+
+        [[nodiscard]] size_t getMemorySize() const;
+
+    private:
+        uint64_t m_keysHash{};
+        float m_rate{};
+        float m_start{};
+        // The last frame is baked at the end of the clip, closer to the previous one than 1 / rate when the duration is
+        // not a multiple of it
+        float m_end{};
+        uint32_t m_frameCount{};
+        uint32_t m_channelCount{};
+        // Frame major, one value per channel
+        std::vector<glm::vec4> m_frames;
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_POSECACHE_HPP
@@ -0,0 +1,50 @@
+#include "ResourceHandle.hpp"
+
+#include <utility>
+
+#include "../Application.hpp"
+
+
+namespace engine {
+
+    ResourceHandle::ResourceHandle() = default;
+
+    ResourceHandle::ResourceHandle(ResourceType type, uint64_t id) : m_type(type), m_id(id) {
+        if (m_id != 0) Application::m_resourceManager->acquire(m_type, m_id);
+    }
+
+    ResourceHandle::ResourceHandle(const ResourceHandle& other) : ResourceHandle(other.m_type, other.m_id) {
+
+    }
+
+    ResourceHandle::ResourceHandle(ResourceHandle&& other) noexcept : m_type(other.m_type), m_id(std::exchange(other.m_id, 0)) {
+
+    }
+
+    ResourceHandle& ResourceHandle::operator=(ResourceHandle other) noexcept {
+        std::swap(m_type, other.m_type);
+        std::swap(m_id, other.m_id);
+
+        return *this;
+    }
+
+    ResourceHandle::~ResourceHandle() {
+        reset();
+    }
+
+    void ResourceHandle::reset() {
+        // Components can outlive the resource manager at shutdown, every resource is destroyed by then
+        if (m_id != 0 && Application::m_resourceManager) Application::m_resourceManager->release(m_type, m_id);
+
+        m_id = 0;
+    }
+
+    ResourceType ResourceHandle::getType() const {
+        return m_type;
+    }
+
+    uint64_t ResourceHandle::getID() const {
+        return m_id;
+    }
+
+} // namespace engine
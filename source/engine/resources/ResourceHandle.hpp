@@ -0,0 +1,48 @@
+#ifndef PROTOTYPE_ACTION_RPG_RESOURCEHANDLE_HPP
+#define PROTOTYPE_ACTION_RPG_RESOURCEHANDLE_HPP
+
+
+#include <cstdint>
+
+
+namespace engine {
+
+    enum class ResourceType : uint32_t {
+        TEXTURE,
+        MESH,
+        MODEL,
+        ANIMATION,
+        COUNT
+    };
+
+    // Holds a reference on a resource of the ResourceManager, resources without references can be evicted when the
+    // memory budget is exceeded. Copies add a reference, an empty handle has the id 0
+    class ResourceHandle {
+    public:
+        ResourceHandle();
+
+        ResourceHandle(ResourceType type, uint64_t id);
+
+        ResourceHandle(const ResourceHandle& other);
+
+        ResourceHandle(ResourceHandle&& other) noexcept;
+
+        ResourceHandle& operator=(ResourceHandle other) noexcept;
+
+        ~ResourceHandle();
+
+        void reset();
+
+        [[nodiscard]] ResourceType getType() const;
+
+        [[nodiscard]] uint64_t getID() const;
+
+    private:
+        ResourceType m_type{ResourceType::TEXTURE};
+        uint64_t m_id{};
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_RESOURCEHANDLE_HPP
@@ -1,6 +1,10 @@
 #include "ResourceManager.hpp"
 
+#include <tuple>
+#include <chrono>
 #include <utility>
+#include <algorithm>
+#include <filesystem>
 
 #define TINYGLTF_IMPLEMENTATION
 #define TINYGLTF_NO_STB_IMAGE_WRITE
@@ -10,18 +14,40 @@
 #include "nlohmann/json.hpp"
 
 #include "Shader.hpp"
+#include "GltfReader.hpp"
+#include "../mesh/MeshOptimizer.hpp"
+#include "AnimationSampler.hpp"
 #include "../Application.hpp"
 #include "../physcis/PhysicsEngine.hpp"
 
 using json = nlohmann::json;
 
 
+// A binary glTF is preferred over a text one, its buffers are mapped instead of decoded and copied
+inline std::string getGltfPath(const std::string& uri) {
+    std::string path = MODELS_DIR + uri + ".glb";
+
+    return std::filesystem::exists(path) ? path : MODELS_DIR + uri + ".gltf";
+}
+
+// A cooked model older than its glTF source or buffers is ignored, the source is loaded until it is cooked again
+inline bool isCookedModelCurrent(const std::string& uri) {
+    return engine::CookedModel::isUpToDate(MODELS_DIR + uri + COOKED_MODEL_EXTENSION, getGltfPath(uri));
+}
+
 namespace engine {
 
     ResourceManager::ResourceManager(std::shared_ptr<engine::Device> device, vk::Queue graphicsQueue)
             : m_device(std::move(device)), m_graphicsQueue(graphicsQueue) {
         createDescriptorSetLayout();
         createDescriptorPool();
+
+        m_uploads.create(m_device, m_graphicsQueue, m_device->m_queueFamilyIndices.graphics, UPLOAD_STAGING_SIZE);
+        m_geometry.create(m_device);
+        m_paletteRing.create(m_device, vk::BufferUsageFlagBits::eStorageBuffer, PALETTE_RING_SEGMENT_SIZE,
+                             MAX_FRAMES_IN_FLIGHT, sizeof(glm::mat4));
+
+        createDefaultTexture();
     }
 
     ResourceManager::~ResourceManager() = default;
@@ -33,63 +59,107 @@ namespace engine {
 
         for (auto& texture : m_textures) texture.second.cleanup(m_device->m_logicalDevice);
 
+        for (auto& mesh : m_destroyedMeshes) mesh.second.cleanup();
+
         for (auto& shader : m_shaders) shader->cleanup(m_device->m_logicalDevice);
 
-        m_device->m_logicalDevice.destroy(m_meshDescriptorSetLayout);
-        m_device->m_logicalDevice.destroy(m_meshSDescriptorPool);
-        m_device->m_logicalDevice.destroy(m_imagesDescriptorSetLayout);
+        m_geometry.cleanup();
+        m_paletteRing.cleanup();
+        m_uploads.cleanup();
+
+        m_device->m_logicalDevice.destroy(m_paletteDescriptorPool);
     }
 
     void ResourceManager::createTexture(const std::string &fileName, const std::string& name) {
-        if (m_textures.find(engine::tools::hashString(name)) != m_textures.end()) {
+        uint64_t textureID = engine::tools::internString(name);
+
+        if (m_textures.find(textureID) != m_textures.end()) {
             return ;
         }
 
         int width, height;
         vk::DeviceSize imageSize;
         stbi_uc* pixels = engine::tools::loadTextureFile(fileName, &width, &height, &imageSize);
-        engine::Buffer stagingBuffer;
 
-        stagingBuffer = m_device->createBuffer(vk::BufferUsageFlagBits::eTransferSrc,
-                               vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                               imageSize);
+        addTexture(textureID, pixels, width, height, imageSize);
+        addSource(TEXTURES_DIR + fileName, AssetType::TEXTURE, fileName, name);
+    }
+
+    void ResourceManager::createTexture(const uint8_t* data, size_t length, const std::string& name) {
+        uint64_t textureID = engine::tools::internString(name);
 
-        stagingBuffer.map(imageSize);
-        stagingBuffer.copyTo(pixels, imageSize);
-        stagingBuffer.unmap();
+        if (m_textures.find(textureID) != m_textures.end()) return;
+
+        int width, height;
+        vk::DeviceSize imageSize;
+        stbi_uc* pixels = engine::tools::loadTextureMemory(data, length, &width, &height, &imageSize);
+
+        addTexture(textureID, pixels, width, height, imageSize);
+    }
+
+    void ResourceManager::addTexture(uint64_t textureID, stbi_uc* pixels, int width, int height, vk::DeviceSize size) {
+        engine::Texture texture = uploadTexture(pixels, width, height, size);
 
         stbi_image_free(pixels);
 
-        vk::Extent2D size = {static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
-        auto mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height))));
+        createTextureDescriptor(texture);
 
-        engine::Texture texture(m_device->m_logicalDevice, size, vk::Format::eR8G8B8A8Unorm, vk::ImageTiling::eOptimal,
-                              vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
-                                mipLevels);
+        m_textures[textureID] = texture;
+        trackResidency(ResourceType::TEXTURE, textureID, 0, texture.getMemorySize());
+    }
+
+    void ResourceManager::createDefaultTexture() {
+        // 2x2 so the texture has a mip level
+        const uint8_t white[2 * 2 * 4] = {255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255};
+
+        m_defaultTexture = engine::tools::internString(DEFAULT_TEXTURE);
+
+        engine::Texture texture = uploadTexture(white, 2, 2, sizeof(white));
+        createTextureDescriptor(texture);
+        m_textures[m_defaultTexture] = texture;
+    }
 
-        vk::MemoryRequirements memoryRequirements = m_device->m_logicalDevice.getImageMemoryRequirements(texture.getTextureImage().getImage());
+    void ResourceManager::createTextureDescriptor(engine::Texture& texture) {
+        if (!m_device->m_bindless) {
+            texture.createDescriptor(m_device->m_logicalDevice, m_imagesDescriptorPool, m_imagesDescriptorSetLayout);
+            return;
+        }
 
-        auto memType = m_device->getMemoryType(memoryRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        uint32_t index;
 
-        texture.bind(m_device->m_logicalDevice, memType, memoryRequirements.size);
+        if (!m_freeTextureIndices.empty()) {
+            index = m_freeTextureIndices.back();
+            m_freeTextureIndices.pop_back();
+        } else if (m_textureCount < BINDLESS_TEXTURES) {
+            index = m_textureCount++;
+        } else {
+            throw std::runtime_error("The bindless texture array is full");
+        }
 
-        m_device->transitionImageLayout(texture.getTextureImage().getImage(), vk::Format::eR8G8B8Srgb, m_graphicsQueue,
-                                        vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, mipLevels);
+        texture.setDescriptorSet(m_device->m_logicalDevice, m_texturesDescriptorSet, index);
+    }
 
-        m_device->copyBufferToImage(stagingBuffer.m_buffer, texture.getTextureImage().getImage(), m_graphicsQueue,
-                                    size);
+    engine::Texture ResourceManager::uploadTexture(const void* pixels, int width, int height, vk::DeviceSize imageSize) {
+        vk::Extent2D size = {static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+        auto mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height))));
 
-        generateMipmaps(texture, vk::Format::eR8G8B8A8Srgb, size, mipLevels);
+        engine::Texture texture(m_device->m_logicalDevice, size, vk::Format::eR8G8B8A8Unorm, vk::ImageTiling::eOptimal,
+                              vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+                                mipLevels);
 
-        stagingBuffer.destroy();
+        texture.bind(*m_device->m_allocator, m_device->m_logicalDevice);
 
-        texture.createDescriptor(m_device->m_logicalDevice, m_imagesDescriptorPool, m_imagesDescriptorSetLayout);
+        m_uploads.begin();
+        m_uploads.uploadImage(pixels, imageSize, texture.getTextureImage().getImage(), vk::Format::eR8G8B8A8Unorm, size, mipLevels);
+        m_uploads.submit();
 
-        m_textures[engine::tools::hashString(name)] = texture;
+        return texture;
     }
 
     engine::Texture &ResourceManager::getTexture(uint64_t id) {
-        return m_textures[id];
+        auto it = m_textures.find(id);
+
+        return it != m_textures.end() ? it->second : m_textures.at(m_defaultTexture);
     }
 
     vk::DescriptorSetLayout &ResourceManager::getTextureDescriptorSetLayout() {
@@ -100,101 +170,51 @@ namespace engine {
        createDescriptorPool();
 
        for (auto& texture : m_textures) {
-           texture.second.createDescriptor(m_device->m_logicalDevice, m_imagesDescriptorPool, m_imagesDescriptorSetLayout);
+           if (m_device->m_bindless) {
+               texture.second.setDescriptorSet(m_device->m_logicalDevice, m_texturesDescriptorSet, texture.second.getIndex());
+           } else {
+               texture.second.createDescriptor(m_device->m_logicalDevice, m_imagesDescriptorPool, m_imagesDescriptorSetLayout);
+           }
        }
     }
 
     void ResourceManager::cleanupResources() {
+        // The device is idle, the sets of the evicted textures are freed before their pool
+        destroyEvicted(true);
+
         m_device->m_logicalDevice.destroy(m_imagesDescriptorPool);
     }
 
-    void ResourceManager::generateMipmaps(const engine::Texture& texture, vk::Format format, vk::Extent2D size, uint32_t mipLevels) {
-        vk::Image textureImage = texture.getTextureImage().getImage();
-        // Check if image format supports linear blitting
-        vk::FormatProperties formatProperties = m_device->m_physicalDevice.getFormatProperties(format);
-
-        if (!(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
-            engine::throw_ex("texture image format does not support linear blitting");
-        }
-
-        vk::CommandBuffer commandBuffer = m_device->createCommandBuffer(vk::CommandBufferLevel::ePrimary, true);
-
-        vk::ImageMemoryBarrier barrier{
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .image = textureImage,
-            .subresourceRange = {
-                    .aspectMask = vk::ImageAspectFlagBits::eColor,
-                    .levelCount = 1,
-                    .baseArrayLayer = 0,
-                    .layerCount = 1,
-            }
-        };
-
-        auto mipWidth = static_cast<int32_t>(size.width);
-        auto mipHeight = static_cast<int32_t>(size.height);
-
-        for (uint32_t i = 1; i < mipLevels; ++i) {
-            barrier.subresourceRange.baseMipLevel = i - 1;
-            barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-            barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
-            barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-            barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
-
-            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {},
-                                          0, nullptr, 0, nullptr, 1, &barrier);
-
-            vk::ImageBlit blit{
-                .srcSubresource = {
-                        .aspectMask = vk::ImageAspectFlagBits::eColor,
-                        .mipLevel = i - 1,
-                        .baseArrayLayer = 0,
-                        .layerCount = 1
-                },
-                .srcOffsets = {std::array<vk::Offset3D, 2>({ { {0, 0, 0}, {mipHeight, mipWidth, 1} } })},
-                .dstSubresource = {
-                        .aspectMask = vk::ImageAspectFlagBits::eColor,
-                        .mipLevel = i,
-                        .baseArrayLayer = 0,
-                        .layerCount = 1
-                },
-                .dstOffsets = {std::array<vk::Offset3D, 2>({ { {0, 0, 0}, {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1} } })}
+    void ResourceManager::createDescriptorPool() {
+        if (m_device->m_bindless) {
+            vk::DescriptorPoolSize poolSize{
+                .type = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = BINDLESS_TEXTURES
             };
 
-            commandBuffer.blitImage(textureImage, vk::ImageLayout::eTransferSrcOptimal, textureImage, vk::ImageLayout::eTransferDstOptimal,
-                                    1, &blit, vk::Filter::eLinear);
-
-            barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
-            barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-            barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
-            barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+            m_imagesDescriptorPool = m_device->m_logicalDevice.createDescriptorPool({
+                .flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+                .maxSets = 1,
+                .poolSizeCount = 1,
+                .pPoolSizes = &poolSize
+            });
 
-            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
-                                          0, nullptr, 0, nullptr, 1, &barrier);
+            m_texturesDescriptorSet = m_device->m_logicalDevice.allocateDescriptorSets({
+                .descriptorPool = m_imagesDescriptorPool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &m_imagesDescriptorSetLayout
+            }).front();
 
-            if (mipWidth > 1) mipWidth /= 2;
-            if (mipHeight > 1) mipHeight /= 2;
+            return;
         }
 
-        barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
-                                      0, nullptr, 0, nullptr, 1, &barrier);
-
-        m_device->flushCommandBuffer(commandBuffer, m_graphicsQueue);
-    }
-
-    void ResourceManager::createDescriptorPool() {
         vk::DescriptorPoolSize samplerPoolSizer{
             .type = vk::DescriptorType::eCombinedImageSampler,
             .descriptorCount = MAX_OBJECTS
         };
 
         vk::DescriptorPoolCreateInfo samplerPoolCreateInfo{
+            .flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
             .maxSets = MAX_OBJECTS,
             .poolSizeCount = 1,
             .pPoolSizes = &samplerPoolSizer
@@ -207,38 +227,45 @@ namespace engine {
         vk::DescriptorSetLayoutBinding samplerLayoutBinding{
             .binding = 0,
             .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-            .descriptorCount = 1,
+            .descriptorCount = m_device->m_bindless ? BINDLESS_TEXTURES : 1,
             .stageFlags = vk::ShaderStageFlagBits::eFragment,
             .pImmutableSamplers = nullptr
         };
 
-        vk::DescriptorSetLayoutCreateInfo samplerLayoutInfo{
-            .bindingCount = 1,
-            .pBindings = &samplerLayoutBinding,
-        };
+        // Elements of the array are written while the frames in flight read the others
+        vk::DescriptorBindingFlags flags = m_device->m_bindless ? vk::DescriptorBindingFlagBits::ePartiallyBound
+                | vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending
+                : vk::DescriptorBindingFlags{};
 
-        m_imagesDescriptorSetLayout = m_device->m_logicalDevice.createDescriptorSetLayout(samplerLayoutInfo);
+        m_imagesDescriptorSetLayout = m_device->m_layoutCache->getSetLayout({samplerLayoutBinding}, flags);
     }
 
     uint64_t ResourceManager::createModel(const std::string &uri, const std::string& name) {
-        uint64_t modelName = engine::tools::hashString(name);
+        uint64_t modelName = engine::tools::internString(name);
 
         if (m_models.find(modelName) != m_models.end()) return modelName;
 
-        tinygltf::Model inputModel;
-        tinygltf::TinyGLTF loader;
-        std::string error, warning;
+        addSource(MODELS_DIR + uri + ".gltf", AssetType::MODEL, uri, name);
+        addSource(MODELS_DIR + uri + ".glb", AssetType::MODEL, uri, name);
+        addSource(MODELS_DIR + uri + COOKED_MODEL_EXTENSION, AssetType::MODEL, uri, name);
 
-        bool fileLoaded = loader.LoadASCIIFromFile(&inputModel, &error, &warning, MODELS_DIR + uri + ".gltf");
+        if (loadCookedModel(uri, name)) return modelName;
 
-        if (fileLoaded) {
-            m_models[modelName] = std::make_shared<engine::Model>(name, inputModel.nodes.size());
+        auto start = std::chrono::high_resolution_clock::now();
 
-            for (auto& image : inputModel.images) createTexture(image.uri, image.name);
+        GltfFile inputFile;
+        std::string path = getGltfPath(uri);
+        std::string error;
 
-            for (auto& nodeID : inputModel.scenes[0].nodes) m_models[modelName]->loadNode(inputModel.nodes[nodeID], inputModel, nodeID);
+        if (inputFile.load(path, &error)) {
+            m_models[modelName] = buildModel(inputFile, name);
+            trackResidency(ResourceType::MODEL, modelName, m_models[modelName]->getMemorySize(), 0);
 
-            m_models[modelName]->loadSkins(inputModel, m_device, m_graphicsQueue);
+            // The peak is for the whole process, load one model per run to compare the mapped and the text file
+            std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+            spdlog::info("[Model] {} loaded from {} ({}) in {:.2f} ms, peak memory {} MB", name, path,
+                         inputFile.isMapped() ? "mapped" : "copied", time.count(), engine::tools::getPeakMemory() / (1024 * 1024));
+            logVertexMemory(name);
 
             return modelName;
         } else {
@@ -248,16 +275,73 @@ namespace engine {
         }
     }
 
+    std::shared_ptr<engine::Model> ResourceManager::buildModel(const GltfFile& inputFile, const std::string& name) {
+        const tinygltf::Model& inputModel = inputFile.getModel();
+        auto model = std::make_shared<engine::Model>(name, inputModel.nodes.size());
+
+        // Textures and meshes of the model reach the GPU in a single submit
+        m_uploads.begin();
+
+        // Only the images sampled by a mesh are decoded, the others would never be bound
+        std::vector<bool> usedImages(inputModel.images.size());
+        for (auto& mesh : inputModel.meshes) {
+            int image = gltf::getBaseColorImage(inputModel, mesh);
+
+            if (image > -1) usedImages[image] = true;
+        }
+
+        for (size_t i = 0; i < inputModel.images.size(); ++i) {
+            const tinygltf::Image& image = inputModel.images[i];
+
+            if (!usedImages[i]) continue;
+
+            if (image.bufferView > -1) {
+                createTexture(inputFile.getBufferView(image.bufferView), inputModel.bufferViews[image.bufferView].byteLength, image.name);
+            } else {
+                createTexture(image.uri, image.name);
+            }
+        }
+
+        for (auto& nodeID : inputModel.scenes[0].nodes) model->loadNode(inputModel.nodes[nodeID], inputFile, nodeID);
+
+        model->loadSkins(inputFile, m_device, m_graphicsQueue);
+
+        m_uploads.submit();
+
+        acquireMeshes(*model);
+
+        return model;
+    }
+
     std::shared_ptr<engine::Model> ResourceManager::getModel(uint64_t id) {
-        return m_models[id];
+        auto it = m_models.find(id);
+
+        if (it != m_models.end()) return it->second;
+
+        // An evicted model is loaded again from the file it came from
+        const AssetSource* source = findModelSource(id);
+
+        if (!source) return nullptr;
+
+        AssetSource model = *source;
+
+        return createModel(model.uri, model.name) == id ? m_models[id] : nullptr;
+    }
+
+    const ResourceManager::AssetSource* ResourceManager::findModelSource(uint64_t modelID) const {
+        auto source = std::find_if(m_sources.begin(), m_sources.end(), [modelID](const auto& source) {
+            return source.second.type == AssetType::MODEL && engine::tools::hashString(source.second.name) == modelID;
+        });
+
+        return source != m_sources.end() ? &source->second : nullptr;
     }
 
     engine::Mesh &ResourceManager::getMesh(uint64_t id) {
         return m_meshes[id];
     }
 
-    uint64_t ResourceManager::loadMesh(const std::string& name, const tinygltf::Mesh &mesh, const tinygltf::Model &model, uint64_t texturesID) {
-        uint64_t meshID = engine::tools::hashString(name);
+    uint64_t ResourceManager::loadMesh(const std::string& name, const tinygltf::Mesh &mesh, const GltfFile& file, uint64_t texturesID) {
+        uint64_t meshID = engine::tools::internString(name);
 
         if (m_meshes.find(meshID) != m_meshes.end()) {
             return meshID;
@@ -266,352 +350,934 @@ namespace engine {
         std::vector<engine::Vertex> vertices;
         std::vector<uint32_t> indices;
 
-        for (auto primitive : mesh.primitives) {
-            uint32_t indexCount = 0;
-            uint32_t vertexCount = 0;
+        VertexLayout layout = gltf::readMesh(file, mesh, vertices, indices) ? VertexLayout::SKINNED : VertexLayout::STATIC;
+
+        MeshOptimizer::Stats stats = MeshOptimizer::optimize(vertices, indices);
+        spdlog::info("[Mesh] {}: {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {} bits indices", name,
+                     stats.verticesBefore, stats.verticesAfter, stats.acmrBefore, stats.acmrAfter, stats.atvrBefore,
+                     stats.atvrAfter, 8 * MeshOptimizer::getIndexSize(stats.verticesAfter));
+
+        if (texturesID == 0) texturesID = m_defaultTexture;
+
+        m_meshes[meshID] = engine::Mesh(vertices, indices, layout, m_uploads, texturesID, m_geometry);
+        trackVertexMemory(m_meshes[meshID]);
+        trackResidency(ResourceType::MESH, meshID, 0, m_meshes[meshID].getVertexBufferSize() + m_meshes[meshID].getIndexBufferSize());
+
+        if (texturesID != m_defaultTexture) acquire(ResourceType::TEXTURE, texturesID);
+
+        return meshID;
+    }
+
+    uint64_t ResourceManager::loadCookedMesh(const CookedModel& model, const CookedModel::MeshRecord& mesh) {
+        uint64_t meshID = engine::tools::internString(model.getString(mesh.name));
+
+        if (m_meshes.find(meshID) != m_meshes.end()) return meshID;
+
+        // Untextured meshes and textures that could not be cooked use the default texture
+        uint64_t textureID = m_defaultTexture;
+        if (mesh.texture != CookedModel::NO_TEXTURE) {
+            const CookedModel::TextureRecord& texture = model.getTextures()[mesh.texture];
+
+            if (texture.imageSize > 0 || texture.uri.length > 0) textureID = engine::tools::hashString(std::string(model.getString(texture.name)));
+        }
+
+        m_meshes[meshID] = engine::Mesh(model.getVertices(mesh), static_cast<VertexLayout>(mesh.layout), mesh.vertexCount,
+                                        model.getIndices(mesh), mesh.indexSize, mesh.indexCount, m_uploads, textureID, m_geometry);
+        trackVertexMemory(m_meshes[meshID]);
+        trackResidency(ResourceType::MESH, meshID, 0, m_meshes[meshID].getVertexBufferSize() + m_meshes[meshID].getIndexBufferSize());
+
+        if (textureID != m_defaultTexture) acquire(ResourceType::TEXTURE, textureID);
+
+        return meshID;
+    }
+
+    bool ResourceManager::loadCookedModel(const std::string& uri, const std::string& name) {
+        std::string cookedPath = MODELS_DIR + uri + COOKED_MODEL_EXTENSION;
+        CookedModel cooked;
+
+        if (!std::filesystem::exists(cookedPath)) return false;
+
+        if (!isCookedModelCurrent(uri)) {
+            spdlog::warn("[Model] {} is older than its source, {} is loaded until the AssetCooker is run", cookedPath, getGltfPath(uri));
+            return false;
+        }
+
+        if (!cooked.open(cookedPath, sizeof(StaticVertex), sizeof(SkinnedVertex))) return false;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        uint64_t modelName = engine::tools::hashString(name);
+        m_models[modelName] = buildModel(cooked, name);
+        trackResidency(ResourceType::MODEL, modelName, m_models[modelName]->getMemorySize(), 0);
+
+        std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+        spdlog::info("[Model] {} loaded from cooked file ({} KB) in {:.2f} ms", name, cooked.getFileSize() / 1024, time.count());
+        logVertexMemory(name);
+
+        return true;
+    }
+
+    std::shared_ptr<engine::Model> ResourceManager::buildModel(const CookedModel& cooked, const std::string& name) {
+        auto model = std::make_shared<engine::Model>(name);
+
+        // The mapped file has to outlive the uploads, they are staged from it
+        m_uploads.begin();
+
+        // Only the textures sampled by a mesh are decoded, the others would never be bound
+        std::vector<bool> usedTextures(cooked.getHeader().textureCount);
+        for (uint32_t i = 0; i < cooked.getHeader().meshCount; ++i) {
+            uint32_t texture = cooked.getMeshes()[i].texture;
+
+            if (texture != CookedModel::NO_TEXTURE) usedTextures[texture] = true;
+        }
+
+        for (uint32_t i = 0; i < cooked.getHeader().textureCount; ++i) {
+            const CookedModel::TextureRecord& texture = cooked.getTextures()[i];
+
+            if (!usedTextures[i]) continue;
+
+            std::string textureName(cooked.getString(texture.name));
+
+            if (texture.imageSize > 0) {
+                createTexture(cooked.getImage(texture), texture.imageSize, textureName);
+            } else if (texture.uri.length > 0) {
+                createTexture(std::string(cooked.getString(texture.uri)), textureName);
+            }
+        }
+
+        model->loadCooked(cooked);
+
+        m_uploads.submit();
+
+        acquireMeshes(*model);
+
+        return model;
+    }
+
+    void ResourceManager::acquireMeshes(engine::Model& model) {
+        uint64_t modelID = engine::tools::hashString(model.getName());
+
+        for (auto& node : model.getNodes()) {
+            if (node.mesh == 0) continue;
+
+            acquire(ResourceType::MESH, node.mesh);
+            m_meshModels[node.mesh] = modelID;
+        }
+    }
+
+    std::shared_ptr<const MeshData> ResourceManager::requestMeshData(uint64_t meshID, MeshResidency residency) {
+        auto mesh = m_meshes.find(meshID);
+
+        if (mesh == m_meshes.end()) return nullptr;
+
+        if (mesh->second.getResidency() >= residency) return mesh->second.getData();
+
+        auto model = m_meshModels.find(meshID);
+        const AssetSource* source = model != m_meshModels.end() ? findModelSource(model->second) : nullptr;
+        std::shared_ptr<const MeshData> data = source ? readMeshData(*source, meshID, residency) : nullptr;
+
+        if (!data) {
+            spdlog::warn("[Mesh] {} data could not be read again from its model", engine::tools::lookupString(meshID));
+            return nullptr;
+        }
+
+        mesh->second.setData(data);
+        trackResidency(ResourceType::MESH, meshID, data->getMemorySize(),
+                       mesh->second.getVertexBufferSize() + mesh->second.getIndexBufferSize());
+
+        return data;
+    }
+
+    void ResourceManager::releaseMeshData(uint64_t meshID) {
+        auto mesh = m_meshes.find(meshID);
+
+        if (mesh == m_meshes.end() || !mesh->second.getData()) return;
+
+        mesh->second.setData(nullptr);
+        trackResidency(ResourceType::MESH, meshID, 0, mesh->second.getVertexBufferSize() + mesh->second.getIndexBufferSize());
+    }
+
+    std::shared_ptr<const MeshData> ResourceManager::readMeshData(const AssetSource& source, uint64_t meshID, MeshResidency residency) const {
+        CookedModel cooked;
+
+        // Read from the same file than the mesh was loaded from
+        if (isCookedModelCurrent(source.uri)
+                && cooked.open(MODELS_DIR + source.uri + COOKED_MODEL_EXTENSION, sizeof(StaticVertex), sizeof(SkinnedVertex))) {
+            for (uint32_t i = 0; i < cooked.getHeader().meshCount; ++i) {
+                const CookedModel::MeshRecord& mesh = cooked.getMeshes()[i];
+
+                if (engine::tools::hashString(std::string(cooked.getString(mesh.name))) != meshID) continue;
+
+                return MeshData::create(cooked.getVertices(mesh), static_cast<VertexLayout>(mesh.layout), mesh.vertexCount,
+                                        cooked.getIndices(mesh), mesh.indexSize, mesh.indexCount, residency);
+            }
+
+            return nullptr;
+        }
+
+        GltfFile inputFile;
+
+        if (!inputFile.load(getGltfPath(source.uri))) return nullptr;
+
+        const tinygltf::Model& inputModel = inputFile.getModel();
+
+        for (auto& node : inputModel.nodes) {
+            if (node.mesh < 0 || engine::tools::hashString(node.name) != meshID) continue;
+
+            std::vector<engine::Vertex> vertices;
+            std::vector<uint32_t> indices;
+            VertexLayout layout = gltf::readMesh(inputFile, inputModel.meshes[node.mesh], vertices, indices)
+                                  ? VertexLayout::SKINNED : VertexLayout::STATIC;
+
+            // Same order as the uploaded mesh, the data matches its vertex and index buffers
+            MeshOptimizer::optimize(vertices, indices);
+
+            std::vector<uint8_t> packedVertices;
+            std::vector<uint8_t> packedIndices;
+            uint32_t indexSize = MeshOptimizer::getIndexSize(static_cast<uint32_t>(vertices.size()));
+
+            packVertices(vertices.data(), vertices.size(), layout, packedVertices);
+            MeshOptimizer::packIndices(indices, indexSize, packedIndices);
+
+            return MeshData::create(packedVertices.data(), layout, static_cast<uint32_t>(vertices.size()), packedIndices.data(),
+                                    indexSize, static_cast<uint32_t>(indices.size()), residency);
+        }
+
+        return nullptr;
+    }
+
+    void ResourceManager::releaseMeshes(engine::Model& model) {
+        for (auto& node : model.getNodes()) {
+            if (node.mesh != 0) release(ResourceType::MESH, node.mesh);
+        }
+    }
+
+    void ResourceManager::destroyMesh(uint64_t id, bool deferred) {
+        auto mesh = m_meshes.find(id);
+
+        if (mesh == m_meshes.end()) return;
+
+        trackVertexMemory(mesh->second, true);
+
+        if (mesh->second.getTextureId() != m_defaultTexture) release(ResourceType::TEXTURE, mesh->second.getTextureId());
+
+        m_meshModels.erase(id);
+
+        if (deferred) {
+            m_destroyedMeshes.emplace_back(m_frame, mesh->second);
+        } else {
+            mesh->second.cleanup();
+        }
+
+        m_meshes.erase(mesh);
+    }
+
+    void ResourceManager::trackVertexMemory(const engine::Mesh& mesh, bool release) {
+        uint64_t packedBytes = mesh.getVertexBufferSize();
+        uint64_t fullBytes = static_cast<uint64_t>(mesh.getVertexCount()) * sizeof(engine::Vertex);
+        uint32_t& meshes = mesh.getLayout() == VertexLayout::SKINNED ? m_vertexMemory.skinnedMeshes : m_vertexMemory.staticMeshes;
+
+        if (release) {
+            m_vertexMemory.packedBytes -= packedBytes;
+            m_vertexMemory.fullBytes -= fullBytes;
+            --meshes;
+        } else {
+            m_vertexMemory.packedBytes += packedBytes;
+            m_vertexMemory.fullBytes += fullBytes;
+            ++meshes;
+        }
+    }
+
+    void ResourceManager::logVertexMemory(const std::string& name) const {
+        if (m_vertexMemory.fullBytes == 0) return;
+
+        // Every draw fetches its whole vertex buffer, the saving in VRAM is also the saving in vertex fetch bandwidth
+        spdlog::info("[Mesh] After {}: {} static and {} skinned meshes, vertices use {} KB instead of {} KB ({:.1f}% saved)",
+                     name, m_vertexMemory.staticMeshes, m_vertexMemory.skinnedMeshes, m_vertexMemory.packedBytes / 1024,
+                     m_vertexMemory.fullBytes / 1024,
+                     100.0 * (1.0 - static_cast<double>(m_vertexMemory.packedBytes) / m_vertexMemory.fullBytes));
+    }
+
+    const ResourceManager::VertexMemory& ResourceManager::getVertexMemory() const {
+        return m_vertexMemory;
+    }
+
+    const GeometryPool& ResourceManager::getGeometry() const {
+        return m_geometry;
+    }
+
+    std::shared_ptr<engine::Shader> ResourceManager::createShader(const std::string &vert, const std::string &frag, const std::vector<vk::PushConstantRange>& pushConstants, bool vertexInfo) {
+        m_shaders.emplace_back(std::make_shared<Shader>(vert, frag, m_device->m_logicalDevice, pushConstants, vertexInfo));
+
+        addSource(SHADERS_DIR + vert, AssetType::SHADER, vert, vert);
+        addSource(SHADERS_DIR + frag, AssetType::SHADER, frag, frag);
+
+        return m_shaders.back();
+    }
+
+    uint64_t ResourceManager::loadAnimation(const std::string& uri, const std::string& name) {
+        uint64_t animationName = registerAnimation(uri, name);
+
+        if (m_animations.find(animationName) != m_animations.end()) return animationName;
+
+        std::shared_ptr<Animation> animation = readAnimation(uri, name);
+
+        if (!animation) return 0;
+
+        addAnimation(animationName, animation);
+
+        return animationName;
+    }
+
+    uint64_t ResourceManager::registerAnimation(const std::string& uri, const std::string& name) {
+        uint64_t animationName = engine::tools::internString(name);
+
+        {
+            std::lock_guard<std::mutex> lock(m_animationsMutex);
+            m_animationUris[animationName] = uri;
+        }
+        addSource(ANIMATIONS_DIR + uri, AssetType::ANIMATION, uri, name);
+
+        return animationName;
+    }
 
-            // Vertices
+    void ResourceManager::requestAnimation(uint64_t id) {
+        std::lock_guard<std::mutex> lock(m_animationsMutex);
+        m_animationRequests.insert(id);
+    }
+
+    void ResourceManager::updateAnimations() {
+        std::unordered_set<uint64_t> requests;
+        std::vector<std::pair<uint64_t, std::shared_ptr<Animation>>> read;
+        {
+            std::lock_guard<std::mutex> lock(m_animationsMutex);
+            requests.swap(m_animationRequests);
+            read.swap(m_animationsRead);
+        }
+
+        for (auto& [id, animation] : read) {
             {
-                const float *bufferPos = nullptr;
-                const float *bufferNormals = nullptr;
-                const float *bufferTexCoordSet0 = nullptr;
-                const float *bufferTexCoordSet1 = nullptr;
-                const void *bufferJoints = nullptr;
-                const float *bufferWeights = nullptr;
-
-                int posByteStride;
-                int normByteStride;
-                int uv0ByteStride;
-                int uv1ByteStride;
-                int jointByteStride;
-                int weightByteStride;
-
-                int jointComponentType;
-
-                if (primitive.attributes.find("POSITION") != primitive.attributes.end()) {
-                    const tinygltf::Accessor& accessor = model.accessors[primitive.attributes.find("POSITION")->second];
-                    const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
-                    bufferPos = reinterpret_cast<const float*>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-                    vertexCount = static_cast<uint32_t>(accessor.count);
-                    posByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3);
-                }
+                std::lock_guard<std::mutex> lock(m_animationsMutex);
+                m_animationsReading.erase(id);
+            }
 
-                if (primitive.attributes.find("NORMAL") != primitive.attributes.end()) {
-                    const tinygltf::Accessor& accessor = model.accessors[primitive.attributes.find("NORMAL")->second];
-                    const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
-                    bufferNormals = reinterpret_cast<const float *>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-                    normByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC3);
+            // Requested again after a back-off, the entity holds its pose meanwhile
+            if (!animation) {
+                ReadFailure& failure = m_animationFailures[id];
+                failure.attempts++;
+                failure.retryFrame = m_frame + (ANIMATION_RETRY_FRAMES << (failure.attempts - 1));
+
+                if (failure.attempts < ANIMATION_READ_ATTEMPTS) {
+                    spdlog::warn("[Animation] {} could not be read from {}, attempt {} of {}", engine::tools::lookupString(id),
+                                 ANIMATIONS_DIR + m_animationUris.at(id), failure.attempts, ANIMATION_READ_ATTEMPTS);
+                } else {
+                    spdlog::error("[Animation] {} could not be read from {}, it is not requested again until the file changes",
+                                  engine::tools::lookupString(id), ANIMATIONS_DIR + m_animationUris.at(id));
                 }
+                continue;
+            }
 
-                if (primitive.attributes.find("TEXCOORD_0") != primitive.attributes.end()) {
-                    const tinygltf::Accessor& accessor = model.accessors[primitive.attributes.find("TEXCOORD_0")->second];
-                    const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
-                    bufferTexCoordSet0 = reinterpret_cast<const float *>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-                    uv0ByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC2);
-                }
+            m_animationFailures.erase(id);
 
-                if (primitive.attributes.find("TEXCOORD_1") != primitive.attributes.end()) {
-                    const tinygltf::Accessor& accessor = model.accessors[primitive.attributes.find("TEXCOORD_1")->second];
-                    const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
-                    bufferTexCoordSet1 = reinterpret_cast<const float *>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-                    uv1ByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC2);
-                }
+            if (m_animations.find(id) == m_animations.end()) addAnimation(id, animation);
+        }
 
-                if (primitive.attributes.find("JOINTS_0") != primitive.attributes.end()) {
-                    const tinygltf::Accessor& accessor = model.accessors[primitive.attributes.find("JOINTS_0")->second];
-                    const tinygltf::BufferView &view = model.bufferViews[accessor.bufferView];
-                    bufferJoints = &(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]);
-                    jointComponentType = accessor.componentType;
-                    jointByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / tinygltf::GetComponentSizeInBytes(jointComponentType)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
-                }
+        for (uint64_t id : requests) {
+            auto uri = m_animationUris.find(id);
+            auto failure = m_animationFailures.find(id);
 
-                if (primitive.attributes.find("WEIGHTS_0") != primitive.attributes.end()) {
-                    const tinygltf::Accessor& accessor = model.accessors[primitive.attributes.find("WEIGHTS_0")->second];
-                    const tinygltf::BufferView &view = model.bufferViews[accessor.bufferView];
-                    bufferWeights = reinterpret_cast<const float *>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-                    weightByteStride = accessor.ByteStride(view) ? (accessor.ByteStride(view) / sizeof(float)) : tinygltf::GetNumComponentsInType(TINYGLTF_TYPE_VEC4);
-                }
+            if (uri == m_animationUris.end() || m_animations.contains(id)) continue;
 
-                bool hasSkin = (bufferJoints && bufferWeights);
-
-                for (size_t v = 0; v < vertexCount; ++v) {
-                    engine::Vertex vert{};
-                    vert.position = glm::make_vec3(&bufferPos[v * posByteStride]);
-                    vert.normal = glm::normalize(glm::vec3(bufferNormals ? glm::make_vec3(&bufferNormals[v * normByteStride]) : glm::vec3(0.0f)));
-                    vert.uv0 = bufferTexCoordSet0 ? glm::make_vec2(&bufferTexCoordSet0[v * uv0ByteStride]) : glm::vec3(0.0f);
-                    vert.uv1 = bufferTexCoordSet1 ? glm::make_vec2(&bufferTexCoordSet1[v * uv1ByteStride]) : glm::vec3(0.0f);
-
-                    if (hasSkin) {
-                        switch (jointComponentType) {
-                            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
-                                const auto *buf = static_cast<const uint16_t*>(bufferJoints);
-                                vert.joint0 = glm::vec4(glm::make_vec4(&buf[v * jointByteStride]));
-                                break;
-                            }
-                            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
-                                const auto *buf = static_cast<const uint8_t*>(bufferJoints);
-                                vert.joint0 = glm::vec4(glm::make_vec4(&buf[v * jointByteStride]));
-                                break;
-                            }
-                            default: {
-                                spdlog::error("Joint component type {} not supported!", jointComponentType);
-                                break;
-                            }
-                        }
-                    } else {
-                        vert.joint0 = glm::vec4(0.0f);
-                    }
+            if (failure != m_animationFailures.end()
+                    && (failure->second.attempts >= ANIMATION_READ_ATTEMPTS || m_frame < failure->second.retryFrame)) {
+                continue;
+            }
 
-                    vert.weight0 = hasSkin ? glm::make_vec4(&bufferWeights[v * weightByteStride]) : glm::vec4(0.0f);
+            {
+                std::lock_guard<std::mutex> lock(m_animationsMutex);
+                if (!m_animationsReading.insert(id).second) continue;
+            }
 
-                    // Fix for all zero weights
-                    if (glm::length(vert.weight0) == 0.0f)
-                        vert.weight0 = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+            Application::m_threadPool->submit([this, id, uri = uri->second, name = std::string(engine::tools::lookupString(id))] {
+                std::shared_ptr<Animation> animation;
 
-                    vertices.push_back(vert);
+                // A failed read is reported like a missing clip, the id is never left marked as reading
+                try {
+                    animation = readAnimation(uri, name);
+                } catch (const std::exception& e) {
+                    spdlog::error("[Animation] {}: {}", name, e.what());
                 }
+
+                std::lock_guard<std::mutex> lock(m_animationsMutex);
+                m_animationsRead.emplace_back(id, animation);
+            });
+        }
+    }
+
+    std::shared_ptr<Animation> ResourceManager::readAnimation(const std::string& uri, const std::string& name) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::string path = ANIMATIONS_DIR + uri;
+        std::string cachePath = ANIMATIONS_DIR + name + CLIP_CACHE_EXTENSION;
+        Animation::SourceStamp stamp = Animation::getSourceStamp(path);
+
+        // The clip is stale once any of its buffers changed too
+        for (auto& buffer : GltfFile::getBufferFiles(path)) {
+            Animation::SourceStamp bufferStamp = Animation::getSourceStamp(buffer);
+            stamp.size += bufferStamp.size;
+            stamp.writeTime = std::max(stamp.writeTime, bufferStamp.writeTime);
+        }
+
+        auto animation = std::make_shared<Animation>();
+        bool cached = animation->load(cachePath, stamp);
+
+        if (!cached) {
+            GltfFile inputFile;
+
+            if (!inputFile.load(path) || inputFile.getModel().animations.empty()) return nullptr;
+
+            animation = parseAnimation(inputFile);
+
+            if (!animation->save(cachePath, stamp)) spdlog::warn("[Animation] {}: failed to write {}", name, cachePath);
+        }
+
+        finishAnimation(*animation);
+
+        std::chrono::duration<float, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+        spdlog::info("[Animation] {} read from {} in {:.2f} ms", name, cached ? cachePath : path, time.count());
+
+        return animation;
+    }
+
+    void ResourceManager::addAnimation(uint64_t id, const std::shared_ptr<Animation>& animation) {
+        {
+            // Scene tasks look clips up while the map changes
+            std::lock_guard<std::mutex> lock(m_animationsMutex);
+            m_animations[id] = animation;
+        }
+
+        trackResidency(ResourceType::ANIMATION, id, animation->getMemorySize(), 0);
+
+        // Bake settings given before the clip was read
+        auto settings = m_bakeSettings.find(id);
+        if (settings != m_bakeSettings.end()) bakeAnimation(std::string(engine::tools::lookupString(id)), settings->second);
+    }
+
+    std::shared_ptr<Animation> ResourceManager::createAnimation(const GltfFile& inputFile) {
+        std::shared_ptr<Animation> animation = parseAnimation(inputFile);
+        finishAnimation(*animation);
+
+        return animation;
+    }
+
+    std::shared_ptr<Animation> ResourceManager::parseAnimation(const GltfFile& inputFile) {
+        const tinygltf::Model& inputModel = inputFile.getModel();
+        tinygltf::Animation gltfAnimation = inputModel.animations[0];
+        auto animation = std::make_shared<Animation>();
+        animation->m_name = gltfAnimation.name;
+
+        animation->m_samplers.resize(gltfAnimation.samplers.size());
+        for (int i = 0; i < gltfAnimation.samplers.size(); ++i) {
+            tinygltf::AnimationSampler& glTFSampler = gltfAnimation.samplers[i];
+            Animation::Sampler& dstSampler = animation->m_samplers[i];
+
+            if (glTFSampler.interpolation == "LINEAR") {
+                dstSampler.interpolation = Animation::Sampler::InterpolationType::LINEAR;
+            }
+            if (glTFSampler.interpolation == "STEP") {
+                dstSampler.interpolation = Animation::Sampler::InterpolationType::STEP;
+            }
+            if (glTFSampler.interpolation == "CUBICSPLINE") {
+                dstSampler.interpolation = Animation::Sampler::InterpolationType::CUBICSPLINE;
             }
 
-            // Indices
+            // Read sampler keyframe input time values
             {
-                const tinygltf::Accessor &accessor = model.accessors[primitive.indices > -1 ? primitive.indices : 0];
-                const tinygltf::BufferView &bufferView = model.bufferViews[accessor.bufferView];
-                const tinygltf::Buffer &buffer = model.buffers[bufferView.buffer];
+                const tinygltf::Accessor&  accessor = inputModel.accessors[glTFSampler.input];
+                const void *dataPtr = inputFile.getBufferView(accessor.bufferView) + accessor.byteOffset;
+                const auto *buf = static_cast<const float *>(dataPtr);
 
-                indexCount = static_cast<uint32_t>(accessor.count);
-                const void *dataPtr = &(buffer.data[accessor.byteOffset + bufferView.byteOffset]);
+                dstSampler.inputs.resize(accessor.count);
+                for (size_t index = 0; index < accessor.count; ++index)
+                    dstSampler.inputs[index] = buf[index];
 
-                switch (accessor.componentType) {
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
-                        const auto *buf = static_cast<const uint32_t*>(dataPtr);
+                for (auto input : animation->m_samplers[i].inputs) {
+                    if (input < animation->m_start) animation->m_start = input;
 
-                        for (size_t index = 0; index < accessor.count; ++index) indices.push_back(buf[index]);
+                    if (input > animation->m_end) animation->m_end = input;
+                }
+            }
 
-                        break;
-                    }
-                    case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT: {
-                        const auto *buf = static_cast<const uint16_t*>(dataPtr);
+            // Read sampler keyframe output translate/rotate/scale values
+            {
+                const tinygltf::Accessor& accessor = inputModel.accessors[glTFSampler.output];
+                const void* dataPtr = inputFile.getBufferView(accessor.bufferView) + accessor.byteOffset;
+
+                switch (accessor.type) {
+                    case TINYGLTF_TYPE_VEC3: {
+                        const auto *buf = static_cast<const glm::vec3 *>(dataPtr);
 
-                        for (size_t index = 0; index < accessor.count; index++) indices.push_back(buf[index]);
+                        for (size_t index = 0; index < accessor.count; index++) dstSampler.outputs.emplace_back(buf[index], 0.0f);
 
                         break;
                     }
-                    case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE: {
-                        const auto *buf = static_cast<const uint8_t*>(dataPtr);
+                    case TINYGLTF_TYPE_VEC4: {
+                        const auto *buf = static_cast<const glm::vec4 *>(dataPtr);
 
-                        for (size_t index = 0; index < accessor.count; index++) indices.push_back(buf[index]);
+                        for (size_t index = 0; index < accessor.count; index++) dstSampler.outputs.push_back(buf[index]);
 
                         break;
                     }
                     default: {
-                        spdlog::error("Index component type {} not supported!", accessor.componentType );
+                        fmt::print("Unknown type\n");
+                        break;
                     }
                 }
             }
         }
 
-        // TODO: Check validation layer for use CommandPool with different queue family index
-        m_meshes[meshID] = engine::Mesh(vertices, indices, m_device->m_logicalDevice.getQueue(m_device->m_queueFamilyIndices.transfer, 0), texturesID, m_device);
+        // Channels
+        animation->m_channels.resize(gltfAnimation.channels.size());
+        for (int i = 0; i < gltfAnimation.channels.size(); ++i) {
+            tinygltf::AnimationChannel gltfChannel = gltfAnimation.channels[i];
+            Animation::Channel& dstChannel = animation->m_channels[i];
+            dstChannel.samplerIndex = gltfChannel.sampler;
+            dstChannel.nodeID = gltfChannel.target_node;
 
-        return meshID;
+            if (gltfChannel.target_path == "rotation") dstChannel.path = Animation::Channel::PathType::ROTATION;
+
+            if (gltfChannel.target_path == "translation") dstChannel.path = Animation::Channel::PathType::TRANSLATION;
+
+            if (gltfChannel.target_path == "scale") dstChannel.path = Animation::Channel::PathType::SCALE;
+
+            if (gltfChannel.target_path == "weights") {
+                spdlog::warn("weights not yet supported, skipping channel");
+                dstChannel.nodeID = -1;
+                continue;
+            }
+
+            // Cubic spline samplers hold an in tangent, a value and an out tangent per key
+            const Animation::Sampler& sampler = animation->m_samplers[dstChannel.samplerIndex];
+            size_t keySize = sampler.interpolation == Animation::Sampler::InterpolationType::CUBICSPLINE ? 3 : 1;
+
+            if (sampler.inputs.empty() || sampler.outputs.size() != sampler.inputs.size() * keySize) {
+                spdlog::warn("[Animation] {}: sampler {} has {} outputs for {} keys, skipping channel", animation->m_name,
+                             dstChannel.samplerIndex, sampler.outputs.size(), sampler.inputs.size());
+                dstChannel.nodeID = -1;
+            }
+        }
+
+        return animation;
     }
 
-    std::shared_ptr<engine::Shader> ResourceManager::createShader(const std::string &vert, const std::string &frag, const std::vector<vk::PushConstantRange>& pushConstants, bool vertexInfo) {
-        m_shaders.emplace_back(std::make_shared<Shader>(vert, frag, m_device->m_logicalDevice, pushConstants, vertexInfo));
+    void ResourceManager::finishAnimation(Animation& animation) {
+#ifdef CORE_DEBUG
+        if (uint32_t mismatches = AnimationSampler::verify(animation)) {
+            spdlog::warn("[Animation] {}: {} samples differ from the reference values", animation.m_name, mismatches);
+        }
+#endif
 
-        return m_shaders.back();
+        animation.m_keysHash = animation.hashKeys();
+
+        if (COMPRESS_ANIMATIONS) animation.compress(CompressedClip::Settings{});
     }
 
-    uint32_t ResourceManager::loadAnimation(const std::string& uri, const std::string& name) {
-        uint32_t animationName = std::hash<std::string>{}(name);
+    void ResourceManager::bakeAnimation(const std::string& name, const PoseCache::Settings& settings) {
+        uint64_t animationName = engine::tools::hashString(name);
+        auto it = m_animations.find(animationName);
 
-        if (m_animations.find(animationName) != m_animations.end()) return animationName;
+        // A clip not read yet is baked when it is added
+        if (it == m_animations.end()) {
+            m_bakeSettings[animationName] = settings;
+            return;
+        }
 
-        tinygltf::Model inputModel;
-        tinygltf::TinyGLTF loader;
-        std::string error, warning;
+        if (it->second->m_poseCache.isBaked()) return;
 
-        if (loader.LoadASCIIFromFile(&inputModel, &error, &warning, ANIMATIONS_DIR + uri)) {
-            tinygltf::Animation gltfAnimation = inputModel.animations[0];
-            m_animations[animationName] = std::make_shared<Animation>();
-            std::shared_ptr<Animation> animation = m_animations[animationName];
-            animation->m_name = gltfAnimation.name;
+        m_bakeSettings[animationName] = settings;
 
-            animation->m_samplers.resize(gltfAnimation.samplers.size());
-            for (int i = 0; i < gltfAnimation.samplers.size(); ++i) {
-                tinygltf::AnimationSampler& glTFSampler = gltfAnimation.samplers[i];
-                Animation::Sampler& dstSampler = animation->m_samplers[i];
+        PoseCache& cache = it->second->m_poseCache;
+        std::string path = ANIMATIONS_DIR + name + ".pose";
 
-                if (glTFSampler.interpolation == "LINEAR") {
-                    dstSampler.interpolation = Animation::Sampler::InterpolationType::LINEAR;
-                }
-                if (glTFSampler.interpolation == "STEP") {
-                    dstSampler.interpolation = Animation::Sampler::InterpolationType::STEP;
-                }
-                if (glTFSampler.interpolation == "CUBICSPLINE") {
-                    dstSampler.interpolation = Animation::Sampler::InterpolationType::CUBICSPLINE;
-                }
+        if (settings.onDisk && cache.load(path, *it->second, settings)) {
+            spdlog::info("[Animation] {}: baked frames loaded from {}", name, path);
+            trackResidency(ResourceType::ANIMATION, animationName, it->second->getMemorySize(), 0);
+            return;
+        }
 
-                // Read sampler keyframe input time values
-                {
-                    const tinygltf::Accessor&  accessor = inputModel.accessors[glTFSampler.input];
-                    const tinygltf::BufferView &bufferView = inputModel.bufferViews[accessor.bufferView];
-                    const tinygltf::Buffer& buffer = inputModel.buffers[bufferView.buffer];
-                    const void *dataPtr = &buffer.data[accessor.byteOffset + bufferView.byteOffset];
-                    const auto *buf = static_cast<const float *>(dataPtr);
+        if (cache.bake(*it->second, settings) && settings.onDisk && !cache.save(path)) {
+            spdlog::warn("[Animation] {}: failed to write {}", name, path);
+        }
 
-                    dstSampler.inputs.resize(accessor.count);
-                    for (size_t index = 0; index < accessor.count; ++index)
-                        dstSampler.inputs[index] = buf[index];
+        trackResidency(ResourceType::ANIMATION, animationName, it->second->getMemorySize(), 0);
+    }
 
-                    for (auto input : animation->m_samplers[i].inputs) {
-                        if (input < animation->m_start) animation->m_start = input;
+    std::shared_ptr<Animation> ResourceManager::getAnimation(uint64_t name) {
+        // Called by the animation tasks while the main thread adds and evicts clips
+        std::lock_guard<std::mutex> lock(m_animationsMutex);
+        auto it = m_animations.find(name);
 
-                        if (input > animation->m_end) animation->m_end = input;
-                    }
-                }
+        if (it != m_animations.end()) return it->second;
+
+        if (m_animationUris.contains(name)) m_animationRequests.insert(name);
 
-                // Read sampler keyframe output translate/rotate/scale values
-                {
-                    const tinygltf::Accessor& accessor = inputModel.accessors[glTFSampler.output];
-                    const tinygltf::BufferView& bufferView = inputModel.bufferViews[accessor.bufferView];
-                    const tinygltf::Buffer& buffer = inputModel.buffers[bufferView.buffer];
-                    const void* dataPtr = &buffer.data[accessor.byteOffset + bufferView.byteOffset];
+        return nullptr;
+    }
 
-                    switch (accessor.type) {
-                        case TINYGLTF_TYPE_VEC3: {
-                            const auto *buf = static_cast<const glm::vec3 *>(dataPtr);
+    void ResourceManager::addSource(const std::string& path, AssetType type, const std::string& uri, const std::string& name) {
+        m_sources[std::filesystem::path(path).lexically_normal().string()] = {type, uri, name};
 
-                            for (size_t index = 0; index < accessor.count; index++) dstSampler.outputs.emplace_back(buf[index], 0.0f);
+        std::string extension = std::filesystem::path(path).extension().string();
 
-                            break;
-                        }
-                        case TINYGLTF_TYPE_VEC4: {
-                            const auto *buf = static_cast<const glm::vec4 *>(dataPtr);
+        if (extension != ".gltf" && extension != ".glb") return;
+
+        for (auto& buffer : GltfFile::getBufferFiles(path)) m_sources[std::filesystem::path(buffer).lexically_normal().string()] = {type, uri, name};
+    }
+
+    const ResourceManager::AssetSource* ResourceManager::findSource(const std::string& path) const {
+        auto it = m_sources.find(std::filesystem::path(path).lexically_normal().string());
+
+        return it != m_sources.end() ? &it->second : nullptr;
+    }
+
+    const std::unordered_map<std::string, ResourceManager::AssetSource>& ResourceManager::getSources() const {
+        return m_sources;
+    }
+
+    void ResourceManager::reloadTexture(const std::string& name, const void* pixels, int width, int height, vk::DeviceSize size) {
+        auto it = m_textures.find(engine::tools::hashString(name));
+
+        if (it == m_textures.end()) return;
+
+        // The new image is written in the descriptor of the old one, the meshes keep binding the same set and index
+        engine::Texture texture = uploadTexture(pixels, width, height, size);
+        texture.setDescriptorSet(m_device->m_logicalDevice, it->second.getDescriptorSet(), it->second.getIndex());
+
+        it->second.cleanup(m_device->m_logicalDevice);
+        it->second = texture;
+        trackResidency(ResourceType::TEXTURE, it->first, 0, texture.getMemorySize());
+    }
 
-                            for (size_t index = 0; index < accessor.count; index++) dstSampler.outputs.push_back(buf[index]);
+    void ResourceManager::reloadModel(const std::string& name, const GltfFile& inputFile) {
+        auto it = m_models.find(engine::tools::hashString(name));
 
-                            break;
-                        }
-                        default: {
-                            fmt::print("Unknown type\n");
-                            break;
-                        }
+        if (it == m_models.end()) return;
+
+        // Meshes are rebuilt under the same ids, the references other models hold on them are kept
+        for (auto& node : it->second->getNodes()) destroyMesh(node.mesh, false);
+
+        std::shared_ptr<engine::Model> model = buildModel(inputFile, name);
+        releaseMeshes(*it->second);
+        *it->second = *model;
+        trackResidency(ResourceType::MODEL, it->first, it->second->getMemorySize(), 0);
+
+        Application::m_scene->refreshModel(it->second);
+        logVertexMemory(name);
+    }
+
+    void ResourceManager::reloadModel(const std::string& name, const CookedModel& cooked) {
+        auto it = m_models.find(engine::tools::hashString(name));
+
+        if (it == m_models.end()) return;
+
+        // Meshes are rebuilt under the same ids, the references other models hold on them are kept
+        for (auto& node : it->second->getNodes()) destroyMesh(node.mesh, false);
+
+        std::shared_ptr<engine::Model> model = buildModel(cooked, name);
+        releaseMeshes(*it->second);
+        *it->second = *model;
+        trackResidency(ResourceType::MODEL, it->first, it->second->getMemorySize(), 0);
+
+        Application::m_scene->refreshModel(it->second);
+        logVertexMemory(name);
+    }
+
+    void ResourceManager::reloadAnimation(const std::string& name, const std::shared_ptr<Animation>& animation) {
+        uint64_t animationName = engine::tools::hashString(name);
+        auto it = m_animations.find(animationName);
+
+        // The next request reads the changed file
+        m_animationFailures.erase(animationName);
+
+        if (it == m_animations.end()) return;
+
+        *it->second = std::move(*animation);
+
+        // The frames on disk belong to the old clip, they are baked again from the new keys
+        auto settings = m_bakeSettings.find(animationName);
+        if (settings != m_bakeSettings.end() && it->second->m_poseCache.bake(*it->second, settings->second)
+                && settings->second.onDisk && !it->second->m_poseCache.save(ANIMATIONS_DIR + name + ".pose")) {
+            spdlog::warn("[Animation] {}: failed to write {}", name, ANIMATIONS_DIR + name + ".pose");
+        }
+
+        trackResidency(ResourceType::ANIMATION, animationName, it->second->getMemorySize(), 0);
+    }
+
+    void ResourceManager::reloadShader(const std::string& file, const std::vector<uint32_t>& code) {
+        for (auto& shader : m_shaders) {
+            if (shader->reload(m_device->m_logicalDevice, file, code)) Application::m_renderer->reloadPipelines(shader);
+        }
+    }
+
+    void ResourceManager::acquire(ResourceType type, uint64_t id) {
+        auto& entries = m_residency[static_cast<size_t>(type)];
+        auto entry = entries.find(id);
+
+        // Clips loaded lazily are referenced before they are read
+        if (entry == entries.end()) {
+            if (type != ResourceType::ANIMATION || !m_animationUris.contains(id)) return;
+
+            entry = entries.emplace(id, ResidencyEntry{}).first;
+        }
+
+        entry->second.references++;
+        entry->second.lastUse = m_frame;
+    }
+
+    void ResourceManager::release(ResourceType type, uint64_t id) {
+        auto& entries = m_residency[static_cast<size_t>(type)];
+        auto entry = entries.find(id);
+
+        if (entry == entries.end() || entry->second.references == 0) return;
+
+        entry->second.references--;
+        entry->second.lastUse = m_frame;
+    }
+
+    void ResourceManager::updateResidency() {
+        m_frame++;
+
+        updateAnimations();
+
+        destroyEvicted(false);
+
+        if (m_cpuBytes <= m_budget.cpuBytes && m_gpuBytes <= m_budget.gpuBytes) return;
+
+        auto evictions = m_evictions;
+
+        // Evicting a model releases its meshes and a mesh its texture, they are candidates of the next pass
+        while (m_cpuBytes > m_budget.cpuBytes || m_gpuBytes > m_budget.gpuBytes) {
+            bool cpuOver = m_cpuBytes > m_budget.cpuBytes;
+            bool gpuOver = m_gpuBytes > m_budget.gpuBytes;
+            std::vector<std::tuple<uint64_t, ResourceType, uint64_t>> candidates;
+
+            for (size_t type = 0; type < m_residency.size(); ++type) {
+                for (auto& [id, entry] : m_residency[type]) {
+                    if (entry.references == 0 && ((cpuOver && entry.cpuBytes > 0) || (gpuOver && entry.gpuBytes > 0))) {
+                        candidates.emplace_back(entry.lastUse, static_cast<ResourceType>(type), id);
                     }
                 }
             }
 
-            // Channels
-            animation->m_channels.resize(gltfAnimation.channels.size());
-            for (int i = 0; i < gltfAnimation.channels.size(); ++i) {
-                tinygltf::AnimationChannel gltfChannel = gltfAnimation.channels[i];
-                Animation::Channel& dstChannel = animation->m_channels[i];
-                dstChannel.samplerIndex = gltfChannel.sampler;
-                dstChannel.nodeID = gltfChannel.target_node;
+            if (candidates.empty()) break;
 
-                if (gltfChannel.target_path == "rotation") dstChannel.path = Animation::Channel::PathType::ROTATION;
+            std::sort(candidates.begin(), candidates.end());
 
-                if (gltfChannel.target_path == "translation") dstChannel.path = Animation::Channel::PathType::TRANSLATION;
+            for (auto& [lastUse, type, id] : candidates) {
+                if (m_cpuBytes <= m_budget.cpuBytes && m_gpuBytes <= m_budget.gpuBytes) break;
 
-                if (gltfChannel.target_path == "scale") dstChannel.path = Animation::Channel::PathType::SCALE;
+                evict(type, id);
+            }
+        }
 
-                if (gltfChannel.target_path == "weights") {
-                    spdlog::warn("weights not yet supported, skipping channel");
-                    continue;
-                }
+        if (evictions != m_evictions) logResidency();
+    }
+
+    void ResourceManager::destroyEvicted(bool all) {
+        // An evicted resource can still be read by the frames in flight recorded before its eviction
+        auto unused = [this, all](uint64_t frame) { return all || m_frame > frame + MAX_FRAMES_IN_FLIGHT; };
+
+        std::erase_if(m_destroyedMeshes, [&](auto& mesh) {
+            if (unused(mesh.first)) mesh.second.cleanup();
+
+            return unused(mesh.first);
+        });
+
+        std::erase_if(m_destroyedTextures, [&](auto& texture) {
+            if (!unused(texture.first)) return false;
+
+            if (m_device->m_bindless) {
+                m_freeTextureIndices.push_back(texture.second.getIndex());
+            } else {
+                m_device->m_logicalDevice.freeDescriptorSets(m_imagesDescriptorPool, texture.second.getDescriptorSet());
             }
-        } else {
-            return 0;
+
+            texture.second.cleanup(m_device->m_logicalDevice);
+
+            return true;
+        });
+    }
+
+    void ResourceManager::setMemoryBudget(const MemoryBudget& budget) {
+        m_budget = budget;
+    }
+
+    ResourceManager::Residency ResourceManager::getResidency(ResourceType type) const {
+        Residency residency{};
+
+        for (auto& [id, entry] : m_residency[static_cast<size_t>(type)]) {
+            // Referenced but not read yet
+            if (entry.cpuBytes == 0 && entry.gpuBytes == 0) continue;
+
+            residency.resident++;
+            residency.cpuBytes += entry.cpuBytes;
+            residency.gpuBytes += entry.gpuBytes;
+
+            if (entry.references > 0) residency.referenced++;
         }
 
-        return animationName;
+        residency.evicted = m_evictions[static_cast<size_t>(type)];
+
+        return residency;
     }
 
-    std::shared_ptr<Animation> ResourceManager::getAnimation(uint64_t name) {
-        return m_animations[name];
+    void ResourceManager::logResidency() const {
+        const char* names[] = {"Textures", "Meshes", "Models", "Animations"};
+        auto megabytes = [](uint64_t bytes) { return static_cast<float>(bytes) / (1024.0f * 1024.0f); };
+
+        for (size_t type = 0; type < m_residency.size(); ++type) {
+            Residency residency = getResidency(static_cast<ResourceType>(type));
+            spdlog::info("[Resources] {}: {} resident, {} referenced, {:.2f} MB CPU, {:.2f} MB GPU, {} evicted", names[type],
+                         residency.resident, residency.referenced, megabytes(residency.cpuBytes), megabytes(residency.gpuBytes),
+                         residency.evicted);
+        }
+
+        spdlog::info("[Resources] {:.2f} / {:.2f} MB CPU, {:.2f} / {:.2f} MB GPU", megabytes(m_cpuBytes), megabytes(m_budget.cpuBytes),
+                     megabytes(m_gpuBytes), megabytes(m_budget.gpuBytes));
+    }
+
+    void ResourceManager::trackResidency(ResourceType type, uint64_t id, uint64_t cpuBytes, uint64_t gpuBytes) {
+        ResidencyEntry& entry = m_residency[static_cast<size_t>(type)][id];
+
+        m_cpuBytes = m_cpuBytes - entry.cpuBytes + cpuBytes;
+        m_gpuBytes = m_gpuBytes - entry.gpuBytes + gpuBytes;
+
+        entry.cpuBytes = cpuBytes;
+        entry.gpuBytes = gpuBytes;
+        entry.lastUse = m_frame;
     }
 
-    void ResourceManager::createMeshDescriptors(const std::vector<vk::DescriptorPoolSize>& sizes, uint32_t maxSize) {
-        vk::DescriptorPoolCreateInfo poolCreateInfo{
-            .maxSets = maxSize,
-            .poolSizeCount = static_cast<uint32_t>(sizes.size()),
-            .pPoolSizes = sizes.data()
+    void ResourceManager::evict(ResourceType type, uint64_t id) {
+        auto& entries = m_residency[static_cast<size_t>(type)];
+        auto entry = entries.find(id);
+
+        if (entry == entries.end()) return;
+
+        m_cpuBytes -= entry->second.cpuBytes;
+        m_gpuBytes -= entry->second.gpuBytes;
+        entries.erase(entry);
+        m_evictions[static_cast<size_t>(type)]++;
+
+        switch (type) {
+            case ResourceType::TEXTURE: {
+                auto texture = m_textures.find(id);
+
+                if (texture != m_textures.end()) {
+                    m_destroyedTextures.emplace_back(m_frame, texture->second);
+                    m_textures.erase(texture);
+                }
+                break;
+            }
+            case ResourceType::MESH:
+                destroyMesh(id, true);
+                break;
+            case ResourceType::MODEL: {
+                auto model = m_models.find(id);
+
+                if (model != m_models.end()) {
+                    releaseMeshes(*model->second);
+                    m_models.erase(model);
+                }
+                break;
+            }
+            case ResourceType::ANIMATION: {
+                // Components keep the clip they are playing alive, the next lookup reads it again
+                std::lock_guard<std::mutex> lock(m_animationsMutex);
+                m_animations.erase(id);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void ResourceManager::createPaletteDescriptors() {
+        vk::DescriptorPoolSize poolSize{
+            .type = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = 1
         };
 
-        m_meshSDescriptorPool = m_device->m_logicalDevice.createDescriptorPool(poolCreateInfo);
+        m_paletteDescriptorPool = m_device->m_logicalDevice.createDescriptorPool({
+            .maxSets = 1,
+            .poolSizeCount = 1,
+            .pPoolSizes = &poolSize
+        });
 
         vk::DescriptorSetLayoutBinding layoutBinding{
             .binding = 0,
-            .descriptorType = vk::DescriptorType::eUniformBuffer,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
             .descriptorCount = 1,
             .stageFlags = vk::ShaderStageFlagBits::eVertex,
             .pImmutableSamplers = nullptr
         };
 
-        vk::DescriptorSetLayoutCreateInfo layoutCreateInfo{
-            .bindingCount = 1,
-            .pBindings = &layoutBinding
-        };
+        m_paletteDescriptorSetLayout = m_device->m_layoutCache->getSetLayout({layoutBinding});
 
-        m_meshDescriptorSetLayout = m_device->m_logicalDevice.createDescriptorSetLayout(layoutCreateInfo);
-    }
+        vk::DescriptorSetAllocateInfo allocateInfo{
+                .descriptorPool = m_paletteDescriptorPool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &m_paletteDescriptorSetLayout
+        };
 
-    void ResourceManager::createMeshDescriptorSets() {
-        for (auto& [id, mesh] : m_meshes) {
-            vk::DescriptorSetAllocateInfo allocateInfo{
-                    .descriptorPool = m_meshSDescriptorPool,
-                    .descriptorSetCount = 1,
-                    .pSetLayouts = &m_meshDescriptorSetLayout
-            };
+        m_paletteDescriptorSet = m_device->m_logicalDevice.allocateDescriptorSets(allocateInfo).front();
 
-            mesh.m_uniformBuffer.m_descriptorSet = m_device->m_logicalDevice.allocateDescriptorSets(allocateInfo).front();
+        writePaletteDescriptor();
+    }
 
-            vk::WriteDescriptorSet writeDescriptorSet{
-                    .dstSet = mesh.m_uniformBuffer.m_descriptorSet,
-                    .dstBinding = 0,
-                    .descriptorCount = 1,
-                    .descriptorType = vk::DescriptorType::eUniformBuffer,
-                    .pBufferInfo= &mesh.m_uniformBuffer.m_descriptor
-            };
+    void ResourceManager::writePaletteDescriptor() {
+        // The whole ring is bound once, every draw indexes the blocks of its instances from the offset pushed in DrawConstants
+        vk::DescriptorBufferInfo bufferInfo = m_paletteRing.getBuffer().m_descriptor;
+        vk::WriteDescriptorSet writeDescriptorSet{
+                .dstSet = m_paletteDescriptorSet,
+                .dstBinding = 0,
+                .descriptorCount = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .pBufferInfo = &bufferInfo
+        };
 
-            m_device->m_logicalDevice.updateDescriptorSets(1, &writeDescriptorSet, 0, nullptr);
-        }
+        m_device->m_logicalDevice.updateDescriptorSets(1, &writeDescriptorSet, 0, nullptr);
     }
 
     uint32_t ResourceManager::getMeshesCount() {
         return static_cast<uint32_t>(m_meshes.size());
     }
 
-    vk::DescriptorSetLayout ResourceManager::getMeshDescriptorSetLayout() {
-        return m_meshDescriptorSetLayout;
+    vk::DescriptorSetLayout ResourceManager::getPaletteDescriptorSetLayout() {
+        return m_paletteDescriptorSetLayout;
     }
 
-    void ResourceManager::initialPose() {
-        for (auto& [key, model] : m_models) {
-            for (auto& node : model->getNodes()) {
-                if (node.mesh > 0) {
-                    glm::mat4 matrix = node.getMatrix(model);
-                    Mesh& mesh = Application::m_resourceManager->getMesh(node.mesh);
+    vk::DescriptorSet& ResourceManager::getPaletteDescriptorSet() {
+        return m_paletteDescriptorSet;
+    }
 
-                    if (node.skin > -1) {
-                        mesh.m_uniformBlock.matrix = matrix;
-                        glm::mat4 inverseTransform = glm::inverse(matrix);
-                        Model::Skin &skin = model->getSkin(node.skin);
-                        size_t numJoints = static_cast<uint32_t>(skin.joints.size());
+    RingBuffer& ResourceManager::getPaletteRing() {
+        return m_paletteRing;
+    }
 
-                        for (size_t i = 0; i < numJoints; ++i) {
-                            glm::mat4 jointMatrix = model->getNode(skin.joints[i]).getMatrix(model) * skin.inverseBindMatrices[i];
-                            mesh.m_uniformBlock.jointMatrix[i] = inverseTransform * jointMatrix;
-                        }
+    void ResourceManager::reservePalettes(vk::DeviceSize size) {
+        if (size <= m_paletteRing.getSegmentSize()) return;
 
-                        mesh.m_uniformBlock.jointCount = (float)numJoints;
-                        mesh.m_uniformBuffer.copyTo(&mesh.m_uniformBlock, sizeof(mesh.m_uniformBlock));
-                    } else {
-                        mesh.m_uniformBuffer.copyTo(&matrix, sizeof(glm::mat4));
-                    }
-                }
-            }
-        }
+        // Room for the scene to keep growing before the next reallocation
+        vk::DeviceSize segmentSize = std::max(size + size / 2, 2 * m_paletteRing.getSegmentSize());
+
+        m_device->m_logicalDevice.waitIdle();
+
+        m_paletteRing.cleanup();
+        m_paletteRing.create(m_device, vk::BufferUsageFlagBits::eStorageBuffer, segmentSize, MAX_FRAMES_IN_FLIGHT, sizeof(glm::mat4));
+
+        if (m_paletteDescriptorSet) writePaletteDescriptor();
+
+        spdlog::info("[Resources] Palette ring grown to {} KB per frame for {} KB of palettes", segmentSize / 1024, size / 1024);
     }
 
 } // namespace core
@@ -2,9 +2,11 @@
 #define PROTOTYPE_ACTION_RPG_RESOURCEMANAGER_HPP
 
 
+#include <array>
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <unordered_set>
 
 #define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
 #include "vulkan/vulkan.hpp"
@@ -12,8 +14,12 @@
 #include "Texture.hpp"
 #include "Model.hpp"
 #include "Animation.hpp"
+#include "ResourceHandle.hpp"
 #include "../Utilities.hpp"
+#include "../mesh/GeometryBuffer.hpp"
 #include "../renderer/Device.hpp"
+#include "../renderer/RingBuffer.hpp"
+#include "../renderer/UploadBatch.hpp"
 
 
 namespace engine {
@@ -21,6 +27,43 @@ namespace engine {
     class Shader;
 
     class ResourceManager {
+    public:
+        enum class AssetType {
+            TEXTURE,
+            MODEL,
+            ANIMATION,
+            SHADER
+        };
+
+        // File an asset was loaded from, hot reload maps the changed files back to their asset
+        struct AssetSource {
+            AssetType type;
+            std::string uri;
+            std::string name;
+        };
+
+        // Vertex buffer bytes of the loaded meshes, packed compared to the full precision engine::Vertex
+        struct VertexMemory {
+            uint64_t packedBytes{};
+            uint64_t fullBytes{};
+            uint32_t staticMeshes{};
+            uint32_t skinnedMeshes{};
+        };
+
+        struct MemoryBudget {
+            uint64_t cpuBytes{};
+            uint64_t gpuBytes{};
+        };
+
+        // Resources of one type currently loaded, and how many were evicted since the start
+        struct Residency {
+            uint32_t resident{};
+            uint32_t referenced{};
+            uint64_t cpuBytes{};
+            uint64_t gpuBytes{};
+            uint32_t evicted{};
+        };
+
     public:
         explicit ResourceManager(std::shared_ptr<engine::Device> device, vk::Queue graphicsQueue);
 
@@ -30,6 +73,10 @@ namespace engine {
 
         void createTexture(const std::string& uri, const std::string& name);
 
+        // Image embedded in a binary glTF, it has no file of its own to reload
+        void createTexture(const uint8_t* data, size_t length, const std::string& name);
+
+        // The default texture when the id is not resident
         engine::Texture& getTexture(uint64_t id);
 
         vk::DescriptorSetLayout& getTextureDescriptorSetLayout();
@@ -38,49 +85,209 @@ namespace engine {
 
         void cleanupResources();
 
-        void generateMipmaps(const engine::Texture& texture, vk::Format format, vk::Extent2D size, uint32_t mipLevels);
-
         uint64_t createModel(const std::string& uri, const std::string& name);
 
         std::shared_ptr<engine::Model> getModel(uint64_t id);
 
         engine::Mesh& getMesh(uint64_t id);
 
-        uint64_t loadMesh(const std::string& name, const tinygltf::Mesh& mesh, const tinygltf::Model& model, uint64_t texturesID);
+        uint64_t loadMesh(const std::string& name, const tinygltf::Mesh& mesh, const GltfFile& file, uint64_t texturesID);
 
-        std::shared_ptr<engine::Shader> createShader(const std::string &vert, const std::string &frag, const std::vector<vk::PushConstantRange>& pushConstants, bool vertexInfo = true);
+        uint64_t loadCookedMesh(const CookedModel& model, const CookedModel::MeshRecord& mesh);
 
-        std::shared_ptr<Animation> getAnimation(uint64_t name);
+        // Meshes are GPU only after their upload, physics and picking ask for the streams they need. The data is read
+        // again from the file of the model when the mesh keeps less than asked
+        std::shared_ptr<const MeshData> requestMeshData(uint64_t meshID, MeshResidency residency);
+
+        void releaseMeshData(uint64_t meshID);
+
+        std::shared_ptr<engine::Shader> createShader(const std::string &vert, const std::string &frag, const std::vector<vk::PushConstantRange>& pushConstants = {}, bool vertexInfo = true);
 
-        void createMeshDescriptorSets();
+        // nullptr while the clip is not resident. A registered clip that was never read or was evicted is then requested,
+        // it is read again on the thread pool. Safe to call from any thread
+        std::shared_ptr<Animation> getAnimation(uint64_t name);
 
-        void createMeshDescriptors(const std::vector<vk::DescriptorPoolSize>& sizes, uint32_t maxSize);
+        void createPaletteDescriptors();
 
         uint32_t getMeshesCount();
 
-        vk::DescriptorSetLayout getMeshDescriptorSetLayout();
+        vk::DescriptorSetLayout getPaletteDescriptorSetLayout();
+
+        vk::DescriptorSet& getPaletteDescriptorSet();
+
+        RingBuffer& getPaletteRing();
+
+        // Grows the segments of the palette ring so a frame can write size bytes. The frames in flight are waited on
+        // first, it is called between two frames before the palette set is bound
+        void reservePalettes(vk::DeviceSize size);
+
+        [[nodiscard]] const VertexMemory& getVertexMemory() const;
+
+        [[nodiscard]] const GeometryPool& getGeometry() const;
+
+        // Clips are read from their binary cache while it matches the glTF file, the cache is written otherwise
+        uint64_t loadAnimation(const std::string& uri, const std::string& name);
+
+        // Only remembers the file of the clip, it is read the first time it is requested
+        uint64_t registerAnimation(const std::string& uri, const std::string& name);
+
+        // Safe to call from any thread. The clip is read on the thread pool and added between two frames, getAnimation
+        // returns nullptr until then
+        void requestAnimation(uint64_t id);
+
+        void bakeAnimation(const std::string& name, const PoseCache::Settings& settings);
+
+        // Builds a clip from the first animation of a glTF file, safe to call from any thread
+        static std::shared_ptr<Animation> createAnimation(const GltfFile& inputFile);
+
+        [[nodiscard]] const AssetSource* findSource(const std::string& path) const;
+
+        [[nodiscard]] const std::unordered_map<std::string, AssetSource>& getSources() const;
+
+        // Hot reload, the device has to be idle. Assets are replaced in place, their ids, handles and descriptor sets
+        // stay valid for the scene
+        void reloadTexture(const std::string& name, const void* pixels, int width, int height, vk::DeviceSize size);
+
+        void reloadModel(const std::string& name, const GltfFile& inputFile);
+
+        void reloadModel(const std::string& name, const CookedModel& cooked);
+
+        void reloadAnimation(const std::string& name, const std::shared_ptr<Animation>& animation);
+
+        void reloadShader(const std::string& file, const std::vector<uint32_t>& code);
+
+        // Models hold their meshes and meshes their texture, the scene holds models and animations through ResourceHandle
+        void acquire(ResourceType type, uint64_t id);
+
+        void release(ResourceType type, uint64_t id);
+
+        // Once per frame: destroys the evicted GPU resources no frame in flight can use anymore, then evicts the least
+        // recently released resources without references while a budget is exceeded
+        void updateResidency();
 
-        uint32_t loadAnimation(const std::string& uri, const std::string& name);
+        void setMemoryBudget(const MemoryBudget& budget);
 
-        void initialPose();
+        [[nodiscard]] Residency getResidency(ResourceType type) const;
+
+        void logResidency() const;
+
+    private:
+        struct ResidencyEntry {
+            uint32_t references{};
+            uint64_t cpuBytes{};
+            uint64_t gpuBytes{};
+            // Frame of the last acquire or release, evictions start with the oldest
+            uint64_t lastUse{};
+        };
+
+        struct ReadFailure {
+            uint32_t attempts{};
+            // Requests are ignored until this frame
+            uint64_t retryFrame{};
+        };
 
     private:
+        void trackResidency(ResourceType type, uint64_t id, uint64_t cpuBytes, uint64_t gpuBytes);
+
+        void evict(ResourceType type, uint64_t id);
+
+        void destroyEvicted(bool all);
+
+        // Deferred destruction waits for the frames in flight, immediate destruction needs an idle device
+        void destroyMesh(uint64_t id, bool deferred);
+
+        void acquireMeshes(engine::Model& model);
+
+        static std::shared_ptr<Animation> readAnimation(const std::string& uri, const std::string& name);
+
+        static std::shared_ptr<Animation> parseAnimation(const GltfFile& inputFile);
+
+        static void finishAnimation(Animation& animation);
+
+        void addAnimation(uint64_t id, const std::shared_ptr<Animation>& animation);
+
+        // Starts reading the requested clips and adds the clips read since the last frame
+        void updateAnimations();
+
+        [[nodiscard]] const AssetSource* findModelSource(uint64_t modelID) const;
+
+        std::shared_ptr<const MeshData> readMeshData(const AssetSource& source, uint64_t meshID, MeshResidency residency) const;
+
+        bool loadCookedModel(const std::string& uri, const std::string& name);
+
+        std::shared_ptr<engine::Model> buildModel(const GltfFile& inputFile, const std::string& name);
+
+        std::shared_ptr<engine::Model> buildModel(const CookedModel& cooked, const std::string& name);
+
+        void releaseMeshes(engine::Model& model);
+
+        engine::Texture uploadTexture(const void* pixels, int width, int height, vk::DeviceSize size);
+
+        void addTexture(uint64_t textureID, stbi_uc* pixels, int width, int height, vk::DeviceSize size);
+
+        // Not tracked by the residency, it is never evicted
+        void createDefaultTexture();
+
+        // A glTF source also registers the buffer files it references, a buffer edited alone reloads its model or clip
+        void addSource(const std::string& path, AssetType type, const std::string& uri, const std::string& name);
+
+        void trackVertexMemory(const engine::Mesh& mesh, bool release = false);
+
+        void logVertexMemory(const std::string& name) const;
+
         void createDescriptorPool();
 
         void createDescriptorSetLayout();
 
+        // A descriptor set of its own, or an element of the bindless array
+        void createTextureDescriptor(engine::Texture& texture);
+
+        void writePaletteDescriptor();
+
     private:
         std::shared_ptr<engine::Device> m_device{};
         vk::Queue m_graphicsQueue{};
         std::unordered_map<uint64_t, engine::Texture> m_textures;
+        uint64_t m_defaultTexture{};
         std::unordered_map<uint64_t, std::shared_ptr<engine::Model>> m_models;
         std::unordered_map<uint64_t, engine::Mesh> m_meshes;
-        std::unordered_map<uint32_t, std::shared_ptr<Animation>> m_animations;
+        // Model each mesh was loaded with, its file is where the mesh data is read again from
+        std::unordered_map<uint64_t, uint64_t> m_meshModels;
+        std::unordered_map<uint64_t, std::shared_ptr<Animation>> m_animations;
+        // Files of the clips loaded lazily, by id
+        std::unordered_map<uint64_t, std::string> m_animationUris;
+        std::unordered_set<uint64_t> m_animationsReading;
+        // Guards the writes to m_animations, m_animationUris and m_animationsReading and every read made off the main thread
+        std::mutex m_animationsMutex;
+        std::unordered_set<uint64_t> m_animationRequests;
+        std::vector<std::pair<uint64_t, std::shared_ptr<Animation>>> m_animationsRead;
+        // Clips whose last reads failed, cleared by a successful read or a change of the clip file
+        std::unordered_map<uint64_t, ReadFailure> m_animationFailures;
         std::vector<std::shared_ptr<engine::Shader>> m_shaders;
         vk::DescriptorPool m_imagesDescriptorPool{};
         vk::DescriptorSetLayout m_imagesDescriptorSetLayout{};
-        vk::DescriptorPool m_meshSDescriptorPool{};
-        vk::DescriptorSetLayout m_meshDescriptorSetLayout{};
+        // Bindless only, the texture array and its elements released by destroyed textures
+        vk::DescriptorSet m_texturesDescriptorSet{};
+        std::vector<uint32_t> m_freeTextureIndices;
+        uint32_t m_textureCount{};
+        UploadBatch m_uploads;
+        GeometryPool m_geometry;
+        RingBuffer m_paletteRing;
+        vk::DescriptorPool m_paletteDescriptorPool{};
+        vk::DescriptorSetLayout m_paletteDescriptorSetLayout{};
+        vk::DescriptorSet m_paletteDescriptorSet{};
+        VertexMemory m_vertexMemory{};
+        std::unordered_map<std::string, AssetSource> m_sources;
+        // Settings of the baked clips, a reloaded clip is baked again with them
+        std::unordered_map<uint64_t, PoseCache::Settings> m_bakeSettings;
+        std::array<std::unordered_map<uint64_t, ResidencyEntry>, static_cast<size_t>(ResourceType::COUNT)> m_residency;
+        std::array<uint32_t, static_cast<size_t>(ResourceType::COUNT)> m_evictions{};
+        MemoryBudget m_budget{CPU_MEMORY_BUDGET, GPU_MEMORY_BUDGET};
+        uint64_t m_cpuBytes{};
+        uint64_t m_gpuBytes{};
+        uint64_t m_frame{};
+        std::vector<std::pair<uint64_t, engine::Mesh>> m_destroyedMeshes;
+        std::vector<std::pair<uint64_t, engine::Texture>> m_destroyedTextures;
     };
 
 } // namespace core
@@ -1,6 +1,9 @@
 #include "Shader.hpp"
 
 #include <utility>
+#include <algorithm>
+
+#include "spdlog/spdlog.h"
 
 #include "../Constants.hpp"
 #include "../Utilities.hpp"
@@ -9,7 +12,7 @@
 
 inline vk::ShaderModule loadShader(const std::vector<uint32_t> &code, vk::Device device) {
     return device.createShaderModule({
-        .codeSize = code.size(),
+        .codeSize = code.size() * sizeof(uint32_t),
         .pCode = code.data(),
     });
 }
@@ -17,13 +20,19 @@ inline vk::ShaderModule loadShader(const std::vector<uint32_t> &code, vk::Device
 namespace engine {
 
     Shader::Shader(const std::string &vert, const std::string &frag, vk::Device device, std::vector<vk::PushConstantRange> pushConstants, bool vertexInfo)
-            : m_pushConstants(std::move(pushConstants)) {
-        m_vertModule = loadShader(engine::tools::readFile(SHADERS_DIR + vert), device);
-        m_fragModule = loadShader(engine::tools::readFile(SHADERS_DIR + frag), device);
+            : m_vertFile(vert), m_fragFile(frag), m_pushConstants(std::move(pushConstants)) {
+        std::vector<uint32_t> vertCode = engine::tools::readFile(SHADERS_DIR + vert);
+        std::vector<uint32_t> fragCode = engine::tools::readFile(SHADERS_DIR + frag);
+
+        m_vertModule = loadShader(vertCode, device);
+        m_fragModule = loadShader(fragCode, device);
+        reflect(m_vertReflection, vert, vertCode);
+        reflect(m_fragReflection, frag, fragCode);
 
         if (vertexInfo) {
             m_binding = engine::Vertex::getBindingDescription();
             m_attributes = engine::Vertex::getAttributeDescriptions();
+            checkAttributes();
         }
     }
 
@@ -32,9 +41,28 @@ namespace engine {
         device.destroy(m_fragModule);
     }
 
+    bool Shader::reload(const vk::Device& device, const std::string& file, const std::vector<uint32_t>& code) {
+        if (file == m_vertFile) {
+            device.destroy(m_vertModule);
+            m_vertModule = loadShader(code, device);
+            reflect(m_vertReflection, file, code);
+            checkAttributes();
+        } else if (file == m_fragFile) {
+            device.destroy(m_fragModule);
+            m_fragModule = loadShader(code, device);
+            reflect(m_fragReflection, file, code);
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
     void Shader::setAtrributes(const vk::VertexInputBindingDescription &binding, const std::vector<vk::VertexInputAttributeDescription> &attributes) {
         m_binding = binding;
         m_attributes = attributes;
+
+        checkAttributes();
     }
 
     std::vector<vk::PipelineShaderStageCreateInfo> Shader::getShaderstages() {
@@ -61,7 +89,73 @@ namespace engine {
     }
 
     std::vector<vk::PushConstantRange> Shader::getPushConstants() {
-        return m_pushConstants;
+        if (!m_pushConstants.empty()) return m_pushConstants;
+
+        std::vector<vk::PushConstantRange> ranges;
+
+        for (const ShaderReflection* reflection : {&m_vertReflection, &m_fragReflection}) {
+            if (reflection->m_pushConstantSize == 0) continue;
+
+            ranges.push_back({
+                .stageFlags = reflection->m_stage,
+                .offset = reflection->m_pushConstantOffset,
+                .size = reflection->m_pushConstantSize
+            });
+        }
+
+        return ranges;
+    }
+
+    uint32_t Shader::getSetCount() const {
+        uint32_t count = 0;
+
+        for (const ShaderReflection* reflection : {&m_vertReflection, &m_fragReflection}) {
+            if (!reflection->m_bindings.empty()) count = std::max(count, reflection->m_bindings.back().set + 1);
+        }
+
+        return count;
+    }
+
+    std::vector<vk::DescriptorSetLayoutBinding> Shader::getSetBindings(uint32_t set) const {
+        std::vector<vk::DescriptorSetLayoutBinding> bindings;
+
+        for (const ShaderReflection* reflection : {&m_vertReflection, &m_fragReflection}) {
+            for (auto& binding : reflection->m_bindings) {
+                if (binding.set != set) continue;
+
+                auto it = std::find_if(bindings.begin(), bindings.end(), [&](const auto& b) { return b.binding == binding.binding; });
+
+                if (it != bindings.end()) {
+                    it->stageFlags |= reflection->m_stage;
+                    continue;
+                }
+
+                // A runtime array is sized by the descriptor set layout, one descriptor until a shader needs more
+                bindings.push_back({
+                    .binding = binding.binding,
+                    .descriptorType = binding.type,
+                    .descriptorCount = std::max(binding.count, 1u),
+                    .stageFlags = reflection->m_stage,
+                    .pImmutableSamplers = nullptr
+                });
+            }
+        }
+
+        return bindings;
+    }
+
+    void Shader::reflect(ShaderReflection& reflection, const std::string& file, const std::vector<uint32_t>& code) {
+        std::string error;
+
+        if (!reflection.reflect(code, &error)) spdlog::error("[Shader] Reflection of {} failed: {}", file, error);
+    }
+
+    void Shader::checkAttributes() const {
+        for (auto& input : m_vertReflection.m_inputs) {
+            auto it = std::find_if(m_attributes.begin(), m_attributes.end(), [&](const auto& a) { return a.location == input.location; });
+
+            if (it == m_attributes.end()) spdlog::error("[Shader] {} reads location {} which has no vertex attribute", m_vertFile, input.location);
+        }
     }
 
 } // namespace core
\ No newline at end of file
@@ -7,15 +7,22 @@
 #define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
 #include "vulkan/vulkan.hpp"
 
+#include "ShaderReflection.hpp"
+
 
 namespace engine {
 
+    // Vertex and fragment modules and their interface read from the SPIR-V. Push constant ranges given to the constructor
+    // replace the reflected ones
     class Shader {
     public:
-        explicit Shader(const std::string& vert, const std::string& frag, vk::Device device, std::vector<vk::PushConstantRange> pushConstants, bool vertexInfo = true);
+        explicit Shader(const std::string& vert, const std::string& frag, vk::Device device, std::vector<vk::PushConstantRange> pushConstants = {}, bool vertexInfo = true);
 
         void cleanup(const vk::Device& device);
 
+        // Replaces the module loaded from the file, returns false when the shader does not use it
+        bool reload(const vk::Device& device, const std::string& file, const std::vector<uint32_t>& code);
+
         void setAtrributes(const vk::VertexInputBindingDescription &binding, const std::vector<vk::VertexInputAttributeDescription> &attributes);
 
         std::vector<vk::PipelineShaderStageCreateInfo> getShaderstages();
@@ -26,12 +33,28 @@ namespace engine {
 
         std::vector<vk::PushConstantRange> getPushConstants();
 
+        // One more than the highest set index used by a stage, 0 without descriptors
+        [[nodiscard]] uint32_t getSetCount() const;
+
+        // Bindings of both stages in a set, a binding used by both has both stage flags
+        [[nodiscard]] std::vector<vk::DescriptorSetLayoutBinding> getSetBindings(uint32_t set) const;
+
+    private:
+        void reflect(ShaderReflection& reflection, const std::string& file, const std::vector<uint32_t>& code);
+
+        // Every vertex input of the module needs an attribute at its location
+        void checkAttributes() const;
+
     private:
+        std::string m_vertFile;
+        std::string m_fragFile;
         vk::ShaderModule m_vertModule;
         vk::ShaderModule m_fragModule;
         vk::VertexInputBindingDescription m_binding;
         std::vector<vk::VertexInputAttributeDescription> m_attributes;
         std::vector<vk::PushConstantRange> m_pushConstants;
+        ShaderReflection m_vertReflection;
+        ShaderReflection m_fragReflection;
     };
 
 } // namespace core
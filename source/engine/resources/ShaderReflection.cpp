@@ -0,0 +1,353 @@
+#include "ShaderReflection.hpp"
+
+#include <algorithm>
+#include <limits>
+
+
+// Values of the SPIR-V specification, only the instructions describing the interface of a module are read
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+constexpr uint32_t OP_ENTRY_POINT = 15;
+constexpr uint32_t OP_TYPE_INT = 21;
+constexpr uint32_t OP_TYPE_FLOAT = 22;
+constexpr uint32_t OP_TYPE_VECTOR = 23;
+constexpr uint32_t OP_TYPE_MATRIX = 24;
+constexpr uint32_t OP_TYPE_IMAGE = 25;
+constexpr uint32_t OP_TYPE_SAMPLER = 26;
+constexpr uint32_t OP_TYPE_SAMPLED_IMAGE = 27;
+constexpr uint32_t OP_TYPE_ARRAY = 28;
+constexpr uint32_t OP_TYPE_RUNTIME_ARRAY = 29;
+constexpr uint32_t OP_TYPE_STRUCT = 30;
+constexpr uint32_t OP_TYPE_POINTER = 32;
+constexpr uint32_t OP_CONSTANT = 43;
+constexpr uint32_t OP_SPEC_CONSTANT = 50;
+constexpr uint32_t OP_VARIABLE = 59;
+constexpr uint32_t OP_DECORATE = 71;
+constexpr uint32_t OP_MEMBER_DECORATE = 72;
+
+constexpr uint32_t DECORATION_BUFFER_BLOCK = 3;
+constexpr uint32_t DECORATION_ARRAY_STRIDE = 6;
+constexpr uint32_t DECORATION_MATRIX_STRIDE = 7;
+constexpr uint32_t DECORATION_BUILT_IN = 11;
+constexpr uint32_t DECORATION_LOCATION = 30;
+constexpr uint32_t DECORATION_BINDING = 33;
+constexpr uint32_t DECORATION_DESCRIPTOR_SET = 34;
+constexpr uint32_t DECORATION_OFFSET = 35;
+
+constexpr uint32_t STORAGE_UNIFORM_CONSTANT = 0;
+constexpr uint32_t STORAGE_INPUT = 1;
+constexpr uint32_t STORAGE_UNIFORM = 2;
+constexpr uint32_t STORAGE_PUSH_CONSTANT = 9;
+constexpr uint32_t STORAGE_STORAGE_BUFFER = 12;
+
+constexpr uint32_t DIM_BUFFER = 5;
+constexpr uint32_t DIM_SUBPASS_DATA = 6;
+
+constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+// Instruction defining an id, its opcode and the words after the result id
+struct SpirvType {
+    uint32_t op{};
+    std::vector<uint32_t> operands;
+};
+
+struct SpirvDecorations {
+    uint32_t set{NONE};
+    uint32_t binding{NONE};
+    uint32_t location{NONE};
+    uint32_t arrayStride{};
+    bool builtIn{};
+    bool bufferBlock{};
+};
+
+struct SpirvMemberDecorations {
+    uint32_t offset{};
+    uint32_t matrixStride{};
+};
+
+struct SpirvModule {
+    std::vector<SpirvType> types;
+    std::vector<SpirvDecorations> decorations;
+    std::vector<std::vector<SpirvMemberDecorations>> members;
+    std::vector<uint32_t> constants;
+};
+
+inline bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+
+    return false;
+}
+
+// Size of a type in a block, matrices and arrays use their stride when the module declares one
+inline uint32_t getSize(const SpirvModule& module, uint32_t id, uint32_t matrixStride = 0) {
+    const SpirvType& type = module.types[id];
+
+    switch (type.op) {
+        case OP_TYPE_INT:
+        case OP_TYPE_FLOAT:
+            return type.operands[0] / 8;
+        case OP_TYPE_VECTOR:
+            return type.operands[1] * getSize(module, type.operands[0]);
+        case OP_TYPE_MATRIX:
+            return type.operands[1] * (matrixStride ? matrixStride : getSize(module, type.operands[0]));
+        case OP_TYPE_ARRAY: {
+            uint32_t stride = module.decorations[id].arrayStride;
+
+            return module.constants[type.operands[1]] * (stride ? stride : getSize(module, type.operands[0]));
+        }
+        case OP_TYPE_STRUCT: {
+            uint32_t size = 0;
+
+            for (size_t i = 0; i < type.operands.size(); ++i) {
+                SpirvMemberDecorations member = i < module.members[id].size() ? module.members[id][i] : SpirvMemberDecorations{};
+                size = std::max(size, member.offset + getSize(module, type.operands[i], member.matrixStride));
+            }
+
+            return size;
+        }
+        default:
+            return 0;
+    }
+}
+
+inline vk::Format getFormat(const SpirvModule& module, uint32_t id) {
+    const SpirvType& type = module.types[id];
+    uint32_t components = 1;
+    uint32_t scalar = id;
+
+    if (type.op == OP_TYPE_VECTOR) {
+        components = type.operands[1];
+        scalar = type.operands[0];
+    }
+
+    const SpirvType& component = module.types[scalar];
+
+    if (components < 1 || components > 4 || component.operands.empty() || component.operands[0] != 32) return vk::Format::eUndefined;
+
+    static const vk::Format floats[] = {vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat};
+    static const vk::Format uints[] = {vk::Format::eR32Uint, vk::Format::eR32G32Uint, vk::Format::eR32G32B32Uint, vk::Format::eR32G32B32A32Uint};
+    static const vk::Format ints[] = {vk::Format::eR32Sint, vk::Format::eR32G32Sint, vk::Format::eR32G32B32Sint, vk::Format::eR32G32B32A32Sint};
+
+    if (component.op == OP_TYPE_FLOAT) return floats[components - 1];
+    if (component.op == OP_TYPE_INT) return component.operands[1] ? ints[components - 1] : uints[components - 1];
+
+    return vk::Format::eUndefined;
+}
+
+// Operand count and ids of the types read by the reflection
+inline bool isValid(const SpirvType& type, uint32_t bound) {
+    auto ids = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last && i < type.operands.size(); ++i) {
+            if (type.operands[i] >= bound) return false;
+        }
+
+        return true;
+    };
+
+    switch (type.op) {
+        case OP_TYPE_INT: return type.operands.size() >= 2;
+        case OP_TYPE_FLOAT: return !type.operands.empty();
+        case OP_TYPE_VECTOR:
+        case OP_TYPE_MATRIX: return type.operands.size() >= 2 && ids(0, 1);
+        case OP_TYPE_IMAGE: return type.operands.size() >= 7 && ids(0, 1);
+        case OP_TYPE_SAMPLED_IMAGE:
+        case OP_TYPE_RUNTIME_ARRAY: return !type.operands.empty() && ids(0, 1);
+        case OP_TYPE_ARRAY: return type.operands.size() >= 2 && ids(0, 2);
+        case OP_TYPE_STRUCT: return ids(0, type.operands.size());
+        case OP_TYPE_POINTER: return type.operands.size() >= 2 && ids(1, 2);
+        default: return true;
+    }
+}
+
+inline vk::ShaderStageFlagBits getStage(uint32_t executionModel) {
+    switch (executionModel) {
+        case 1: return vk::ShaderStageFlagBits::eTessellationControl;
+        case 2: return vk::ShaderStageFlagBits::eTessellationEvaluation;
+        case 3: return vk::ShaderStageFlagBits::eGeometry;
+        case 4: return vk::ShaderStageFlagBits::eFragment;
+        case 5: return vk::ShaderStageFlagBits::eCompute;
+        default: return vk::ShaderStageFlagBits::eVertex;
+    }
+}
+
+namespace engine {
+
+    ShaderReflection::ShaderReflection() = default;
+
+    bool ShaderReflection::reflect(const std::vector<uint32_t>& code, std::string* error) {
+        m_bindings.clear();
+        m_inputs.clear();
+        m_pushConstantOffset = 0;
+        m_pushConstantSize = 0;
+
+        if (code.size() < 5 || code[0] != SPIRV_MAGIC) return fail(error, "not a SPIR-V module");
+
+        uint32_t bound = code[3];
+
+        if (bound > code.size()) return fail(error, "invalid id bound");
+
+        SpirvModule module;
+        module.types.resize(bound);
+        module.decorations.resize(bound);
+        module.members.resize(bound);
+        module.constants.resize(bound);
+
+        struct Variable {
+            uint32_t id;
+            uint32_t pointer;
+            uint32_t storage;
+        };
+
+        std::vector<Variable> variables;
+
+        for (size_t offset = 5; offset < code.size();) {
+            uint32_t count = code[offset] >> 16;
+            uint32_t op = code[offset] & 0xFFFF;
+
+            if (count == 0 || offset + count > code.size()) return fail(error, "truncated instruction");
+
+            const uint32_t* words = code.data() + offset;
+            offset += count;
+
+            // Every instruction read below has an id as its first operand
+            if (count < 2 || (words[1] >= bound && op != OP_ENTRY_POINT)) continue;
+
+            switch (op) {
+                case OP_ENTRY_POINT:
+                    m_stage = getStage(words[1]);
+                    break;
+                case OP_TYPE_INT:
+                case OP_TYPE_FLOAT:
+                case OP_TYPE_VECTOR:
+                case OP_TYPE_MATRIX:
+                case OP_TYPE_IMAGE:
+                case OP_TYPE_SAMPLER:
+                case OP_TYPE_SAMPLED_IMAGE:
+                case OP_TYPE_ARRAY:
+                case OP_TYPE_RUNTIME_ARRAY:
+                case OP_TYPE_STRUCT:
+                case OP_TYPE_POINTER:
+                    module.types[words[1]] = {op, std::vector<uint32_t>(words + 2, words + count)};
+                    break;
+                case OP_CONSTANT:
+                case OP_SPEC_CONSTANT:
+                    if (count >= 4 && words[2] < bound) module.constants[words[2]] = words[3];
+                    break;
+                case OP_VARIABLE:
+                    if (count >= 4 && words[2] < bound) variables.push_back({words[2], words[1], words[3]});
+                    break;
+                case OP_DECORATE: {
+                    if (count < 3) break;
+
+                    SpirvDecorations& decorations = module.decorations[words[1]];
+                    uint32_t value = count >= 4 ? words[3] : 0;
+
+                    if (words[2] == DECORATION_DESCRIPTOR_SET) decorations.set = value;
+                    else if (words[2] == DECORATION_BINDING) decorations.binding = value;
+                    else if (words[2] == DECORATION_LOCATION) decorations.location = value;
+                    else if (words[2] == DECORATION_ARRAY_STRIDE) decorations.arrayStride = value;
+                    else if (words[2] == DECORATION_BUILT_IN) decorations.builtIn = true;
+                    else if (words[2] == DECORATION_BUFFER_BLOCK) decorations.bufferBlock = true;
+                    break;
+                }
+                case OP_MEMBER_DECORATE: {
+                    if (count < 5) break;
+
+                    auto& members = module.members[words[1]];
+                    if (members.size() <= words[2]) members.resize(words[2] + 1);
+
+                    if (words[3] == DECORATION_OFFSET) members[words[2]].offset = words[4];
+                    else if (words[3] == DECORATION_MATRIX_STRIDE) members[words[2]].matrixStride = words[4];
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        // Operands are ids of the same module, checked once before the types are walked
+        for (auto& type : module.types) {
+            if (!isValid(type, bound)) return fail(error, "invalid type");
+        }
+
+        uint32_t pushConstantEnd = 0;
+
+        for (auto& variable : variables) {
+            const SpirvType& pointer = module.types[variable.pointer];
+
+            if (pointer.op != OP_TYPE_POINTER) continue;
+
+            uint32_t typeID = pointer.operands[1];
+            const SpirvDecorations& decorations = module.decorations[variable.id];
+
+            if (variable.storage == STORAGE_PUSH_CONSTANT) {
+                const SpirvType& block = module.types[typeID];
+
+                if (block.op != OP_TYPE_STRUCT) continue;
+
+                m_pushConstantOffset = std::numeric_limits<uint32_t>::max();
+
+                for (size_t i = 0; i < block.operands.size(); ++i) {
+                    SpirvMemberDecorations member = i < module.members[typeID].size() ? module.members[typeID][i] : SpirvMemberDecorations{};
+                    m_pushConstantOffset = std::min(m_pushConstantOffset, member.offset);
+                }
+
+                if (block.operands.empty()) m_pushConstantOffset = 0;
+
+                pushConstantEnd = getSize(module, typeID);
+            } else if (variable.storage == STORAGE_INPUT) {
+                if (m_stage != vk::ShaderStageFlagBits::eVertex || decorations.builtIn || decorations.location == NONE) continue;
+
+                m_inputs.push_back({decorations.location, getFormat(module, typeID)});
+            } else if (variable.storage == STORAGE_UNIFORM_CONSTANT || variable.storage == STORAGE_UNIFORM
+                    || variable.storage == STORAGE_STORAGE_BUFFER) {
+                if (decorations.set == NONE || decorations.binding == NONE) continue;
+
+                Binding binding{.set = decorations.set, .binding = decorations.binding};
+
+                while (module.types[typeID].op == OP_TYPE_ARRAY || module.types[typeID].op == OP_TYPE_RUNTIME_ARRAY) {
+                    const SpirvType& array = module.types[typeID];
+
+                    binding.count = array.op == OP_TYPE_ARRAY ? binding.count * module.constants[array.operands[1]] : 0;
+                    typeID = array.operands[0];
+                }
+
+                const SpirvType& type = module.types[typeID];
+
+                if (type.op == OP_TYPE_SAMPLED_IMAGE) {
+                    binding.type = vk::DescriptorType::eCombinedImageSampler;
+                } else if (type.op == OP_TYPE_SAMPLER) {
+                    binding.type = vk::DescriptorType::eSampler;
+                } else if (type.op == OP_TYPE_IMAGE) {
+                    bool storage = type.operands[5] == 2;
+
+                    if (type.operands[1] == DIM_BUFFER) {
+                        binding.type = storage ? vk::DescriptorType::eStorageTexelBuffer : vk::DescriptorType::eUniformTexelBuffer;
+                    } else if (type.operands[1] == DIM_SUBPASS_DATA) {
+                        binding.type = vk::DescriptorType::eInputAttachment;
+                    } else {
+                        binding.type = storage ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eSampledImage;
+                    }
+                } else if (type.op == OP_TYPE_STRUCT) {
+                    bool storage = variable.storage == STORAGE_STORAGE_BUFFER || module.decorations[typeID].bufferBlock;
+                    binding.type = storage ? vk::DescriptorType::eStorageBuffer : vk::DescriptorType::eUniformBuffer;
+                } else {
+                    continue;
+                }
+
+                m_bindings.push_back(binding);
+            }
+        }
+
+        if (pushConstantEnd > m_pushConstantOffset) m_pushConstantSize = pushConstantEnd - m_pushConstantOffset;
+
+        std::sort(m_bindings.begin(), m_bindings.end(), [](const Binding& a, const Binding& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+
+        std::sort(m_inputs.begin(), m_inputs.end(), [](const Input& a, const Input& b) { return a.location < b.location; });
+
+        return true;
+    }
+
+} // namespace engine
@@ -0,0 +1,50 @@
+#ifndef PROTOTYPE_ACTION_RPG_SHADERREFLECTION_HPP
+#define PROTOTYPE_ACTION_RPG_SHADERREFLECTION_HPP
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include "vulkan/vulkan.hpp"
+
+
+namespace engine {
+
+    // Interface of a SPIR-V module read from its instructions: descriptor bindings, push constant block and vertex inputs.
+    // Only what the pipeline and descriptor set layouts need is kept, types are resolved for the variables declaring it
+    class ShaderReflection {
+    public:
+        struct Binding {
+            uint32_t set{};
+            uint32_t binding{};
+            vk::DescriptorType type{};
+            // Runtime arrays are reported with a count of 0
+            uint32_t count{1};
+        };
+
+        struct Input {
+            uint32_t location{};
+            vk::Format format{vk::Format::eUndefined};
+        };
+
+    public:
+        ShaderReflection();
+
+        bool reflect(const std::vector<uint32_t>& code, std::string* error = nullptr);
+
+    public:
+        vk::ShaderStageFlagBits m_stage{vk::ShaderStageFlagBits::eVertex};
+        std::vector<Binding> m_bindings;
+        // Only the inputs of a vertex shader, built-ins excluded
+        std::vector<Input> m_inputs;
+        // Bytes from the first to the end of the last member of the push constant block, 0 without one
+        uint32_t m_pushConstantOffset{};
+        uint32_t m_pushConstantSize{};
+    };
+
+} // namespace engine
+
+
+#endif //PROTOTYPE_ACTION_RPG_SHADERREFLECTION_HPP
@@ -30,18 +30,25 @@ namespace engine {
 
     Texture::~Texture() = default;
 
-    void Texture::bind(vk::Device logicalDevice, uint32_t memoryTypeIndex, vk::DeviceSize size) {
-        m_image.bind(logicalDevice, memoryTypeIndex, size, vk::ImageAspectFlagBits::eColor);
+    void Texture::bind(MemoryAllocator& allocator, vk::Device logicalDevice) {
+        m_image.bind(allocator, logicalDevice, vk::MemoryPropertyFlagBits::eDeviceLocal, vk::ImageAspectFlagBits::eColor);
     }
 
     // TODO: Check for move descriptor set in resize window
     void Texture::createDescriptor(vk::Device logicalDevice, vk::DescriptorPool descriptorPool, vk::DescriptorSetLayout descriptorSetLayout) {
-        m_descriptorSet = logicalDevice.allocateDescriptorSets({
+        vk::DescriptorSet descriptorSet = logicalDevice.allocateDescriptorSets({
             .descriptorPool = descriptorPool,
             .descriptorSetCount = 1,
             .pSetLayouts = &descriptorSetLayout
         }).front();
 
+        setDescriptorSet(logicalDevice, descriptorSet);
+    }
+
+    void Texture::setDescriptorSet(vk::Device logicalDevice, vk::DescriptorSet descriptorSet, uint32_t index) {
+        m_descriptorSet = descriptorSet;
+        m_index = index;
+
         vk::DescriptorImageInfo imageInfo{
             .sampler = m_sampler,
             .imageView = m_image.getView(),
@@ -51,7 +58,7 @@ namespace engine {
         vk::WriteDescriptorSet writeDescriptorSet{
             .dstSet = m_descriptorSet,
             .dstBinding = 0,
-            .dstArrayElement = 0,
+            .dstArrayElement = m_index,
             .descriptorCount = 1,
             .descriptorType = vk::DescriptorType::eCombinedImageSampler,
             .pImageInfo = &imageInfo
@@ -85,10 +92,18 @@ namespace engine {
         return m_image.getMipLevel();
     }
 
+    vk::DeviceSize Texture::getMemorySize() const {
+        return m_image.getMemorySize();
+    }
+
     vk::DescriptorSet Texture::getDescriptorSet() const {
         return m_descriptorSet;
     }
 
+    uint32_t Texture::getIndex() const {
+        return m_index;
+    }
+
     void Texture::createTextureSampler(vk::Device logicalDevice, uint32_t mipLevels) {
 
         m_sampler = logicalDevice.createSampler({
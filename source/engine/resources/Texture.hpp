@@ -21,10 +21,14 @@ namespace engine {
 
         ~Texture();
 
-        void bind(vk::Device logicalDevice, uint32_t memoryTypeIndex, vk::DeviceSize size);
+        void bind(MemoryAllocator& allocator, vk::Device logicalDevice);
 
         void createDescriptor(vk::Device logicalDevice, vk::DescriptorPool descriptorPool, vk::DescriptorSetLayout descriptorSetLayout);
 
+        // Points an existing descriptor set to this texture, used to replace a texture without touching its users. The index
+        // is the element of the bindless texture array
+        void setDescriptorSet(vk::Device logicalDevice, vk::DescriptorSet descriptorSet, uint32_t index = 0);
+
         void cleanup(vk::Device logicalDevice);
 
         [[nodiscard]] uint32_t getWidth() const;
@@ -37,14 +41,19 @@ namespace engine {
 
         [[nodiscard]] uint32_t getMipLevel() const;
 
+        [[nodiscard]] vk::DeviceSize getMemorySize() const;
+
         vk::DescriptorSet getDescriptorSet() const;
 
+        [[nodiscard]] uint32_t getIndex() const;
+
     private:
         void createTextureSampler(vk::Device logicalDevice, uint32_t mipLevels);
 
     private:
         engine::Image m_image;
         vk::DescriptorSet m_descriptorSet{};
+        uint32_t m_index{};
         vk::Sampler m_sampler{};
     };
 
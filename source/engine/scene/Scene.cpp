@@ -5,10 +5,12 @@
 
 #include "fmt/format.h"
 #include "imgui.h"
+#include "spdlog/spdlog.h"
 
 #include "../Application.hpp"
 #include "../physcis/PhysicsEngine.hpp"
 #include "../renderer/CommandList.hpp"
+#include "../renderer/SecondaryCommands.hpp"
 #include "../components/Movement.hpp"
 #include "../components/Status.hpp"
 
@@ -28,15 +30,19 @@ namespace engine {
     Scene::~Scene() = default;
 
     void Scene::update(float deltaTime) {
+        // The bounds below read the palettes of the previous update
+        wait();
+
         auto viewCamera = m_registry.view<Camera>();
         for (auto& entity : viewCamera) {
             if (m_registry.get<Status>(entity).getType() == Status::ACTIVE) {
-                Application::m_threadPool->submit([camera = &m_registry.get<Camera>(entity), transform = &m_registry.get<Transform>(entity)]{
+                m_updateTasks.push_back(Application::m_threadPool->async([camera = &m_registry.get<Camera>(entity),
+                                                                          transform = &m_registry.get<Transform>(entity)]{
                     glm::vec2 angles = camera->getEulerAngles();
                     camera->setDirection(angles.x, angles.y);
                     transform->getPosition() = camera->getCenter() + (camera->getDirection() * camera->getDistance());
                     camera->getEye() = transform->getPosition();
-                });
+                }));
             }
         }
 
@@ -44,54 +50,127 @@ namespace engine {
             const auto& viewMovement = m_registry.view<Movement, Transform, AnimationInterface>();
             for (auto& entity : viewMovement) {
                 if (m_registry.get<Status>(entity).getType() == Status::ACTIVE) {
-                    Application::m_threadPool->submit([deltaTime = deltaTime,
-                                                              movement = &viewMovement.get<Movement>(entity),
-                                                              transform = &viewMovement.get<Transform>(entity),
-                                                              animation = &viewMovement.get<AnimationInterface>(entity)]{
+                    m_updateTasks.push_back(Application::m_threadPool->async([deltaTime = deltaTime,
+                                                                              movement = &viewMovement.get<Movement>(entity),
+                                                                              transform = &viewMovement.get<Transform>(entity),
+                                                                              animation = &viewMovement.get<AnimationInterface>(entity)]{
                         movement->update(deltaTime, transform, animation);
-                    });
+                    }));
                 }
             }
 
-            for (auto& entity : m_registry.view<AnimationInterface>()) {
+            const auto& mvp = Application::m_renderer->m_mvp;
+            Frustum frustum(mvp.proj * mvp.view);
+            glm::vec3 eye = m_camera.getEye();
+            m_animationLodStats = {};
+
+            const auto& viewAnimation = m_registry.view<AnimationInterface, ModelInterface, Transform>();
+            for (auto& entity : viewAnimation) {
                 if (m_registry.get<Status>(entity).getType() == Status::ACTIVE) {
-                    Application::m_threadPool->submit([animation = &m_registry.get<AnimationInterface>(entity), deltaTime] {
+                    auto& animation = viewAnimation.get<AnimationInterface>(entity);
+                    const glm::vec3& position = viewAnimation.get<Transform>(entity).getPosition();
+                    // Sphere of the last pose, the pose of this frame is not built yet
+                    glm::vec4 bounds = viewAnimation.get<ModelInterface>(entity).getBoundingSphere(&animation.palette);
+
+                    if (!frustum.intersects(glm::vec3(bounds), bounds.w)) {
+                        animation.lodTier = AnimationInterface::LodTier::PAUSED;
+                        m_animationLodStats.paused++;
+                    } else if (glm::distance(eye, position) <= ANIMATION_LOD_FULL_DISTANCE) {
+                        animation.lodTier = AnimationInterface::LodTier::FULL;
+                        m_animationLodStats.full++;
+                    } else {
+                        animation.lodTier = AnimationInterface::LodTier::REDUCED;
+                        m_animationLodStats.reduced++;
+                    }
+
+                    m_updateTasks.push_back(Application::m_threadPool->async([animation = &animation, deltaTime] {
                         animation->update(deltaTime);
-                    });
+                    }));
                 }
             }
 
             const auto& viewCollision = m_registry.view<Collision>();
             for (auto& entity : viewCollision) {
                 if (m_registry.get<Status>(entity).getType() == Status::ACTIVE) {
-                    Application::m_threadPool->submit([collision = &viewCollision.get<Collision>(entity),
-                                                       transform = &m_registry.get<Transform>(entity)] {
+                    m_updateTasks.push_back(Application::m_threadPool->async([collision = &viewCollision.get<Collision>(entity),
+                                                                              transform = &m_registry.get<Transform>(entity)] {
                         collision->update(transform);
-                    });
+                    }));
                 }
             }
         }
 
         for (auto& entity : m_entities) {
             if (entity.type != EntityType::CAMERA) {
-                Application::m_threadPool->submit([transform = &m_registry.get<engine::Transform>(entity.enttID), deltaTime] {
+                m_updateTasks.push_back(Application::m_threadPool->async([transform = &m_registry.get<engine::Transform>(entity.enttID),
+                                                                          deltaTime] {
                     transform->update(deltaTime);
-                });
+                }));
             }
         }
     }
 
-    void Scene::render(vk::CommandBuffer& cmdBuffer, const std::shared_ptr<GraphicsPipeline>& pipeAnimation) {
+    void Scene::wait() {
+        // Every task is done before an exception is rethrown, get rethrows it on this thread
+        for (auto& task : m_updateTasks) task.wait();
+
+        std::vector<std::future<void>> tasks;
+        tasks.swap(m_updateTasks);
+
+        for (auto& task : tasks) task.get();
+    }
+
+    void Scene::collectDraws(const std::shared_ptr<GraphicsPipeline>& pipeStatic, const std::shared_ptr<GraphicsPipeline>& pipeAnimation) {
+        wait();
+
         auto view = m_registry.view<engine::ModelInterface>();
+        m_drawList.clear();
 
         for (auto& entity : view) {
             if (m_registry.get<Status>(entity).getType() == Status::ACTIVE) {
-                view.get<ModelInterface>(entity).render(cmdBuffer, pipeAnimation);
+                auto* animation = m_registry.try_get<AnimationInterface>(entity);
+                view.get<ModelInterface>(entity).render(m_drawList, pipeStatic, pipeAnimation, animation ? &animation->palette : nullptr);
             }
         }
+
+        const auto& mvp = Application::m_renderer->m_mvp;
+        m_drawList.cull(Frustum(mvp.proj * mvp.view), *Application::m_threadPool);
+    }
+
+    void Scene::render(SecondaryCommands& commands) {
+        m_drawList.record(commands, *Application::m_threadPool, Application::m_resourceManager->getPaletteRing(),
+                          Application::m_renderer->m_mvp);
+
+        logDrawStats();
+    }
+
+    void Scene::logDrawStats() {
+        const DrawList::Stats& stats = m_drawList.getStats();
+        m_cullTime += stats.cullTime;
+        m_recordTime += stats.recordTime;
+        m_droppedDraws += stats.dropped;
+
+        if (++m_drawStatsFrames < FRAME_STATS_INTERVAL) return;
+
+        // Instances are the draw calls there would be without instancing
+        spdlog::info("[Scene] {} instances in {} draws, {} culled: cull {:.2f} ms, record {:.2f} ms in {} batches, {} threads",
+                     stats.instances, stats.draws, stats.culled, m_cullTime / FRAME_STATS_INTERVAL, m_recordTime / FRAME_STATS_INTERVAL,
+                     stats.batches, Application::m_threadPool->getThreads().size() + 1);
+
+        if (m_droppedDraws > 0) {
+            spdlog::warn("[Scene] {} instances were not drawn in the last {} frames, the palette ring was full", m_droppedDraws,
+                         FRAME_STATS_INTERVAL);
+        }
+
+        m_drawStatsFrames = 0;
+        m_cullTime = 0.0f;
+        m_recordTime = 0.0f;
+        m_droppedDraws = 0;
     }
 
     void Scene::cleanup() {
+        wait();
+
         for (auto& entity : m_entities) {
             m_registry.destroy(entity.enttID);
         }
@@ -129,7 +208,7 @@ namespace engine {
     }
 
     void Scene::loadScene(const std::string &uri, bool editorBuild, std::vector<std::string>* modelNames,
-                          std::unordered_map<uint32_t, std::string>* animationsName) {
+                          std::unordered_map<uint64_t, std::string>* animationsName) {
         cleanup();
 
         json scene;
@@ -138,6 +217,7 @@ namespace engine {
         file.close();
 
         auto camera = scene["camera"];
+        m_bakeSettings = scene.value("bake", json::object());
         glm::vec3 target = {camera["target"]["x"].get<float>(), camera["target"]["y"].get<float>(), camera["target"]["z"].get<float>()};
 
         if (editorBuild) {
@@ -199,12 +279,13 @@ namespace engine {
                 auto attack = animations["attack"].get<std::string>();
                 auto death = animations["death"].get<std::string>();
                 auto walk = animations["walk"].get<std::string>();
-                uint32_t idleID = Application::m_resourceManager->loadAnimation(idle + ".gltf", idle);
-                uint32_t attackID = Application::m_resourceManager->loadAnimation(attack + ".gltf", attack);
-                uint32_t deathID = Application::m_resourceManager->loadAnimation(death + ".gltf", death);
-                uint32_t walkID = Application::m_resourceManager->loadAnimation(walk + ".gltf", walk);
+                // The first pose needs idle, the other clips are read when they are first played
+                uint64_t idleID = Application::m_resourceManager->loadAnimation(idle + ".gltf", idle);
+                uint64_t attackID = Application::m_resourceManager->registerAnimation(attack + ".gltf", attack);
+                uint64_t deathID = Application::m_resourceManager->registerAnimation(death + ".gltf", death);
+                uint64_t walkID = Application::m_resourceManager->registerAnimation(walk + ".gltf", walk);
 
-                std::vector<uint32_t> animationsList{
+                std::vector<uint64_t> animationsList{
                     idleID,
                     attackID,
                     deathID,
@@ -216,6 +297,18 @@ namespace engine {
 
                 entity.components |= ComponentFlags::ANIMATION;
 
+                for (auto& clip : {idle, attack, death, walk}) {
+                    if (m_bakeSettings.contains(clip)) {
+                        auto& bake = m_bakeSettings[clip];
+                        PoseCache::Settings settings{};
+                        settings.rate = bake.value("rate", settings.rate);
+                        settings.memoryBudget = bake.value("budget", settings.memoryBudget);
+                        settings.onDisk = bake.value("disk", settings.onDisk);
+
+                        Application::m_resourceManager->bakeAnimation(clip, settings);
+                    }
+                }
+
                 if (animationsName) {
                     animationsName->emplace(idleID, idle);
                     animationsName->emplace(attackID, attack);
@@ -236,7 +329,8 @@ namespace engine {
                         entity.enttID,
                         entity.id,
                         e["collision"]["mass"].get<float>(),
-                        glm::vec3(halfSize["x"].get<float>(), halfSize["y"].get<float>(), halfSize["z"].get<float>())
+                        glm::vec3(halfSize["x"].get<float>(), halfSize["y"].get<float>(), halfSize["z"].get<float>()),
+                        e["collision"].value("shape", "box") == "mesh" ? Collision::Shape::MESH : Collision::Shape::BOX
                 );
             }
 
@@ -246,7 +340,7 @@ namespace engine {
         }
     }
 
-    void Scene::saveScene(const std::string &uri, bool editorBuild, std::unordered_map<uint32_t, std::string>* animationsName) {
+    void Scene::saveScene(const std::string &uri, bool editorBuild, std::unordered_map<uint64_t, std::string>* animationsName) {
         json scene;
         engine::Camera* camera;
 
@@ -274,6 +368,8 @@ namespace engine {
                 { "distance", camera->getDistance() }
         };
 
+        if (!m_bakeSettings.empty()) scene["bake"] = m_bakeSettings;
+
         scene["entities"] = {};
 
         for (auto& entity : m_entities) {
@@ -346,6 +442,8 @@ namespace engine {
                                     {"z", collision.halfSize.z()}
                             }}
                     };
+
+                    if (collision.shape == Collision::Shape::MESH) scene["entities"][entitiesCount]["collision"]["shape"] = "mesh";
                 }
 
                 if (entity.components & engine::MOVEMENT) {
@@ -359,6 +457,34 @@ namespace engine {
         file.close();
     }
 
+    const Scene::AnimationLodStats& Scene::getAnimationLodStats() const {
+        return m_animationLodStats;
+    }
+
+    const DrawList::Stats& Scene::getDrawStats() const {
+        return m_drawList.getStats();
+    }
+
+    const DrawList& Scene::getDrawList() const {
+        return m_drawList;
+    }
+
+    void Scene::refreshModel(const std::shared_ptr<Model>& model) {
+        auto viewModel = m_registry.view<ModelInterface>();
+        for (auto& entity : viewModel) {
+            auto& modelInterface = viewModel.get<ModelInterface>(entity);
+
+            if (modelInterface.getHandle() == model) modelInterface.refresh();
+        }
+
+        auto viewAnimation = m_registry.view<AnimationInterface>();
+        for (auto& entity : viewAnimation) {
+            auto& animation = viewAnimation.get<AnimationInterface>(entity);
+
+            if (animation.model == model) animation.refresh();
+        }
+    }
+
     entt::registry &Scene::registry() {
         return m_registry;
     }
@@ -387,6 +513,24 @@ namespace engine {
 
         scene.set_function("getCamera", &Scene::getCamera, this);
         scene.set_function("getEntity", &Scene::getEntity, this);
+        scene.new_usertype<AnimationLodStats>("AnimationLodStats",
+                                              "full", &AnimationLodStats::full,
+                                              "reduced", &AnimationLodStats::reduced,
+                                              "paused", &AnimationLodStats::paused);
+        scene.set_function("getAnimationLodStats", &Scene::getAnimationLodStats, this);
+        scene.new_usertype<DrawList::Stats>("DrawStats",
+                                            "culled", &DrawList::Stats::culled,
+                                            "dropped", &DrawList::Stats::dropped,
+                                            "instances", &DrawList::Stats::instances,
+                                            "draws", &DrawList::Stats::draws,
+                                            "pipelineBinds", &DrawList::Stats::pipelineBinds,
+                                            "vertexBufferBinds", &DrawList::Stats::vertexBufferBinds,
+                                            "indexBufferBinds", &DrawList::Stats::indexBufferBinds,
+                                            "descriptorSetBinds", &DrawList::Stats::descriptorSetBinds,
+                                            "batches", &DrawList::Stats::batches,
+                                            "cullTime", &DrawList::Stats::cullTime,
+                                            "recordTime", &DrawList::Stats::recordTime);
+        scene.set_function("getDrawStats", &Scene::getDrawStats, this);
         scene["entities"] = std::ref(m_entities);
 
         sol::table entityComponents = scene["components"].get_or_create<sol::table>();
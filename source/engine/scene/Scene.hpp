@@ -5,11 +5,13 @@
 #include <string>
 #include <vector>
 #include <mutex>
+#include <future>
 
 #include "entt/entt.hpp"
 #include "nlohmann/json.hpp"
 
 #include "../camera/Camera.hpp"
+#include "../camera/Frustum.hpp"
 #include "../resources/ResourceManager.hpp"
 #include "../Constants.hpp"
 #include "../components/Transform.hpp"
@@ -26,6 +28,8 @@ using json = nlohmann::json;
 
 namespace engine {
 
+    class SecondaryCommands;
+
     enum EntityType {
         OBJECT = 0,
         PLAYER = 1,
@@ -53,6 +57,13 @@ namespace engine {
     };
 
     class Scene {
+    public:
+        struct AnimationLodStats {
+            uint32_t full{};
+            uint32_t reduced{};
+            uint32_t paused{};
+        };
+
     public:
         Scene();
 
@@ -60,7 +71,16 @@ namespace engine {
 
         void update(float deltaTime);
 
-        void render(vk::CommandBuffer& cmdBuffer, const std::shared_ptr<GraphicsPipeline>& pipeAnimation);
+        // Blocks until the tasks of the last update are done. Draws are collected and culled after it, they read the
+        // transforms and the palettes the tasks write
+        void wait();
+
+        // Draws are collected on the calling thread and culled against the camera frustum, before the commands of the
+        // frame begin so the palette ring can be sized for them
+        void collectDraws(const std::shared_ptr<GraphicsPipeline>& pipeStatic, const std::shared_ptr<GraphicsPipeline>& pipeAnimation);
+
+        // The collected draws are recorded on the workers into secondary buffers of the commands
+        void render(SecondaryCommands& commands);
 
         void cleanup();
 
@@ -75,9 +95,18 @@ namespace engine {
         engine::Camera& getCamera();
 
         void loadScene(const std::string& uri, bool editorBuild = false, std::vector<std::string>* modelNames = nullptr,
-                       std::unordered_map<uint32_t, std::string>* animationsName = nullptr);
+                       std::unordered_map<uint64_t, std::string>* animationsName = nullptr);
 
-        void saveScene(const std::string& uri, bool editorBuild = false, std::unordered_map<uint32_t, std::string>* animationsName = nullptr);
+        void saveScene(const std::string& uri, bool editorBuild = false, std::unordered_map<uint64_t, std::string>* animationsName = nullptr);
+
+        [[nodiscard]] const AnimationLodStats& getAnimationLodStats() const;
+
+        [[nodiscard]] const DrawList::Stats& getDrawStats() const;
+
+        [[nodiscard]] const DrawList& getDrawList() const;
+
+        // Components keep a copy of the model nodes, they are rebuilt after the model changed in place
+        void refreshModel(const std::shared_ptr<Model>& model);
 
         entt::registry& registry();
 
@@ -97,11 +126,24 @@ namespace engine {
 
         AnimationInterface& getAnimation(uint32_t id);
 
+        // Averages of the cull and record times, the draws of the last frame before and after instancing and the instances
+        // dropped, every FRAME_STATS_INTERVAL frames
+        void logDrawStats();
+
     private:
         std::vector<engine::Entity> m_entities;
         engine::Camera m_camera{};
         entt::entity m_currentEntity{};
         entt::registry m_registry;
+        AnimationLodStats m_animationLodStats{};
+        DrawList m_drawList;
+        std::vector<std::future<void>> m_updateTasks;
+        uint32_t m_drawStatsFrames{};
+        float m_cullTime{};
+        float m_recordTime{};
+        uint32_t m_droppedDraws{};
+        // Clips sampled ahead of time, keyed by animation name: rate in Hz, budget in bytes and disk
+        json m_bakeSettings;
     };
 
 }
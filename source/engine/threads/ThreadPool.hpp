@@ -6,7 +6,10 @@
 #include <atomic>
 #include <queue>
 #include <mutex>
+#include <future>
+#include <memory>
 #include <functional>
+#include <type_traits>
 #include <condition_variable>
 
 
@@ -24,6 +27,18 @@ namespace engine {
 
         void submit(Task f);
 
+        // The future holds the result of f or the exception it threw. Without workers f runs on the calling thread
+        template<typename F>
+        std::future<std::invoke_result_t<F>> async(F&& f) {
+            auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(f));
+            std::future<std::invoke_result_t<F>> future = task->get_future();
+
+            if (m_pool.empty()) (*task)();
+            else submit([task] { (*task)(); });
+
+            return future;
+        }
+
         bool empty();
 
         std::vector<std::thread>& getThreads();
@@ -0,0 +1,94 @@
+#include "Check.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "resources/Animation.hpp"
+#include "resources/AnimationSampler.hpp"
+
+
+bool near(const glm::vec4& a, const glm::vec4& b) {
+    return std::fabs(a.x - b.x) < 1e-5f && std::fabs(a.y - b.y) < 1e-5f && std::fabs(a.z - b.z) < 1e-5f && std::fabs(a.w - b.w) < 1e-5f;
+}
+
+void addChannel(engine::Animation& animation, engine::Animation::Sampler sampler, engine::Animation::Channel::PathType path) {
+    animation.m_channels.push_back({path, static_cast<int32_t>(animation.m_channels.size()), static_cast<uint32_t>(animation.m_samplers.size())});
+    animation.m_samplers.push_back(std::move(sampler));
+}
+
+// One channel of every interpolation and path, and enough cubic channels to fill the four wide batches with a tail
+engine::Animation makeClip() {
+    using Sampler = engine::Animation::Sampler;
+    using Path = engine::Animation::Channel::PathType;
+    engine::Animation animation;
+    float angle = std::sin(0.785398f);
+
+    addChannel(animation, {Sampler::LINEAR, {0.0f, 1.0f, 3.0f}, {glm::vec4(0.0f), glm::vec4(2.0f, 4.0f, 6.0f, 0.0f), glm::vec4(-1.0f)}},
+               Path::TRANSLATION);
+    addChannel(animation, {Sampler::STEP, {0.0f, 0.5f, 2.0f}, {glm::vec4(1.0f), glm::vec4(2.0f), glm::vec4(3.0f)}}, Path::SCALE);
+    addChannel(animation, {Sampler::LINEAR, {0.0f, 2.0f}, {glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, angle, 0.0f, angle)}},
+               Path::ROTATION);
+
+    for (int i = 0; i < 5; ++i) {
+        auto tangent = static_cast<float>(i);
+
+        addChannel(animation, {Sampler::CUBICSPLINE, {0.0f, 1.0f, 2.5f},
+                               {glm::vec4(0.0f), glm::vec4(0.0f), glm::vec4(tangent),
+                                glm::vec4(-tangent), glm::vec4(1.0f), glm::vec4(0.0f),
+                                glm::vec4(0.0f), glm::vec4(2.0f, 0.0f, 1.0f, 0.0f), glm::vec4(0.0f)}},
+                   Path::TRANSLATION);
+    }
+
+    addChannel(animation, {Sampler::CUBICSPLINE, {0.0f, 1.0f},
+                           {glm::vec4(0.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 1.0f, 0.0f, 0.0f),
+                            glm::vec4(0.0f), glm::vec4(angle, 0.0f, 0.0f, angle), glm::vec4(0.0f)}},
+               Path::ROTATION);
+
+    return animation;
+}
+
+void knownValues() {
+    engine::Animation animation = makeClip();
+
+    // Values worked out by hand, the reference of verify has to agree with them first
+    CHECK(near(engine::AnimationSampler::sampleChannel(animation, 0, 0.5f), glm::vec4(1.0f, 2.0f, 3.0f, 0.0f)));
+    CHECK(near(engine::AnimationSampler::sampleChannel(animation, 0, 5.0f), glm::vec4(-1.0f)));
+    CHECK(near(engine::AnimationSampler::sampleChannel(animation, 1, 1.9f), glm::vec4(2.0f)));
+    CHECK(near(engine::AnimationSampler::sampleChannel(animation, 2, 1.0f), glm::vec4(0.0f, std::sin(0.392699f), 0.0f, std::cos(0.392699f))));
+
+    // Halfway from 0 to 1 over one second, with an out tangent of 2 and an in tangent of -2: 0.5 + 0.125 * 2 + 0.125 * 2
+    CHECK(near(engine::AnimationSampler::sampleChannel(animation, 5, 0.5f), glm::vec4(1.0f)));
+    CHECK(near(engine::AnimationSampler::sampleChannel(animation, 1, 0.5f), glm::vec4(2.0f)));
+}
+
+void batchMatchesReference() {
+    engine::Animation animation = makeClip();
+
+    CHECK(engine::AnimationSampler::verify(animation) == 0);
+}
+
+void verifyFindsWrongKeys() {
+    engine::Animation animation = makeClip();
+    std::vector<uint32_t> channels{0};
+    std::vector<glm::vec4> values;
+    engine::AnimationSampler sampler;
+
+    // The batch path reads the keys it is given, nothing is cached between calls
+    animation.m_samplers[0].outputs[1] = glm::vec4(4.0f, 8.0f, 12.0f, 0.0f);
+    sampler.sample(animation, 0.5f, channels, values);
+    CHECK(near(values[0], glm::vec4(2.0f, 4.0f, 6.0f, 0.0f)));
+
+    // Keys out of order are located differently by the binary search of the sampler and the linear scan of the reference
+    animation.m_samplers[0].inputs = {0.0f, 2.0f, 1.0f};
+    CHECK(engine::AnimationSampler::verify(animation) > 0);
+}
+
+int main() {
+    knownValues();
+    batchMatchesReference();
+    verifyFindsWrongKeys();
+
+    if (checkFailures() == 0) std::printf("AnimationSamplerTests passed\n");
+
+    return checkFailures();
+}
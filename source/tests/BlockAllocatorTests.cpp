@@ -0,0 +1,128 @@
+#include "Check.hpp"
+
+#include "renderer/BlockAllocator.hpp"
+
+
+void buddySplitAndMerge() {
+    engine::BuddyAllocator allocator(1024, 64);
+    uint64_t a, b, c, d, e;
+
+    CHECK(allocator.getSize() == 1024);
+    CHECK(allocator.empty());
+
+    // Every allocation splits the first free block down to its own size
+    CHECK(allocator.allocate(64, 1, a) && a == 0);
+    CHECK(allocator.allocate(64, 1, b) && b == 64);
+    CHECK(allocator.allocate(128, 1, c) && c == 128);
+    CHECK(allocator.allocate(256, 1, d) && d == 256);
+    CHECK(allocator.allocate(512, 1, e) && e == 512);
+    CHECK(allocator.getUsed() == 1024);
+
+    allocator.free(b);
+    allocator.free(a);
+    CHECK(allocator.getUsed() == 896);
+
+    // Both buddies are free, they merged back into a 128 bytes block
+    uint64_t merged;
+    CHECK(allocator.allocate(128, 1, merged) && merged == 0);
+
+    allocator.free(merged);
+    allocator.free(c);
+    allocator.free(d);
+    allocator.free(e);
+    CHECK(allocator.empty());
+    CHECK(allocator.getUsed() == 0);
+
+    // The whole block is available again once everything merged
+    uint64_t whole;
+    CHECK(allocator.allocate(1024, 1, whole) && whole == 0);
+}
+
+void buddyRounding() {
+    // The size is rounded down to a power of two of the minimum block, requests up to a block size
+    engine::BuddyAllocator allocator(1000, 64);
+    uint64_t offset;
+
+    CHECK(allocator.getSize() == 512);
+    CHECK(allocator.allocate(1, 1, offset) && offset == 0);
+    CHECK(allocator.getUsed() == 64);
+    CHECK(allocator.allocate(65, 1, offset) && offset == 128);
+    CHECK(allocator.getUsed() == 192);
+}
+
+void buddyAlignment() {
+    engine::BuddyAllocator allocator(4096, 64);
+    uint64_t small, aligned;
+
+    CHECK(allocator.allocate(64, 1, small) && small == 0);
+    CHECK(allocator.allocate(64, 1024, aligned) && aligned % 1024 == 0 && aligned != small);
+
+    // An alignment larger than the whole block never fits
+    uint64_t offset = 12345;
+    CHECK(!allocator.allocate(64, 8192, offset));
+    CHECK(offset == 12345);
+}
+
+void buddyOutOfMemory() {
+    engine::BuddyAllocator allocator(256, 64);
+    uint64_t offset;
+
+    CHECK(!allocator.allocate(512, 1, offset));
+
+    for (int i = 0; i < 4; ++i) CHECK(allocator.allocate(64, 1, offset));
+
+    CHECK(!allocator.allocate(64, 1, offset));
+    CHECK(allocator.getUsed() == 256);
+
+    // Freeing an offset that was never returned changes nothing
+    allocator.free(32);
+    CHECK(allocator.getUsed() == 256);
+
+    allocator.free(64);
+    CHECK(allocator.allocate(64, 1, offset) && offset == 64);
+}
+
+void linearAlignmentAndRewind() {
+    engine::LinearAllocator allocator(256);
+    uint64_t a, b;
+
+    CHECK(allocator.allocate(10, 1, a) && a == 0);
+    CHECK(allocator.allocate(16, 64, b) && b == 64);
+    CHECK(allocator.getUsed() == 80);
+
+    allocator.free(a);
+    CHECK(!allocator.empty());
+    CHECK(allocator.getUsed() == 80);
+
+    // The head only goes back to the start once every allocation is freed
+    allocator.free(b);
+    CHECK(allocator.empty());
+    CHECK(allocator.getUsed() == 0);
+    CHECK(allocator.allocate(16, 1, a) && a == 0);
+}
+
+void linearOutOfMemory() {
+    engine::LinearAllocator allocator(128);
+    uint64_t offset;
+
+    CHECK(allocator.allocate(100, 1, offset) && offset == 0);
+    // Fits in size but not once aligned
+    CHECK(!allocator.allocate(20, 64, offset));
+    CHECK(!allocator.allocate(29, 1, offset));
+    CHECK(allocator.getUsed() == 100);
+    CHECK(allocator.allocate(28, 1, offset) && offset == 100);
+    CHECK(!allocator.allocate(1, 1, offset));
+}
+
+int main() {
+    buddySplitAndMerge();
+    buddyRounding();
+    buddyAlignment();
+    buddyOutOfMemory();
+    linearAlignmentAndRewind();
+    linearOutOfMemory();
+
+    if (checkFailures() == 0) std::printf("BlockAllocatorTests passed\n");
+
+    return checkFailures();
+}
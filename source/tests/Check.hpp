@@ -0,0 +1,23 @@
+#ifndef PROTOTYPE_ACTION_RPG_CHECK_HPP
+#define PROTOTYPE_ACTION_RPG_CHECK_HPP
+
+
+#include <cstdio>
+
+
+// Failed checks are printed and counted, a test executable returns the count so CTest reports it as failed
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            checkFailures()++; \
+        } \
+    } while (false)
+
+
+#endif //PROTOTYPE_ACTION_RPG_CHECK_HPP
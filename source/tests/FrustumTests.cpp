@@ -0,0 +1,81 @@
+#include "Check.hpp"
+
+#include <random>
+#include <vector>
+
+#include "camera/Frustum.hpp"
+
+
+void knownSpheres() {
+    // The identity keeps the clip space box as frustum, every plane is one unit from the origin
+    engine::Frustum frustum(glm::mat4(1.0f));
+
+    CHECK(frustum.intersects(glm::vec3(0.0f), 0.1f));
+    CHECK(frustum.intersects(glm::vec3(1.5f, 0.0f, 0.0f), 1.0f));
+    CHECK(!frustum.intersects(glm::vec3(3.0f, 0.0f, 0.0f), 1.0f));
+    CHECK(!frustum.intersects(glm::vec3(0.0f, 0.0f, -2.5f), 1.0f));
+
+    float x[] = {0.0f, 1.5f, 3.0f, 0.0f, 0.0f};
+    float y[] = {0.0f, 0.0f, 0.0f, 0.0f, -5.0f};
+    float z[] = {0.0f, 0.0f, 0.0f, -2.5f, 0.0f};
+    float radius[] = {0.1f, 1.0f, 1.0f, 1.0f, 4.5f};
+    uint8_t visible[5];
+
+    frustum.intersects(x, y, z, radius, 5, visible);
+
+    CHECK(visible[0] == 1);
+    CHECK(visible[1] == 1);
+    CHECK(visible[2] == 0);
+    CHECK(visible[3] == 0);
+    CHECK(visible[4] == 1);
+}
+
+void batchMatchesScalar() {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> element(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> position(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> size(0.0f, 0.5f);
+
+    for (int test = 0; test < 16; ++test) {
+        // Skewed projections, the planes are not aligned with the axes
+        glm::mat4 viewProj(1.0f);
+
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) viewProj[i][j] += 0.5f * element(random);
+        }
+
+        engine::Frustum frustum(viewProj);
+
+        // Not a multiple of four, the last spheres go through the scalar path
+        size_t count = 1003;
+        std::vector<float> x(count), y(count), z(count), radius(count);
+        std::vector<uint8_t> visible(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            x[i] = position(random);
+            y[i] = position(random);
+            z[i] = position(random);
+            radius[i] = size(random);
+        }
+
+        frustum.intersects(x.data(), y.data(), z.data(), radius.data(), count, visible.data());
+
+        int mismatches = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            bool expected = frustum.intersects(glm::vec3(x[i], y[i], z[i]), radius[i]);
+            mismatches += expected != (visible[i] == 1);
+        }
+
+        CHECK(mismatches == 0);
+    }
+}
+
+int main() {
+    knownSpheres();
+    batchMatchesScalar();
+
+    if (checkFailures() == 0) std::printf("FrustumTests passed\n");
+
+    return checkFailures();
+}
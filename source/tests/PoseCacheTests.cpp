@@ -0,0 +1,96 @@
+#include "Check.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+#include "resources/Animation.hpp"
+#include "resources/PoseCache.hpp"
+
+
+engine::Animation makeClip() {
+    engine::Animation animation;
+    animation.m_name = "test";
+    animation.m_start = 0.0f;
+    animation.m_end = 2.0f;
+    animation.m_samplers.push_back({engine::Animation::Sampler::LINEAR, {0.0f, 2.0f}, {glm::vec4(0.0f), glm::vec4(2.0f)}});
+    animation.m_channels.push_back({engine::Animation::Channel::PathType::TRANSLATION, 0, 0});
+    animation.m_keysHash = animation.hashKeys();
+
+    return animation;
+}
+
+void reusedForSameKeys() {
+    std::string path = (std::filesystem::temp_directory_path() / "PoseCacheTests.pose").string();
+    engine::Animation animation = makeClip();
+    engine::PoseCache::Settings settings{};
+
+    CHECK(animation.m_poseCache.bake(animation, settings));
+    CHECK(animation.m_poseCache.save(path));
+
+    engine::PoseCache cache;
+    CHECK(cache.load(path, animation, settings));
+    CHECK(cache.isBaked());
+
+    // Same start, end and channel count, only a key moved: the frames on disk are stale
+    engine::Animation edited = makeClip();
+    edited.m_samplers[0].outputs[1] = glm::vec4(3.0f);
+    edited.m_keysHash = edited.hashKeys();
+
+    engine::PoseCache staleKeys;
+    CHECK(edited.m_keysHash != animation.m_keysHash);
+    CHECK(!staleKeys.load(path, edited, settings));
+    CHECK(!staleKeys.isBaked());
+
+    engine::PoseCache otherRate;
+    settings.rate = 60.0f;
+    CHECK(!otherRate.load(path, animation, settings));
+
+    std::filesystem::remove(path);
+}
+
+void hashFollowsKeys() {
+    engine::Animation a = makeClip();
+    engine::Animation b = makeClip();
+
+    CHECK(a.hashKeys() == b.hashKeys());
+
+    b.m_samplers[0].interpolation = engine::Animation::Sampler::STEP;
+    CHECK(a.hashKeys() != b.hashKeys());
+
+    b = makeClip();
+    b.m_channels[0].path = engine::Animation::Channel::PathType::SCALE;
+    CHECK(a.hashKeys() != b.hashKeys());
+}
+
+void shortLastInterval() {
+    // 1.05 s at 10 Hz: the last frame is baked 0.05 s after the one before it
+    engine::Animation animation;
+    animation.m_name = "short";
+    animation.m_start = 0.0f;
+    animation.m_end = 1.05f;
+    animation.m_samplers.push_back({engine::Animation::Sampler::LINEAR, {0.0f, 1.05f}, {glm::vec4(0.0f), glm::vec4(1.05f)}});
+    animation.m_channels.push_back({engine::Animation::Channel::PathType::TRANSLATION, 0, 0});
+    animation.m_keysHash = animation.hashKeys();
+
+    engine::PoseCache::Settings settings{};
+    settings.rate = 10.0f;
+    CHECK(animation.m_poseCache.bake(animation, settings));
+
+    std::vector<glm::vec4> values;
+    for (float time : {0.35f, 1.0f, 1.025f, 1.05f, 2.0f}) {
+        animation.m_poseCache.sample(animation, time, {0}, values);
+        CHECK(std::abs(values[0].x - std::min(time, 1.05f)) < 1e-4f);
+    }
+}
+
+int main() {
+    reusedForSameKeys();
+    hashFollowsKeys();
+    shortLastInterval();
+
+    if (checkFailures() == 0) std::printf("PoseCacheTests passed\n");
+
+    return checkFailures();
+}